@@ -0,0 +1,409 @@
+
+#include "AirportSets.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <set>
+
+using namespace std;
+
+/**
+ * @brief Indexes the airports and flights of a graph.
+ *
+ * @param graph The flights graph.
+ * @param airports The airports, by code.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of vertices and E the number of edges.
+ */
+void AirportSets::build(const Graph &graph, const unordered_map<string, Airport> &airports) {
+    airportCodes.clear();
+    airportCountries.clear();
+    firstFlight.clear();
+    targets.clear();
+    vector<string> airportCities, airlineCodes;
+    vector<int> flightAirlines;
+    for (auto vertex : graph.getVertexSet()) {
+        const Airport &airport = airports.find(vertex->getInfo())->second;
+        airportCodes.push_back(airport.getCode());
+        airportCities.push_back(airport.getCity() + ", " + airport.getCountry());
+        airportCountries.push_back(airport.getCountry());
+        firstFlight.push_back((int) targets.size());
+        for (const auto &edge : vertex->getAdj()) {
+            targets.push_back(edge.getDest()->getId());
+            flightAirlines.push_back(edge.getAirlineId());
+        }
+    }
+    firstFlight.push_back((int) targets.size());
+    for (int id = 0; id < graph.getNumAirlines(); id++)
+        airlineCodes.push_back(graph.getAirlineCode(id));
+    index(airportCities, flightAirlines, airlineCodes);
+}
+
+/**
+ * @brief Indexes the airports and flights of a snapshot.
+ *
+ * @param snapshot The snapshot.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of airports and E the number of flights.
+ */
+void AirportSets::build(const GraphSnapshot &snapshot) {
+    airportCodes.clear();
+    airportCountries.clear();
+    firstFlight.clear();
+    targets.clear();
+    vector<string> airportCities, airlineCodes;
+    vector<int> flightAirlines;
+    for (int id = 0; id < snapshot.getNumAirports(); id++) {
+        Airport airport = snapshot.getAirport(id);
+        airportCodes.push_back(airport.getCode());
+        airportCities.push_back(airport.getCity() + ", " + airport.getCountry());
+        airportCountries.push_back(airport.getCountry());
+        firstFlight.push_back((int) targets.size());
+        for (int flight = snapshot.getFirstFlight(id); flight < snapshot.getLastFlight(id); flight++) {
+            targets.push_back(snapshot.getFlightTarget(flight));
+            flightAirlines.push_back(snapshot.getFlightAirline(flight));
+        }
+    }
+    firstFlight.push_back((int) targets.size());
+    for (int id = 0; id < snapshot.getNumFlightAirlines(); id++)
+        airlineCodes.push_back(snapshot.getAirlineCode(id));
+    index(airportCities, flightAirlines, airlineCodes);
+}
+
+/**
+ * @brief Builds the sets of airports of every country, city and airline.
+ *
+ * @param airportCities The "city, country" of each airport id.
+ * @param flightAirlines The airline id of each flight.
+ * @param airlineCodes The code of each airline id.
+ *
+ * @info An airline serves the airports its flights leave from or arrive at.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of airports and E the number of flights.
+ */
+void AirportSets::index(const vector<string> &airportCities, const vector<int> &flightAirlines,
+                        const vector<string> &airlineCodes) {
+    int numAirports = (int) airportCodes.size();
+    airportIds.clear();
+    unordered_map<string, vector<uint32_t>> countries, cities;
+    vector<vector<uint32_t>> served(airlineCodes.size());
+    vector<uint32_t> ids;
+    for (int id = 0; id < numAirports; id++) {
+        airportIds[airportCodes[id]] = id;
+        countries[airportCountries[id]].push_back(id);
+        cities[airportCities[id]].push_back(id);
+        ids.push_back(id);
+        for (int flight = firstFlight[id]; flight < firstFlight[id + 1]; flight++) {
+            served[flightAirlines[flight]].push_back(id);
+            served[flightAirlines[flight]].push_back(targets[flight]);
+        }
+    }
+
+    all = RoaringBitmap(ids);
+    countrySets.clear();
+    citySets.clear();
+    airlineSets.clear();
+    for (const auto &country : countries)
+        countrySets[country.first] = RoaringBitmap(country.second);
+    for (const auto &city : cities)
+        citySets[city.first] = RoaringBitmap(city.second);
+    for (int airline = 0; airline < (int) served.size(); airline++) {
+        vector<uint32_t> &airports = served[airline];
+        if (airports.empty())
+            continue;
+        sort(airports.begin(), airports.end());
+        airports.erase(unique(airports.begin(), airports.end()), airports.end());
+        airlineSets[airlineCodes[airline]] = RoaringBitmap(airports);
+    }
+}
+
+/**
+ * @brief Finds the airports reachable from an airport with at most a number of stops.
+ *
+ * @param source The id of the airport.
+ * @param maxStops The maximum number of stops. 0 gives the nonstop destinations.
+ *
+ * @return The reached airports, without the source itself.
+ *
+ * @complexity Time Complexity: O(V + E), where V is the number of airports and E the number of flights.
+ */
+RoaringBitmap AirportSets::reachable(int source, int maxStops) const {
+    vector<int> distance(airportCodes.size(), -1);
+    vector<int> queue = {source};
+    distance[source] = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+        int airport = queue[head];
+        if (distance[airport] > maxStops)
+            break;
+        for (int flight = firstFlight[airport]; flight < firstFlight[airport + 1]; flight++) {
+            int target = targets[flight];
+            if (distance[target] < 0) {
+                distance[target] = distance[airport] + 1;
+                queue.push_back(target);
+            }
+        }
+    }
+    vector<uint32_t> reached;
+    for (int airport : queue) {
+        if (distance[airport] > 0 && distance[airport] <= maxStops + 1)
+            reached.push_back(airport);
+    }
+    sort(reached.begin(), reached.end());
+    return RoaringBitmap(reached);
+}
+
+/**
+ * @brief Evaluates a set expression.
+ *
+ * @param expression The expression. Sets are combined with | (union), - (difference) and & (intersection, which binds
+ * tighter), left to right, with parentheses for grouping. See showHelp for the sets.
+ * @param result Set to the airports of the expression.
+ * @param error Set to the reason the expression is invalid.
+ *
+ * @return True if the expression is valid.
+ *
+ * @complexity Time Complexity: O(S * (V + E) + W), where S is the number of reach sets, V the number of airports, E
+ * the number of flights and W the work of the set operations.
+ */
+bool AirportSets::evaluate(const string &expression, RoaringBitmap &result, string &error) const {
+    size_t position = 0;
+    if (!parseUnion(expression, position, result, error))
+        return false;
+    while (position < expression.size() && isspace((unsigned char) expression[position]))
+        position++;
+    if (position < expression.size()) {
+        error = "Unexpected " + expression.substr(position);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Parses a chain of sets joined by union and difference.
+ *
+ * @param text The expression.
+ * @param position The position to parse from. Set to the end of the chain.
+ * @param result Set to the airports of the chain.
+ * @param error Set to the reason the chain is invalid.
+ *
+ * @return True if the chain is valid.
+ *
+ * @complexity Time Complexity: see evaluate.
+ */
+bool AirportSets::parseUnion(const string &text, size_t &position, RoaringBitmap &result, string &error) const {
+    if (!parseIntersection(text, position, result, error))
+        return false;
+    while (true) {
+        while (position < text.size() && isspace((unsigned char) text[position]))
+            position++;
+        if (position == text.size() || (text[position] != '|' && text[position] != '-'))
+            return true;
+        char op = text[position++];
+        RoaringBitmap other;
+        if (!parseIntersection(text, position, other, error))
+            return false;
+        result = op == '|' ? result | other : result - other;
+    }
+}
+
+/**
+ * @brief Parses a chain of sets joined by intersection.
+ *
+ * @param text The expression.
+ * @param position The position to parse from. Set to the end of the chain.
+ * @param result Set to the airports of the chain.
+ * @param error Set to the reason the chain is invalid.
+ *
+ * @return True if the chain is valid.
+ *
+ * @complexity Time Complexity: see evaluate.
+ */
+bool AirportSets::parseIntersection(const string &text, size_t &position, RoaringBitmap &result, string &error) const {
+    if (!parseSet(text, position, result, error))
+        return false;
+    while (true) {
+        while (position < text.size() && isspace((unsigned char) text[position]))
+            position++;
+        if (position == text.size() || text[position] != '&')
+            return true;
+        position++;
+        RoaringBitmap other;
+        if (!parseSet(text, position, other, error))
+            return false;
+        result = result & other;
+    }
+}
+
+/**
+ * @brief Parses a single set, or a parenthesized expression.
+ *
+ * @param text The expression.
+ * @param position The position to parse from. Set to the end of the set.
+ * @param result Set to the airports of the set.
+ * @param error Set to the reason the set is invalid.
+ *
+ * @return True if the set is valid.
+ *
+ * @info The argument list ends at the parenthesis that matches its opening one, so names such as
+ * "Congo (Kinshasa)" may be written as they are. Arguments are split on the commas outside nested parentheses; an
+ * argument may also be written between double quotes, inside which commas and parentheses are plain text.
+ *
+ * @complexity Time Complexity: O(V + E) for a reach set, O(1) average for the others.
+ */
+bool AirportSets::parseSet(const string &text, size_t &position, RoaringBitmap &result, string &error) const {
+    while (position < text.size() && isspace((unsigned char) text[position]))
+        position++;
+    if (position < text.size() && text[position] == '(') {
+        position++;
+        if (!parseUnion(text, position, result, error))
+            return false;
+        while (position < text.size() && isspace((unsigned char) text[position]))
+            position++;
+        if (position == text.size() || text[position] != ')') {
+            error = "Missing )";
+            return false;
+        }
+        position++;
+        return true;
+    }
+
+    size_t start = position;
+    while (position < text.size() && isalpha((unsigned char) text[position]))
+        position++;
+    string name = text.substr(start, position - start);
+    if (name.empty()) {
+        error = position < text.size() ? "Unexpected " + text.substr(position) : "Missing set";
+        return false;
+    }
+    if (name == "all") {
+        result = all;
+        return true;
+    }
+
+    vector<string> arguments;
+    while (position < text.size() && isspace((unsigned char) text[position]))
+        position++;
+    if (position < text.size() && text[position] == '(') {
+        string argument;
+        int depth = 0;
+        bool quoted = false;
+        for (position++;; position++) {
+            if (position == text.size()) {
+                error = quoted ? "Missing \"" : "Missing )";
+                return false;
+            }
+            char c = text[position];
+            if (c == '"') {
+                quoted = !quoted;
+                continue;
+            }
+            if (!quoted && ((c == ')' && depth == 0) || (c == ',' && depth == 0))) {
+                argument.erase(0, argument.find_first_not_of(" \t"));
+                argument.erase(argument.find_last_not_of(" \t") + 1);
+                arguments.push_back(argument);
+                argument.clear();
+                if (c == ')')
+                    break;
+                continue;
+            }
+            if (!quoted)
+                depth += c == '(' ? 1 : c == ')' ? -1 : 0;
+            argument += c;
+        }
+        position++;
+    }
+
+    if ((name == "reach" && arguments.size() == 2) || (name == "dest" && arguments.size() == 1)) {
+        auto airport = airportIds.find(arguments[0]);
+        if (airport == airportIds.end()) {
+            error = "Airport " + arguments[0] + " doesn't exist";
+            return false;
+        }
+        result = reachable(airport->second, name == "dest" ? 0 : max(atoi(arguments[1].c_str()), 0));
+    } else if (name == "country" && arguments.size() == 1) {
+        auto country = countrySets.find(arguments[0]);
+        if (country == countrySets.end()) {
+            error = "Country " + arguments[0] + " doesn't exist";
+            return false;
+        }
+        result = country->second;
+    } else if (name == "city" && arguments.size() == 2) {
+        auto city = citySets.find(arguments[0] + ", " + arguments[1]);
+        if (city == citySets.end()) {
+            error = "City " + arguments[0] + ", " + arguments[1] + " doesn't exist";
+            return false;
+        }
+        result = city->second;
+    } else if (name == "airline" && arguments.size() == 1) {
+        auto airline = airlineSets.find(arguments[0]);
+        if (airline == airlineSets.end()) {
+            error = "Airline " + arguments[0] + " doesn't exist";
+            return false;
+        }
+        result = airline->second;
+    } else {
+        error = "Unknown set " + name + " with " + to_string(arguments.size()) + " arguments";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Evaluates a set expression and prints its airports, or their countries.
+ *
+ * @param text The expression, optionally preceded by "countries" to list the countries of the airports instead.
+ * @param out The stream the answer is written to.
+ *
+ * @complexity Time Complexity: O(T + n log n), where T is the cost of evaluate and n the size of the result.
+ */
+void AirportSets::query(const string &text, ostream &out) const {
+    string expression = text;
+    size_t first = expression.find_first_not_of(" \t");
+    bool listCountries = first != string::npos && expression.compare(first, 10, "countries ") == 0;
+    if (listCountries)
+        expression = expression.substr(first + 10);
+
+    auto start = chrono::steady_clock::now();
+    RoaringBitmap result;
+    string error;
+    if (!evaluate(expression, result, error)) {
+        out << error << endl;
+        return;
+    }
+    auto end = chrono::steady_clock::now();
+
+    vector<uint32_t> ids = result.toVector();
+    set<string> countries;
+    vector<string> codes;
+    for (uint32_t id : ids) {
+        countries.insert(airportCountries[id]);
+        codes.push_back(airportCodes[id]);
+    }
+    if (listCountries) {
+        for (const auto &country : countries)
+            out << country << endl;
+    } else {
+        sort(codes.begin(), codes.end());
+        for (size_t i = 0; i < codes.size(); i++)
+            out << codes[i] << (i % 16 == 15 || i + 1 == codes.size() ? "\n" : " ");
+    }
+    out << result.cardinality() << " airports in " << countries.size() << " countries, in "
+        << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us" << endl;
+}
+
+/**
+ * @brief Prints the syntax of the set expressions.
+ *
+ * @param out The stream the help is written to.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void AirportSets::showHelp(ostream &out) {
+    out << "Sets: reach(CODE, STOPS), dest(CODE), country(NAME), city(NAME, COUNTRY), airline(CODE), all" << endl;
+    out << "Operators: A | B (union), A & B (intersection), A - B (difference), parentheses" << endl;
+    out << "Arguments may contain balanced parentheses, or be quoted: country(Congo (Kinshasa)), "
+        << "city(\"A, B\", C)" << endl;
+    out << "Prefix with \"countries\" to list the countries instead of the airports" << endl;
+    out << "Example: reach(OPO, 2) - reach(LIS, 2)" << endl;
+}
@@ -0,0 +1,45 @@
+
+#ifndef PROJETO2_AIRPORTSETS_H
+#define PROJETO2_AIRPORTSETS_H
+
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Airport.h"
+#include "Graph.h"
+#include "GraphSnapshot.h"
+#include "RoaringBitmap.h"
+
+class AirportSets {
+public:
+    void build(const Graph &graph, const std::unordered_map<std::string, Airport> &airports);
+    void build(const GraphSnapshot &snapshot);
+
+    bool evaluate(const std::string &expression, RoaringBitmap &result, std::string &error) const;
+    void query(const std::string &text, std::ostream &out) const;
+
+    static void showHelp(std::ostream &out);
+
+private:
+    std::vector<int> firstFlight;                                   ///< first flight of each airport, then the end
+    std::vector<int> targets;                                       ///< target airport of each flight
+    std::vector<std::string> airportCodes;                          ///< code of each airport id
+    std::vector<std::string> airportCountries;                      ///< country of each airport id
+    std::unordered_map<std::string, int> airportIds;                ///< id of each airport code
+    std::unordered_map<std::string, RoaringBitmap> countrySets;     ///< airports of each country
+    std::unordered_map<std::string, RoaringBitmap> citySets;        ///< airports of each "city, country"
+    std::unordered_map<std::string, RoaringBitmap> airlineSets;     ///< airports served by each airline code
+    RoaringBitmap all;                                              ///< every airport
+
+    void index(const std::vector<std::string> &airportCities, const std::vector<int> &flightAirlines,
+               const std::vector<std::string> &airlineCodes);
+    RoaringBitmap reachable(int source, int maxStops) const;
+    bool parseUnion(const std::string &text, size_t &position, RoaringBitmap &result, std::string &error) const;
+    bool parseIntersection(const std::string &text, size_t &position, RoaringBitmap &result, std::string &error) const;
+    bool parseSet(const std::string &text, size_t &position, RoaringBitmap &result, std::string &error) const;
+};
+
+
+#endif //PROJETO2_AIRPORTSETS_H
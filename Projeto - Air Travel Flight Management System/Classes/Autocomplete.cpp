@@ -0,0 +1,347 @@
+
+#include "Autocomplete.h"
+#include "DurableFile.h"
+#include "TrigramIndex.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const int Autocomplete::maxCompletions;
+
+/**
+ * @brief Constructor for the Autocomplete class. The trie starts empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Autocomplete::Autocomplete() {}
+
+/**
+ * @brief Move constructor. The image (owned or mapped) is handed over to the new object.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Autocomplete::Autocomplete(Autocomplete &&other) noexcept {
+    *this = move(other);
+}
+
+/**
+ * @brief Move assignment. Releases the current image and takes over the image of another trie.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Autocomplete &Autocomplete::operator=(Autocomplete &&other) noexcept {
+    if (this == &other)
+        return *this;
+    release();
+    owned = move(other.owned);
+    mapping = other.mapping;
+    mappingSize = other.mappingSize;
+    header = other.header;
+    nodes = other.nodes;
+    children = other.children;
+    top = other.top;
+    entries = other.entries;
+    labels = other.labels;
+    strings = other.strings;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+    other.header = nullptr;
+    return *this;
+}
+
+/**
+ * @brief Destructor. Unmaps the snapshot file, if it was mapped.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Autocomplete::~Autocomplete() {
+    release();
+}
+
+/**
+ * @brief Drops the current image.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void Autocomplete::release() {
+#ifndef _WIN32
+    if (mapping != nullptr)
+        munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    owned.clear();
+    header = nullptr;
+}
+
+/**
+ * @brief Points the arrays of the trie into an image, after checking that it is complete.
+ *
+ * @param image The image, in the snapshot file format.
+ * @param size The size of the image, in bytes.
+ *
+ * @return True if the image is valid.
+ *
+ * @info The image only holds indexes and offsets, never pointers, so it works at any address: in memory right after
+ * being built or mapped straight from the snapshot file.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool Autocomplete::attach(const char *image, size_t size) {
+    if (size < sizeof(Header))
+        return false;
+    const Header *h = reinterpret_cast<const Header *>(image);
+    if (memcmp(h->magic, "FMSACT2", 8) != 0)
+        return false;
+    size_t labelBytes = (h->numEdges + 7) / 8 * 8;
+    size_t expected = sizeof(Header) + 4 * (4 * (size_t) h->numNodes + h->numEdges + h->numTop + 4 * (size_t) h->numEntries)
+                      + labelBytes + h->stringBytes;
+    if (size != expected || h->numNodes == 0)
+        return false;
+
+    header = h;
+    const uint32_t *words = reinterpret_cast<const uint32_t *>(image + sizeof(Header));
+    nodes = words;
+    children = nodes + 4 * (size_t) h->numNodes;
+    top = children + h->numEdges;
+    entries = top + h->numTop;
+    labels = reinterpret_cast<const unsigned char *>(entries + 4 * (size_t) h->numEntries);
+    strings = reinterpret_cast<const char *>(labels + labelBytes);
+    return true;
+}
+
+/**
+ * @brief Builds the trie in memory.
+ *
+ * @param entries The texts to complete. Texts are matched case- and accent-insensitively.
+ * @param fingerprint Identifies the dataset, so a saved snapshot can be checked against it later.
+ * @param sequence The number of schedule changes applied to the dataset, also checked, as they change the traffic.
+ *
+ * @info Keys are inserted in sorted order and the nodes are then laid out in flat arrays: the edges of a node are
+ * contiguous and sorted by label, so a keystroke is a binary search. Every node keeps the best maxCompletions entries
+ * below it (most traffic first, one per airport), merged bottom-up from its children, so a query never walks a subtree.
+ *
+ * @complexity Time Complexity: O(L log L + N * K), where L is the total length of the texts, N the number of nodes and
+ * K the number of completions kept per node.
+ */
+void Autocomplete::build(const vector<CompletionEntry> &list, uint64_t fingerprint, uint64_t sequence) {
+    vector<pair<string, int>> keys;
+    for (int i = 0; i < (int) list.size(); i++) {
+        string key = TrigramIndex::normalize(list[i].text);
+        if (!key.empty())
+            keys.push_back({key, i});
+    }
+    sort(keys.begin(), keys.end());
+
+    vector<map<unsigned char, int>> trie(1);
+    vector<vector<int>> ending(1);
+    for (const auto &key : keys) {
+        int node = 0;
+        for (unsigned char c : key.first) {
+            auto it = trie[node].find(c);
+            if (it == trie[node].end()) {
+                trie[node][c] = (int) trie.size();
+                node = (int) trie.size();
+                trie.emplace_back();
+                ending.emplace_back();
+            } else {
+                node = it->second;
+            }
+        }
+        ending[node].push_back(key.second);
+    }
+
+    auto better = [&list](int a, int b) {
+        if (list[a].traffic != list[b].traffic)
+            return list[a].traffic > list[b].traffic;
+        if (list[a].code != list[b].code)
+            return list[a].code < list[b].code;
+        return (int) list[a].kind < (int) list[b].kind;
+    };
+    vector<vector<int>> best(trie.size());
+    for (int node = (int) trie.size() - 1; node >= 0; node--) {
+        // children always have larger numbers than their parent, so they are done already
+        vector<int> candidates = ending[node];
+        for (const auto &edge : trie[node])
+            candidates.insert(candidates.end(), best[edge.second].begin(), best[edge.second].end());
+        sort(candidates.begin(), candidates.end(), better);
+        vector<string> codes;
+        for (int entry : candidates) {
+            if (best[node].size() == maxCompletions)
+                break;
+            if (find(codes.begin(), codes.end(), list[entry].code) != codes.end())
+                continue;
+            codes.push_back(list[entry].code);
+            best[node].push_back(entry);
+        }
+    }
+
+    string pool;
+    vector<uint32_t> entryWords;
+    for (const auto &entry : list) {
+        entryWords.push_back((uint32_t) pool.size());
+        pool += entry.text + '\0';
+        entryWords.push_back((uint32_t) pool.size());
+        pool += entry.code + '\0';
+        entryWords.push_back((uint32_t) entry.traffic);
+        entryWords.push_back((uint32_t) entry.kind);
+    }
+    vector<uint32_t> nodeWords, childWords, topWords;
+    vector<unsigned char> labelBytes;
+    for (int node = 0; node < (int) trie.size(); node++) {
+        nodeWords.push_back((uint32_t) childWords.size());
+        nodeWords.push_back((uint32_t) trie[node].size());
+        nodeWords.push_back((uint32_t) topWords.size());
+        nodeWords.push_back((uint32_t) best[node].size());
+        for (const auto &edge : trie[node]) {
+            labelBytes.push_back(edge.first);
+            childWords.push_back((uint32_t) edge.second);
+        }
+        topWords.insert(topWords.end(), best[node].begin(), best[node].end());
+    }
+    labelBytes.resize((labelBytes.size() + 7) / 8 * 8, 0);
+
+    Header h = {};
+    memcpy(h.magic, "FMSACT2", 8);
+    h.fingerprint = fingerprint;
+    h.sequence = sequence;
+    h.numNodes = (uint32_t) trie.size();
+    h.numEdges = (uint32_t) childWords.size();
+    h.numTop = (uint32_t) topWords.size();
+    h.numEntries = (uint32_t) list.size();
+    h.stringBytes = (uint32_t) pool.size();
+
+    release();
+    auto append = [this](const void *data, size_t bytes) {
+        owned.insert(owned.end(), (const char *) data, (const char *) data + bytes);
+    };
+    append(&h, sizeof(h));
+    append(nodeWords.data(), 4 * nodeWords.size());
+    append(childWords.data(), 4 * childWords.size());
+    append(topWords.data(), 4 * topWords.size());
+    append(entryWords.data(), 4 * entryWords.size());
+    append(labelBytes.data(), labelBytes.size());
+    append(pool.data(), pool.size());
+    attach(owned.data(), owned.size());
+}
+
+/**
+ * @brief Writes the trie to a snapshot file.
+ *
+ * @param filename The path of the file.
+ *
+ * @return True if the file was written.
+ *
+ * @info The file is replaced with a new inode (see replaceFile) instead of being rewritten in place, so processes that
+ * still have the old version mapped keep reading it unchanged.
+ *
+ * @complexity Time Complexity: O(S), where S is the size of the image.
+ */
+bool Autocomplete::save(const string &filename) const {
+    if (header == nullptr)
+        return false;
+    size_t size = mapping != nullptr ? mappingSize : owned.size();
+    return replaceFile(filename, reinterpret_cast<const char *>(header), size);
+}
+
+/**
+ * @brief Memory-maps the trie from a snapshot file.
+ *
+ * @param filename The path of the file.
+ * @param fingerprint The fingerprint of the current dataset.
+ * @param sequence The number of schedule changes applied to the current dataset.
+ *
+ * @return True if the file exists, is valid and was built from the same dataset with the same schedule changes.
+ * Otherwise the trie is left empty.
+ *
+ * @info Nothing is parsed or copied: the arrays point straight into the read-only mapping, so loading takes constant
+ * time and pages are only read from disk when a query touches them. Systems without mmap read the file instead.
+ *
+ * @complexity Time Complexity: O(1) with mmap, O(S) otherwise, where S is the size of the file.
+ */
+bool Autocomplete::load(const string &filename, uint64_t fingerprint, uint64_t sequence) {
+    release();
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void *address = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+        return false;
+    mapping = address;
+    mappingSize = (size_t) info.st_size;
+    bool valid = attach((const char *) mapping, mappingSize);
+#else
+    ifstream in(filename, ios::binary);
+    if (!in)
+        return false;
+    owned.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    bool valid = attach(owned.data(), owned.size());
+#endif
+    if (!valid || header->fingerprint != fingerprint || header->sequence != sequence) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if the trie is served from a memory-mapped snapshot file.
+ *
+ * @return True if the trie is mapped, false if it lives in memory (or is empty).
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool Autocomplete::isMapped() const {
+    return mapping != nullptr;
+}
+
+/**
+ * @brief Gets the best completions of a prefix.
+ *
+ * @param prefix What the user typed so far. Case, accents and punctuation are ignored.
+ * @param k The maximum number of completions (at most maxCompletions).
+ *
+ * @return The completions, busiest airport first, with at most one completion per airport.
+ *
+ * @complexity Time Complexity: O(P log σ + k), where P is the length of the prefix and σ the size of the alphabet.
+ */
+vector<CompletionEntry> Autocomplete::complete(const string &prefix, int k) const {
+    vector<CompletionEntry> res;
+    if (header == nullptr)
+        return res;
+
+    uint32_t node = 0;
+    for (unsigned char c : TrigramIndex::normalize(prefix)) {
+        const unsigned char *first = labels + nodes[4 * node];
+        const unsigned char *last = first + nodes[4 * node + 1];
+        const unsigned char *it = lower_bound(first, last, c);
+        if (it == last || *it != c)
+            return res;
+        node = children[it - labels];
+    }
+
+    uint32_t count = min<uint32_t>(nodes[4 * node + 3], (uint32_t) max(k, 0));
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t *entry = entries + 4 * (size_t) top[nodes[4 * node + 2] + i];
+        res.push_back({strings + entry[0], strings + entry[1], (int) entry[2], (CompletionKind) entry[3]});
+    }
+    return res;
+}
@@ -0,0 +1,71 @@
+
+#ifndef PROJETO2_AUTOCOMPLETE_H
+#define PROJETO2_AUTOCOMPLETE_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class CompletionKind {
+    Code,       ///< the IATA code of the airport
+    Name,       ///< the name of the airport
+    City        ///< the city of the airport
+};
+
+struct CompletionEntry {
+    std::string text;       ///< the text completed, as shown to the user
+    std::string code;       ///< code of the airport
+    int traffic;            ///< number of flights in and out of the airport
+    CompletionKind kind;    ///< what the text is
+};
+
+class Autocomplete {
+public:
+    Autocomplete();
+    Autocomplete(Autocomplete &&other) noexcept;
+    Autocomplete &operator=(Autocomplete &&other) noexcept;
+    Autocomplete(const Autocomplete &) = delete;
+    Autocomplete &operator=(const Autocomplete &) = delete;
+    ~Autocomplete();
+
+    void build(const std::vector<CompletionEntry> &entries, std::uint64_t fingerprint, std::uint64_t sequence = 0);
+    bool save(const std::string &filename) const;
+    bool load(const std::string &filename, std::uint64_t fingerprint, std::uint64_t sequence = 0);
+    bool isMapped() const;
+    std::vector<CompletionEntry> complete(const std::string &prefix, int k) const;
+
+    static const int maxCompletions = 10;   ///< number of completions kept for every prefix
+
+private:
+    struct Header {
+        char magic[8];                  ///< "FMSACT2" and a zero byte
+        std::uint64_t fingerprint;      ///< identifies the dataset the trie was built from
+        std::uint64_t sequence;         ///< number of schedule changes applied to the dataset, which move the traffic
+        std::uint32_t numNodes;         ///< number of trie nodes (the root is node 0)
+        std::uint32_t numEdges;         ///< number of labelled edges
+        std::uint32_t numTop;           ///< total length of the completion lists
+        std::uint32_t numEntries;       ///< number of completion entries
+        std::uint32_t stringBytes;      ///< size of the string pool
+        std::uint32_t reserved;         ///< keeps the arrays 8-byte aligned
+    };
+
+    std::vector<char> owned;            ///< the image, when built in memory or read without mmap
+    void *mapping = nullptr;            ///< the image, when memory-mapped
+    std::size_t mappingSize = 0;        ///< size of the mapping
+
+    const Header *header = nullptr;             ///< header of the image
+    const std::uint32_t *nodes = nullptr;       ///< per node: first edge, number of edges, first completion, count
+    const std::uint32_t *children = nullptr;    ///< target node of each edge
+    const std::uint32_t *top = nullptr;         ///< completion lists, as entry indexes
+    const std::uint32_t *entries = nullptr;     ///< per entry: text offset, code offset, traffic, kind
+    const unsigned char *labels = nullptr;      ///< label of each edge (edges of a node are sorted by label)
+    const char *strings = nullptr;              ///< the string pool, zero-terminated strings
+
+    bool attach(const char *image, std::size_t size);
+    void release();
+};
+
+
+#endif //PROJETO2_AUTOCOMPLETE_H
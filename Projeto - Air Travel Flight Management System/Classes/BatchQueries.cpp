@@ -0,0 +1,321 @@
+
+#include "BatchQueries.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the BatchQueries class.
+ *
+ * @param snapshot The snapshot the queries are answered from. It must outlive the object.
+ *
+ * @info The graph and the airport and airline catalogs are read from the snapshot, which may be shared with other
+ * processes. The indexes of the query, set and common commands (the columnar flight table, the airport sets and the
+ * destination lists) and the fuzzy airport indexes are not part of the image: each worker builds its own private copy
+ * the first time a command needs it, about 5.5 MB for the three query indexes on the full dataset, against the 1 MB
+ * shared snapshot. A worker that only asks for stats, airports, destinations and reachability never pays for them.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+BatchQueries::BatchQueries(const GraphSnapshot &snapshot) : snapshot(snapshot) {}
+
+/**
+ * @brief Gets the columnar flight table, building it from the snapshot on first use.
+ *
+ * @return The table.
+ *
+ * @complexity Time Complexity: O(V log V + E) the first time, O(1) after, where V is the number of airports and E the
+ * number of flights.
+ */
+const FlightTable &BatchQueries::getTable() {
+    if (!tableBuilt) {
+        table.build(snapshot);
+        tableBuilt = true;
+    }
+    return table;
+}
+
+/**
+ * @brief Gets the airport sets, building them from the snapshot on first use.
+ *
+ * @return The airport sets.
+ *
+ * @complexity Time Complexity: O(V + E log E) the first time, O(1) after, where V is the number of airports and E the
+ * number of flights.
+ */
+const AirportSets &BatchQueries::getSets() {
+    if (!setsBuilt) {
+        sets.build(snapshot);
+        setsBuilt = true;
+    }
+    return sets;
+}
+
+/**
+ * @brief Gets the destination lists, building them from the snapshot on first use.
+ *
+ * @return The destination lists.
+ *
+ * @complexity Time Complexity: O(V + E log E) the first time, O(1) after, where V is the number of airports and E the
+ * number of flights.
+ */
+const DestinationLists &BatchQueries::getLists() {
+    if (!listsBuilt) {
+        lists.build(snapshot);
+        listsBuilt = true;
+    }
+    return lists;
+}
+
+/**
+ * @brief Answers every query read from a stream, one per line, until the end of the stream or "quit".
+ *
+ * @param in The stream the queries are read from.
+ * @param out The stream the answers are written to. It is flushed after every answer.
+ *
+ * @complexity Time Complexity: O(Q * T), where Q is the number of queries and T the cost of the slowest one.
+ */
+void BatchQueries::run(istream &in, ostream &out) {
+    string line;
+    while (getline(in, line)) {
+        if (!execute(line, out))
+            break;
+        out << flush;
+    }
+}
+
+/**
+ * @brief Answers a single query.
+ *
+ * @param line The query, as a command followed by its arguments separated by spaces.
+ * @param out The stream the answer is written to.
+ *
+ * @return False if the query was "quit", true otherwise.
+ *
+ * @complexity Time Complexity: depends on the command; see the show methods.
+ */
+bool BatchQueries::execute(const string &line, ostream &out) {
+    istringstream words(line);
+    string command, code;
+    words >> command;
+    if (command.empty() || command[0] == '#')
+        return true;
+
+    if (command == "quit") {
+        return false;
+    } else if (command == "help") {
+        showHelp(out);
+    } else if (command == "stats") {
+        showStats(out);
+    } else if (command == "airport" && words >> code) {
+        showAirport(code, out);
+    } else if (command == "destinations" && words >> code) {
+        showDestinations(code, out);
+    } else if (command == "reachable" && words >> code) {
+        int maxStops = 0;
+        words >> maxStops;
+        showReachable(code, max(maxStops, 0), out);
+    } else if (command == "query") {
+        string query;
+        getline(words, query);
+        getTable().query(query, out);
+    } else if (command == "set") {
+        string expression;
+        getline(words, expression);
+        getSets().query(expression, out);
+    } else if (command == "common") {
+        vector<string> codes;
+        while (words >> code) {
+            if (findAirport(code, out) < 0)
+                return true;
+            codes.push_back(code);
+        }
+        getLists().query(codes, out);
+    } else {
+        out << "Unknown query: " << line << endl;
+    }
+    return true;
+}
+
+/**
+ * @brief Finds an airport, reporting it and the most similar airports if it does not exist.
+ *
+ * @param code The code of the airport.
+ * @param out The stream the error is written to.
+ *
+ * @return The id of the airport, or -1 if it does not exist.
+ *
+ * @complexity Time Complexity: O(log V), where V is the number of airports, if the airport exists; as in
+ * suggestAirports otherwise.
+ */
+int BatchQueries::findAirport(const string &code, ostream &out) {
+    int airport = snapshot.findAirport(code);
+    if (airport < 0) {
+        out << "Airport " << code << " doesn't exist" << endl;
+        suggestAirports(code, out);
+    }
+    return airport;
+}
+
+/**
+ * @brief Prints the airports whose code or name is most similar to a code that was not found.
+ *
+ * @param code The code that was not found.
+ * @param out The stream the suggestions are written to.
+ *
+ * @info The trigram indexes of the codes and names are built from the snapshot the first time an airport is not
+ * found. Up to 5 airports are printed, most similar first.
+ *
+ * @complexity Time Complexity: O(V * L) the first time, where V is the number of airports and L the length of a name;
+ * O(P + C log C) after, where P is the number of indexed texts that share a trigram with the code, counted once per
+ * shared trigram, and C the number of those texts.
+ */
+void BatchQueries::suggestAirports(const string &code, ostream &out) {
+    if (!indexesBuilt) {
+        for (int airport = 0; airport < snapshot.getNumAirports(); airport++) {
+            codeIndex.add(snapshot.getAirportCode(airport));
+            int name = nameIndex.add(snapshot.getAirport(airport).getName());
+            if (name == (int) nameAirports.size())
+                nameAirports.emplace_back();
+            nameAirports[name].push_back(airport);
+        }
+        indexesBuilt = true;
+    }
+
+    vector<pair<double, int>> found = codeIndex.search(code, 5);
+    for (const auto &name : nameIndex.search(code, 5))
+        for (int airport : nameAirports[name.second])
+            found.push_back({name.first, airport});
+    stable_sort(found.begin(), found.end(), [](const pair<double, int> &a, const pair<double, int> &b) {
+        return a.first > b.first;
+    });
+
+    vector<int> shown;
+    for (const auto &match : found) {
+        if (shown.size() == 5)
+            break;
+        if (find(shown.begin(), shown.end(), match.second) != shown.end())
+            continue;
+        if (shown.empty())
+            out << "Did you mean:" << endl;
+        shown.push_back(match.second);
+        Airport info = snapshot.getAirport(match.second);
+        out << '\t' << info.getCode() << " -- " << info.getName() << " (" << info.getCity() << ", "
+            << info.getCountry() << ")" << endl;
+    }
+}
+
+/**
+ * @brief Prints the size of the dataset and how it is held in memory.
+ *
+ * @param out The stream the answer is written to.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void BatchQueries::showStats(ostream &out) const {
+    out << "Airports: " << snapshot.getNumAirports() << endl;
+    out << "Airlines: " << snapshot.getNumAirlines() << endl;
+    out << "Flights: " << snapshot.getNumFlights() << endl;
+    out << "Snapshot: " << snapshot.getSize() << " bytes, "
+        << (snapshot.isMapped() ? "shared memory-mapped file" : "private memory") << endl;
+}
+
+/**
+ * @brief Prints an airport.
+ *
+ * @param code The code of the airport.
+ * @param out The stream the answer is written to.
+ *
+ * @complexity Time Complexity: O(log V), where V is the number of airports.
+ */
+void BatchQueries::showAirport(const string &code, ostream &out) {
+    int airport = findAirport(code, out);
+    if (airport < 0)
+        return;
+    Airport info = snapshot.getAirport(airport);
+    out << info.getCode() << " -- " << info.getName() << " (" << info.getCity() << ", " << info.getCountry() << ") "
+        << fixed << setprecision(6) << info.getPosition().getLatitude() << ", " << info.getPosition().getLongitude()
+        << defaultfloat << endl;
+}
+
+/**
+ * @brief Prints the nonstop destinations of an airport.
+ *
+ * @param code The code of the airport.
+ * @param out The stream the answer is written to.
+ *
+ * @complexity Time Complexity: O(log V + d log d), where d is the number of flights out of the airport.
+ */
+void BatchQueries::showDestinations(const string &code, ostream &out) {
+    int airport = findAirport(code, out);
+    if (airport < 0)
+        return;
+    vector<string> destinations;
+    for (int flight = snapshot.getFirstFlight(airport); flight < snapshot.getLastFlight(airport); flight++)
+        destinations.push_back(snapshot.getAirportCode(snapshot.getFlightTarget(flight)));
+    sort(destinations.begin(), destinations.end());
+    destinations.erase(unique(destinations.begin(), destinations.end()), destinations.end());
+
+    out << "Flights from " << code << ": " << snapshot.getLastFlight(airport) - snapshot.getFirstFlight(airport) << endl;
+    out << "Destinations from " << code << ": " << destinations.size() << endl;
+    for (const auto &destination : destinations)
+        out << destination << endl;
+}
+
+/**
+ * @brief Prints how many airports can be reached from an airport with at most a given number of stops.
+ *
+ * @param code The code of the airport.
+ * @param maxStops The maximum number of stops.
+ * @param out The stream the answer is written to.
+ *
+ * @complexity Time Complexity: O(V + E), where V is the number of airports and E the number of flights.
+ */
+void BatchQueries::showReachable(const string &code, int maxStops, ostream &out) {
+    int source = findAirport(code, out);
+    if (source < 0)
+        return;
+    distance.assign(snapshot.getNumAirports(), -1);
+    queue.clear();
+    distance[source] = 0;
+    queue.push_back(source);
+    for (size_t head = 0; head < queue.size(); head++) {
+        int airport = queue[head];
+        if (distance[airport] > maxStops)
+            break;
+        for (int flight = snapshot.getFirstFlight(airport); flight < snapshot.getLastFlight(airport); flight++) {
+            int target = snapshot.getFlightTarget(flight);
+            if (distance[target] < 0) {
+                distance[target] = distance[airport] + 1;
+                queue.push_back(target);
+            }
+        }
+    }
+    long reached = count_if(queue.begin(), queue.end(), [this, maxStops](int airport) {
+        return distance[airport] > 0 && distance[airport] <= maxStops + 1;
+    });
+    out << "Number of reachable airports: " << reached << endl;
+}
+
+/**
+ * @brief Prints the available queries.
+ *
+ * @param out The stream the answer is written to.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void BatchQueries::showHelp(ostream &out) {
+    out << "stats                         size of the dataset" << endl;
+    out << "airport CODE                  information about an airport" << endl;
+    out << "destinations CODE             nonstop destinations of an airport" << endl;
+    out << "reachable CODE STOPS          airports reachable with at most STOPS stops" << endl;
+    out << "query AGGREGATE [where ...]   ad-hoc statistics over the flights, such as" << endl;
+    out << "                              query avg where origin = Portugal by airline top 5" << endl;
+    out << "set EXPRESSION                airports of a set expression, such as" << endl;
+    out << "                              set reach(OPO, 2) - reach(LIS, 2)" << endl;
+    out << "                              set country(Congo (Kinshasa)) | country(\"Cocos (Keeling) Islands\")" << endl;
+    out << "common CODE CODE...           nonstop destinations shared by all the airports" << endl;
+    out << "quit                          stop reading queries" << endl;
+}
@@ -0,0 +1,51 @@
+
+#ifndef PROJETO2_BATCHQUERIES_H
+#define PROJETO2_BATCHQUERIES_H
+
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "AirportSets.h"
+#include "DestinationLists.h"
+#include "FlightTable.h"
+#include "GraphSnapshot.h"
+#include "TrigramIndex.h"
+
+class BatchQueries {
+public:
+    BatchQueries(const GraphSnapshot &snapshot);
+
+    void run(std::istream &in, std::ostream &out);
+    bool execute(const std::string &line, std::ostream &out);
+
+private:
+    const GraphSnapshot &snapshot;      ///< the shared, read-only dataset
+    std::vector<int> distance;          ///< scratch: flights from the source of a search, -1 if not reached
+    std::vector<int> queue;             ///< scratch: queue of a breadth-first search
+    FlightTable table;                  ///< private columnar copy of the flights, once an ad-hoc query is asked
+    AirportSets sets;                   ///< private airport sets, once a set expression is asked
+    DestinationLists lists;             ///< private sorted nonstop destinations, once a common query is asked
+    bool tableBuilt = false;            ///< whether table was built
+    bool setsBuilt = false;             ///< whether sets was built
+    bool listsBuilt = false;            ///< whether lists was built
+    TrigramIndex codeIndex;             ///< fuzzy index of the airport codes, once an airport is not found
+    TrigramIndex nameIndex;             ///< fuzzy index of the airport names, once an airport is not found
+    std::vector<std::vector<int>> nameAirports;     ///< airports of each name of nameIndex
+    bool indexesBuilt = false;          ///< whether codeIndex and nameIndex were built
+
+    int findAirport(const std::string &code, std::ostream &out);
+    void suggestAirports(const std::string &code, std::ostream &out);
+    const FlightTable &getTable();
+    const AirportSets &getSets();
+    const DestinationLists &getLists();
+    void showStats(std::ostream &out) const;
+    void showAirport(const std::string &code, std::ostream &out);
+    void showDestinations(const std::string &code, std::ostream &out);
+    void showReachable(const std::string &code, int maxStops, std::ostream &out);
+    static void showHelp(std::ostream &out);
+};
+
+
+#endif //PROJETO2_BATCHQUERIES_H
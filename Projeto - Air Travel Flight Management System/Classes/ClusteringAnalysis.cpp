@@ -0,0 +1,283 @@
+
+#include "ClusteringAnalysis.h"
+#include "DestinationLists.h"
+#include "Parallel.h"
+#include <algorithm>
+
+using namespace std;
+
+const int ClusteringAnalysis::blockSize;
+
+/**
+ * @brief Constructor for the ClusteringAnalysis class.
+ *
+ * @param graph The flights graph.
+ *
+ * @info Builds the undirected route projection of the graph, as in ResilienceAnalysis, and counts its triangles.
+ * Every route is also oriented from the airport of lower degree to the one of higher degree, ties broken by id, so
+ * no airport has more than O(sqrt(R)) successors even if it is a large hub.
+ *
+ * @complexity Time Complexity: O(V + E log E + R^1.5 / P), where V is the number of vertices, E the number of edges,
+ * R the number of undirected routes and P the number of hardware threads.
+ */
+ClusteringAnalysis::ClusteringAnalysis(const Graph &graph) {
+    numberOfAirports = graph.getNumVertex();
+    vector<pair<int, int>> routes;
+    for (auto vertex : graph.getVertexSet()) {
+        for (const auto &edge : vertex->getAdj()) {
+            int u = vertex->getId();
+            int v = edge.getDest()->getId();
+            if (u != v)
+                routes.push_back({min(u, v), max(u, v)});
+        }
+    }
+    sort(routes.begin(), routes.end());
+    routes.erase(unique(routes.begin(), routes.end()), routes.end());
+
+    firstNeighbour.assign(numberOfAirports + 1, 0);
+    for (const auto &route : routes) {
+        firstNeighbour[route.first + 1]++;
+        firstNeighbour[route.second + 1]++;
+    }
+    for (int airport = 0; airport < numberOfAirports; airport++)
+        firstNeighbour[airport + 1] += firstNeighbour[airport];
+    neighbours.resize(firstNeighbour.back());
+    vector<int> next(firstNeighbour.begin(), firstNeighbour.end() - 1);
+    for (const auto &route : routes) {
+        neighbours[next[route.first]++] = route.second;
+        neighbours[next[route.second]++] = route.first;
+    }
+
+    auto before = [this](int u, int v) {
+        return getDegree(u) < getDegree(v) || (getDegree(u) == getDegree(v) && u < v);
+    };
+    firstSuccessor.assign(1, 0);
+    for (int airport = 0; airport < numberOfAirports; airport++) {
+        sort(neighbours.begin() + firstNeighbour[airport], neighbours.begin() + firstNeighbour[airport + 1]);
+        for (int i = firstNeighbour[airport]; i < firstNeighbour[airport + 1]; i++) {
+            if (before(airport, neighbours[i]))
+                successors.push_back(neighbours[i]);
+        }
+        firstSuccessor.push_back((int) successors.size());
+    }
+    countTriangles();
+}
+
+/**
+ * @brief Counts the triangles of the projection and the triangles through every airport.
+ *
+ * @info Each triangle is found once, from its first airport in degree order, by intersecting the successors of that
+ * airport with the successors of each of them. The intersections are the merging and galloping kernels of
+ * DestinationLists. Blocks of airports run in parallel, each one adding to its own counters, which are summed in
+ * block order afterwards.
+ *
+ * @complexity Time Complexity: O(R^1.5 / P + B * V), where R is the number of undirected routes, P the number of
+ * hardware threads, B the number of blocks and V the number of airports.
+ */
+void ClusteringAnalysis::countTriangles() {
+    int blocks = (numberOfAirports + blockSize - 1) / blockSize;
+    vector<vector<long long>> counts(blocks);
+    vector<long long> found(blocks, 0);
+    parallelFor(blocks, [&](size_t block) {
+        vector<long long> &count = counts[block];
+        count.assign(numberOfAirports, 0);
+        vector<int32_t> common;
+        int last = min(numberOfAirports, ((int) block + 1) * blockSize);
+        for (int u = (int) block * blockSize; u < last; u++) {
+            const int32_t *out = successors.data() + firstSuccessor[u];
+            size_t size = firstSuccessor[u + 1] - firstSuccessor[u];
+            common.resize(size);
+            for (size_t i = 0; i < size; i++) {
+                int v = out[i];
+                size_t n = DestinationLists::intersect(out, size, successors.data() + firstSuccessor[v],
+                                                       firstSuccessor[v + 1] - firstSuccessor[v], common.data());
+                for (size_t j = 0; j < n; j++)
+                    count[common[j]]++;
+                count[u] += n;
+                count[v] += n;
+                found[block] += n;
+            }
+        }
+    });
+
+    triangles.assign(numberOfAirports, 0);
+    numberOfTriangles = 0;
+    for (int block = 0; block < blocks; block++) {
+        for (int airport = 0; airport < numberOfAirports; airport++)
+            triangles[airport] += counts[block][airport];
+        numberOfTriangles += found[block];
+    }
+}
+
+/**
+ * @brief Gets the number of airports of the projection.
+ *
+ * @return The number of airports.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int ClusteringAnalysis::getNumberOfAirports() const {
+    return numberOfAirports;
+}
+
+/**
+ * @brief Gets the number of undirected routes of the projection.
+ *
+ * @return The number of routes.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int ClusteringAnalysis::getNumberOfRoutes() const {
+    return (int) neighbours.size() / 2;
+}
+
+/**
+ * @brief Gets the number of airports an airport shares a route with.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return The degree of the airport in the undirected projection.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int ClusteringAnalysis::getDegree(int airport) const {
+    return firstNeighbour[airport + 1] - firstNeighbour[airport];
+}
+
+/**
+ * @brief Gets the number of triangles of the projection.
+ *
+ * @return The number of triples of airports with routes between all of them.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+long long ClusteringAnalysis::getNumberOfTriangles() const {
+    return numberOfTriangles;
+}
+
+/**
+ * @brief Gets the number of triangles through an airport.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return The number of routes between neighbours of the airport.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+long long ClusteringAnalysis::getTriangles(int airport) const {
+    return triangles[airport];
+}
+
+/**
+ * @brief Gets the local clustering coefficient of an airport.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return The fraction (0 to 1) of the pairs of neighbours of the airport that share a route, or 0 if it has fewer
+ * than two neighbours.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double ClusteringAnalysis::getClustering(int airport) const {
+    long long degree = getDegree(airport);
+    return degree < 2 ? 0 : 2.0 * triangles[airport] / (degree * (degree - 1));
+}
+
+/**
+ * @brief Gets the average local clustering coefficient.
+ *
+ * @return The average over the airports with at least two neighbours, or 0 if there is none.
+ *
+ * @complexity Time Complexity: O(V), where V is the number of airports.
+ */
+double ClusteringAnalysis::getAverageClustering() const {
+    double sum = 0;
+    int counted = 0;
+    for (int airport = 0; airport < numberOfAirports; airport++) {
+        if (getDegree(airport) >= 2) {
+            sum += getClustering(airport);
+            counted++;
+        }
+    }
+    return counted == 0 ? 0 : sum / counted;
+}
+
+/**
+ * @brief Gets the global transitivity of the projection.
+ *
+ * @return The fraction (0 to 1) of the connected triads (two routes sharing an airport) that are closed into a
+ * triangle, or 0 if there is none.
+ *
+ * @complexity Time Complexity: O(V), where V is the number of airports.
+ */
+double ClusteringAnalysis::getTransitivity() const {
+    long long triads = 0;
+    for (int airport = 0; airport < numberOfAirports; airport++) {
+        long long degree = getDegree(airport);
+        triads += degree * (degree - 1) / 2;
+    }
+    return triads == 0 ? 0 : 3.0 * numberOfTriangles / triads;
+}
+
+/**
+ * @brief Suggests the new routes that would close the most open triads.
+ *
+ * @param k The number of suggestions.
+ *
+ * @return Up to k pairs of airports without a route between them, by decreasing number of common neighbours, ties
+ * broken by id.
+ *
+ * @info Blocks of airports run in parallel. For every airport, the neighbours of its neighbours with a greater id are
+ * counted in a dense array, skipping its own neighbours, and each block keeps only its best k pairs.
+ *
+ * @complexity Time Complexity: O((sum of d^2) / P + B * (V + k log k)), where d is the degree of each airport, P the
+ * number of hardware threads, B the number of blocks and V the number of airports.
+ */
+vector<MissingLink> ClusteringAnalysis::suggestLinks(int k) const {
+    auto better = [](const MissingLink &a, const MissingLink &b) {
+        if (a.commonNeighbours != b.commonNeighbours)
+            return a.commonNeighbours > b.commonNeighbours;
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    };
+    auto keepBest = [&better, k](vector<MissingLink> &links) {
+        size_t size = min<size_t>(links.size(), max(k, 0));
+        partial_sort(links.begin(), links.begin() + size, links.end(), better);
+        links.resize(size);
+    };
+
+    int blocks = (numberOfAirports + blockSize - 1) / blockSize;
+    vector<vector<MissingLink>> best(blocks);
+    parallelFor(blocks, [&](size_t block) {
+        vector<int> common(numberOfAirports, 0), touched;
+        vector<bool> adjacent(numberOfAirports, false);
+        int last = min(numberOfAirports, ((int) block + 1) * blockSize);
+        for (int u = (int) block * blockSize; u < last; u++) {
+            for (int i = firstNeighbour[u]; i < firstNeighbour[u + 1]; i++)
+                adjacent[neighbours[i]] = true;
+            for (int i = firstNeighbour[u]; i < firstNeighbour[u + 1]; i++) {
+                int v = neighbours[i];
+                for (int j = firstNeighbour[v]; j < firstNeighbour[v + 1]; j++) {
+                    int w = neighbours[j];
+                    if (w > u && !adjacent[w] && common[w]++ == 0)
+                        touched.push_back(w);
+                }
+            }
+            for (int w : touched) {
+                best[block].push_back({u, w, common[w]});
+                common[w] = 0;
+            }
+            touched.clear();
+            for (int i = firstNeighbour[u]; i < firstNeighbour[u + 1]; i++)
+                adjacent[neighbours[i]] = false;
+            if (best[block].size() > 4 * (size_t) max(k, 1) + 1024)
+                keepBest(best[block]);
+        }
+        keepBest(best[block]);
+    });
+
+    vector<MissingLink> res;
+    for (const auto &links : best)
+        res.insert(res.end(), links.begin(), links.end());
+    keepBest(res);
+    return res;
+}
@@ -0,0 +1,45 @@
+
+#ifndef PROJETO2_CLUSTERINGANALYSIS_H
+#define PROJETO2_CLUSTERINGANALYSIS_H
+
+
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+
+struct MissingLink {
+    int first;              ///< one airport of the suggested route
+    int second;             ///< the other airport, with a greater id
+    int commonNeighbours;   ///< airports with routes to both, i.e. the open triads the route would close
+};
+
+class ClusteringAnalysis {
+public:
+    ClusteringAnalysis(const Graph &graph);
+
+    int getNumberOfAirports() const;
+    int getNumberOfRoutes() const;
+    int getDegree(int airport) const;
+    long long getNumberOfTriangles() const;
+    long long getTriangles(int airport) const;
+    double getClustering(int airport) const;
+    double getAverageClustering() const;
+    double getTransitivity() const;
+    std::vector<MissingLink> suggestLinks(int k) const;
+
+private:
+    int numberOfAirports;                   ///< number of vertices of the projection
+    std::vector<int> firstNeighbour;        ///< first neighbour of each airport, then the end
+    std::vector<int> neighbours;            ///< airports sharing a route with each airport, sorted
+    std::vector<int> firstSuccessor;        ///< first successor of each airport, then the end
+    std::vector<int32_t> successors;        ///< neighbours of each airport that come later in degree order, sorted
+    std::vector<long long> triangles;       ///< triangles through each airport
+    long long numberOfTriangles = 0;        ///< triangles of the projection
+
+    static const int blockSize = 64;        ///< airports handed to a thread at a time
+
+    void countTriangles();
+};
+
+
+#endif //PROJETO2_CLUSTERINGANALYSIS_H
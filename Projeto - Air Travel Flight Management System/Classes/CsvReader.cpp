@@ -0,0 +1,282 @@
+
+#include "CsvReader.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Constructor for the CsvReader class. The reader starts empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+CsvReader::CsvReader() {}
+
+/**
+ * @brief Reads and tokenizes a CSV file.
+ *
+ * @param filename The path to the file.
+ *
+ * @return True if the file could be read.
+ *
+ * @complexity Time Complexity: O(n), where n is the size of the file.
+ */
+bool CsvReader::open(const string &filename) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open())
+        return false;
+    parse(string(istreambuf_iterator<char>(file), istreambuf_iterator<char>()));
+    return true;
+}
+
+/**
+ * @brief Tokenizes CSV text that is already in memory.
+ *
+ * @param contents The text, following RFC 4180 (LF or CRLF line breaks, fields optionally enclosed in double quotes,
+ * quotes inside a quoted field doubled).
+ *
+ * @complexity Time Complexity: O(n), where n is the size of the text.
+ */
+void CsvReader::parse(string contents) {
+    text = move(contents);
+    tokenize();
+}
+
+/**
+ * @brief Builds the bitmask of the bytes of a 64-byte block equal to a character.
+ *
+ * @param block The block.
+ * @param c The character.
+ *
+ * @return A mask with bit i set if block[i] == c.
+ *
+ * @info Compares 32 (AVX2) or 16 (SSE2) bytes per instruction, with a plain loop on other targets.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+uint64_t CsvReader::matches(const char *block, char c) {
+#if defined(__AVX2__)
+    __m256i value = _mm256_set1_epi8(c);
+    uint64_t low = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) block), value));
+    uint64_t high = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (block + 32)), value));
+    return low | high << 32;
+#elif defined(__SSE2__)
+    __m128i value = _mm_set1_epi8(c);
+    uint64_t res = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *) (block + 16 * i));
+        res |= (uint64_t) (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, value)) << (16 * i);
+    }
+    return res;
+#else
+    uint64_t res = 0;
+    for (int i = 0; i < 64; i++)
+        res |= (uint64_t) (block[i] == c) << i;
+    return res;
+#endif
+}
+
+/**
+ * @brief Finds the end of every field and every row of the text.
+ *
+ * @info simdcsv-style: each 64-byte block becomes bitmasks of quotes, commas and line breaks. The prefix XOR of the
+ * quote mask marks the bytes inside quoted fields (doubled quotes toggle twice and cancel out), carried over from the
+ * previous block, and removes the commas and line breaks inside them. The remaining bits are the separators, extracted
+ * with count-trailing-zeros without looking at the bytes one by one.
+ *
+ * @complexity Time Complexity: O(n + F), where n is the size of the text and F the number of fields.
+ */
+void CsvReader::tokenize() {
+    separators.clear();
+    rows.clear();
+    vector<uint32_t> rowStarts = {0};
+    size_t size = text.size();
+    uint64_t insideCarry = 0;
+    char tail[64];
+
+    for (size_t base = 0; base < size; base += 64) {
+        const char *block = text.data() + base;
+        if (size - base < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, size - base);
+            block = tail;
+        }
+        uint64_t quotes = matches(block, '"');
+        uint64_t commas = matches(block, ',');
+        uint64_t newlines = matches(block, '\n');
+
+        uint64_t inside = quotes;
+        for (int shift = 1; shift < 64; shift <<= 1)
+            inside ^= inside << shift;
+        inside ^= insideCarry;
+        insideCarry = (uint64_t) ((int64_t) inside >> 63);
+
+        uint64_t structural = (commas | newlines) & ~inside;
+        newlines &= ~inside;
+        while (structural != 0) {
+            int bit = __builtin_ctzll(structural);
+            separators.push_back((uint32_t) (base + bit));
+            if (newlines >> bit & 1)
+                rowStarts.push_back((uint32_t) separators.size());
+            structural &= structural - 1;
+        }
+    }
+    if (size > 0 && text[size - 1] != '\n') {
+        separators.push_back((uint32_t) size);
+        rowStarts.push_back((uint32_t) separators.size());
+    }
+
+    // blank lines (a single empty field) are not rows
+    for (size_t r = 0; r + 1 < rowStarts.size(); r++) {
+        uint32_t first = rowStarts[r], last = rowStarts[r + 1];
+        uint32_t start = first == 0 ? 0 : separators[first - 1] + 1;
+        uint32_t end = separators[first];
+        bool blank = last - first == 1 && (end == start || (end == start + 1 && text[start] == '\r'));
+        if (!blank)
+            rows.push_back({first, last});
+    }
+}
+
+/**
+ * @brief Gets the number of rows, including the header row.
+ *
+ * @return The number of rows.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int CsvReader::getNumRows() const {
+    return (int) rows.size();
+}
+
+/**
+ * @brief Gets the number of fields of a row.
+ *
+ * @param row The index of the row.
+ *
+ * @return The number of fields.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int CsvReader::getNumFields(int row) const {
+    return (int) (rows[row].second - rows[row].first);
+}
+
+/**
+ * @brief Gets the value of a field.
+ *
+ * @param row The index of the row.
+ * @param field The index of the field in the row.
+ *
+ * @return The value, without the enclosing quotes and with doubled quotes undone, or an empty string if the row has
+ * fewer fields.
+ *
+ * @complexity Time Complexity: O(m), where m is the length of the field.
+ */
+string CsvReader::getField(int row, int field) const {
+    if (field < 0 || field >= getNumFields(row))
+        return "";
+    uint32_t index = rows[row].first + field;
+    size_t start = index == 0 ? 0 : separators[index - 1] + 1;
+    size_t end = separators[index];
+    if (end > start && text[end - 1] == '\r')
+        end--;
+    if (end - start < 2 || text[start] != '"')
+        return text.substr(start, end - start);
+
+    string res;
+    for (size_t i = start + 1; i < end - 1; i++) {
+        res += text[i];
+        if (text[i] == '"' && text[i + 1] == '"')
+            i++;
+    }
+    return res;
+}
+
+/**
+ * @brief Gets the value of a numeric field.
+ *
+ * @param row The index of the row.
+ * @param field The index of the field in the row.
+ *
+ * @return The value, or 0 if the field is not a number.
+ *
+ * @complexity Time Complexity: O(m), where m is the length of the field.
+ */
+double CsvReader::getDouble(int row, int field) const {
+    return strtod(getField(row, field).c_str(), nullptr);
+}
+
+/**
+ * @brief Compares the throughput of this tokenizer with the getline and istringstream splitting it replaced.
+ *
+ * @param filenames The CSV files to read.
+ * @param repetitions How many times each file is parsed by each method.
+ * @param out The stream where a CSV report is written: file, bytes, GB/s of each method and a checksum.
+ *
+ * @info Files are read into memory once, so only parsing is timed. The tokenizer is timed on its own (parse) and
+ * together with extracting every field as a string (parse and getField), as the getline method does.
+ *
+ * @complexity Time Complexity: O(R * n), where R is the number of repetitions and n the total size of the files.
+ */
+void CsvReader::benchmark(const vector<string> &filenames, int repetitions, ostream &out) {
+    typedef chrono::steady_clock Clock;
+    out << "file,bytes,getline_gb_per_s,parse_gb_per_s,parse_and_fields_gb_per_s,parse_speedup,checksum" << endl;
+    for (const auto &filename : filenames) {
+        ifstream file(filename, ios::binary);
+        if (!file.is_open()) {
+            out << filename << ",0,0,0,0,0,0" << endl;
+            continue;
+        }
+        string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+        size_t checksum = 0;
+        auto start = Clock::now();
+        for (int r = 0; r < repetitions; r++) {
+            istringstream in(contents);
+            string line, field;
+            while (getline(in, line)) {
+                istringstream ss(line);
+                while (getline(ss, field, ','))
+                    checksum += field.size();
+            }
+        }
+        double getlineSeconds = chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) {
+            CsvReader csv;
+            csv.parse(contents);
+            checksum += csv.getNumRows();
+        }
+        double parseSeconds = chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) {
+            CsvReader csv;
+            csv.parse(contents);
+            for (int row = 0; row < csv.getNumRows(); row++) {
+                for (int f = 0; f < csv.getNumFields(row); f++)
+                    checksum += csv.getField(row, f).size();
+            }
+        }
+        double fieldsSeconds = chrono::duration<double>(Clock::now() - start).count();
+
+        static volatile size_t sink;
+        sink = checksum;
+
+        double gigabytes = (double) contents.size() * repetitions / 1e9;
+        out << filename << ',' << contents.size() << ',' << gigabytes / getlineSeconds << ','
+            << gigabytes / parseSeconds << ',' << gigabytes / fieldsSeconds << ','
+            << getlineSeconds / parseSeconds << ',' << sink << endl;
+    }
+}
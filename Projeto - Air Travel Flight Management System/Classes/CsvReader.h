@@ -0,0 +1,36 @@
+
+#ifndef PROJETO2_CSVREADER_H
+#define PROJETO2_CSVREADER_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CsvReader {
+public:
+    CsvReader();
+
+    bool open(const std::string &filename);
+    void parse(std::string contents);
+    int getNumRows() const;
+    int getNumFields(int row) const;
+    std::string getField(int row, int field) const;
+    double getDouble(int row, int field) const;
+
+    static void benchmark(const std::vector<std::string> &filenames, int repetitions, std::ostream &out);
+
+private:
+    std::string text;                       ///< the whole file
+    std::vector<std::uint32_t> separators;  ///< position of the comma or line break that ends each field
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> rows;  ///< first and one past the last field of each row
+
+    void tokenize();
+    static std::uint64_t matches(const char *block, char c);
+};
+
+
+#endif //PROJETO2_CSVREADER_H
@@ -1,21 +1,278 @@
 
 #include <unordered_map>
 #include "Data.h"
+#include "CsvReader.h"
 #include <fstream>
+#include <thread>
+#include <sys/stat.h>
 
 using namespace std;
 
+const int Data::compactionThreshold;
+
 /**
  * @brief Constructor for the Data class.
  *
  * This constructor initializes the Data object by reading information from CSV files and creating the flights graph.
  *
- * @complexity Time Complexity: O(N + M), where N is the number of airlines, and M is the number of airports.
+ * @info If "graph.snapshot" in the working directory was built from the same dataset files, everything is rebuilt
+ * from it without parsing any CSV. Otherwise the three files are parsed at the same time: airlines and flights on their
+ * own threads, airports on this one. Flights are buffered by airport code while parsing, and only turned into edges
+ * (which need the coordinates of the airports) once every file has been read; a new snapshot is then saved. Either
+ * way, the schedule changes logged after the snapshot are then replayed.
+ *
+ * @complexity Time Complexity: O(N + M + F), where N is the number of airlines, M is the number of airports and F is
+ * the number of flights.
  */
 Data::Data() : flights(airports) {
-    readAirlines("../dataset/airlines.csv");
+    fingerprint = computeFingerprint();
+    GraphSnapshot snapshot;
+    if (snapshot.load("graph.snapshot", fingerprint)) {
+        compactedSequence = snapshot.getSequence();
+        loadSnapshot(snapshot);
+        recoverSchedule();
+        return;
+    }
+
+    vector<FlightRecord> records;
+    thread airlinesReader([this]() {
+        readAirlines("../dataset/airlines.csv");
+    });
+    thread flightsReader([&records]() {
+        records = readFlights("../dataset/flights.csv");
+    });
     readAirports("../dataset/airports.csv");
-    createFlightsGraph("../dataset/flights.csv");
+    airlinesReader.join();
+    flightsReader.join();
+    createFlightsGraph(records);
+    createSnapshot().save("graph.snapshot");
+    recoverSchedule();
+}
+
+/**
+ * @brief Replays the schedule changes logged after the loaded snapshot.
+ *
+ * @info The log only holds the changes since the last compaction, so this takes a bounded time however many changes
+ * were made since the dataset files were produced.
+ *
+ * @complexity Time Complexity: O(C * d), where C is the number of changes in the log and d the largest number of
+ * flights out of an airport.
+ */
+void Data::recoverSchedule() {
+    uint64_t sequence = compactedSequence;
+    bool complete = ScheduleLog::replay("schedule.log", fingerprint, sequence,
+                                        [this](const ScheduleChange &change) {
+        if (applyChange(change))
+            recoveredChanges++;
+    });
+    scheduleSequence = sequence;
+    if (!complete)
+        cerr << "schedule.log continues a newer snapshot than graph.snapshot, its changes were not applied." << endl;
+}
+
+/**
+ * @brief Applies a schedule change to the flights graph, keeping the degrees up to date.
+ *
+ * @param change The change.
+ *
+ * @return True if the change was applied, false if an airport, the airline or the cancelled flight does not exist.
+ *
+ * @info Every way a change reaches the graph (the schedule commands, the update stream and the log replay) goes
+ * through here, so the rest of the system can assume every flight belongs to a known airline.
+ *
+ * @complexity Time Complexity: O(1) average for an added flight, O(d) for a cancelled one, where d is the number of
+ * flights out of the source airport.
+ */
+bool Data::applyChange(const ScheduleChange &change) {
+    Vertex *source = flights.findVertex(change.source);
+    Vertex *target = flights.findVertex(change.target);
+    if (source == nullptr || target == nullptr || airlines.find(change.airline) == airlines.end())
+        return false;
+    if (change.operation == ScheduleOperation::AddFlight) {
+        Position p1 = airports.find(change.source)->second.getPosition();
+        Position p2 = airports.find(change.target)->second.getPosition();
+        flights.addEdge(change.source, change.target, change.airline, p1.haversineDistance(p2));
+        source->setOutdegree(source->getOutdegree() + 1);
+        target->setIndegree(target->getIndegree() + 1);
+        return true;
+    }
+    if (!flights.removeEdge(change.source, change.target, change.airline))
+        return false;
+    source->setOutdegree(source->getOutdegree() - 1);
+    target->setIndegree(target->getIndegree() - 1);
+    return true;
+}
+
+/**
+ * @brief Adds a flight to the schedule.
+ *
+ * @param source The code of the source airport.
+ * @param target The code of the target airport.
+ * @param airline The code of the airline.
+ *
+ * @return True if both airports and the airline exist and the flight was added.
+ *
+ * @info The change is applied right away, but it only survives a crash once commitSchedule returns.
+ *
+ * @complexity Time Complexity: O(1) average.
+ */
+bool Data::addFlight(const string &source, const string &target, const string &airline) {
+    ScheduleChange change = {ScheduleOperation::AddFlight, source, target, airline};
+    if (!applyChange(change))
+        return false;
+    pendingChanges.push_back(change);
+    return true;
+}
+
+/**
+ * @brief Cancels a flight of the schedule.
+ *
+ * @param source The code of the source airport.
+ * @param target The code of the target airport.
+ * @param airline The code of the airline.
+ *
+ * @return True if the flight existed and was removed.
+ *
+ * @info The change is applied right away, but it only survives a crash once commitSchedule returns.
+ *
+ * @complexity Time Complexity: O(d), where d is the number of flights out of the source airport.
+ */
+bool Data::removeFlight(const string &source, const string &target, const string &airline) {
+    ScheduleChange change = {ScheduleOperation::RemoveFlight, source, target, airline};
+    if (!applyChange(change))
+        return false;
+    pendingChanges.push_back(change);
+    return true;
+}
+
+/**
+ * @brief Appends the pending changes to the log.
+ *
+ * @return True if they reached the disk (or there were none).
+ *
+ * @complexity Time Complexity: O(C), where C is the number of pending changes, plus O(L) the first time, where L is the
+ * size of the log.
+ */
+bool Data::logPendingChanges() {
+    if (pendingChanges.empty())
+        return true;
+    if (!scheduleLog.append("schedule.log", fingerprint, scheduleSequence + 1, pendingChanges))
+        return false;
+    scheduleSequence += pendingChanges.size();
+    pendingChanges.clear();
+    return true;
+}
+
+/**
+ * @brief Makes the changes applied since the last commit durable.
+ *
+ * @return True if they were logged.
+ *
+ * @info All pending changes are written with a single fsync. Once compactionThreshold changes are in the log, they are
+ * folded into a new snapshot, which keeps the log, and so the recovery time, bounded.
+ *
+ * @complexity Time Complexity: O(C), plus a compaction every compactionThreshold changes, where C is the number of
+ * pending changes.
+ */
+bool Data::commitSchedule() {
+    if (!logPendingChanges())
+        return false;
+    if (scheduleSequence - compactedSequence >= compactionThreshold)
+        compactSchedule();
+    return true;
+}
+
+/**
+ * @brief Folds every logged change into a new graph.snapshot and starts an empty log.
+ *
+ * @return True if both the snapshot and the new log were written.
+ *
+ * @info The snapshot records the sequence number of the last change it holds, so a crash between writing the snapshot
+ * and emptying the log only makes the next recovery skip the changes it already has. The log is only emptied once the
+ * snapshot and its directory entry are on the disk.
+ *
+ * @complexity Time Complexity: O(M log M + N log N + F), where N is the number of airlines, M is the number of airports
+ * and F is the number of flights.
+ */
+bool Data::compactSchedule() {
+    if (!logPendingChanges() || !createSnapshot().save("graph.snapshot"))
+        return false;
+    compactedSequence = scheduleSequence;
+    return scheduleLog.reset("schedule.log", fingerprint, scheduleSequence);
+}
+
+/**
+ * @brief Gets the number of schedule changes replayed from the log when loading.
+ *
+ * @return The number of changes recovered, not counting the ones that could not be applied.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int Data::getRecoveredChanges() const {
+    return recoveredChanges;
+}
+
+/**
+ * @brief Gets the sequence number of the last schedule change logged.
+ *
+ * @return The number of changes logged since the dataset files were read.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+unsigned long long Data::getScheduleSequence() const {
+    return scheduleSequence;
+}
+
+/**
+ * @brief Computes the fingerprint of the dataset files, without reading them.
+ *
+ * @return A hash of the size and the modification time of the airlines, airports and flights files.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+unsigned long long Data::computeFingerprint() {
+    unsigned long long fingerprint = 14695981039346656037ULL;
+    addToFingerprint(fingerprint, "../dataset/airlines.csv");
+    addToFingerprint(fingerprint, "../dataset/airports.csv");
+    addToFingerprint(fingerprint, "../dataset/flights.csv");
+    return fingerprint;
+}
+
+/**
+ * @brief Mixes the size and the modification time of a dataset file into a fingerprint.
+ *
+ * @param fingerprint The fingerprint to update.
+ * @param filename The path to the file.
+ *
+ * @info Uses FNV-1a, so the fingerprint changes whenever any of the files is replaced or edited.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void Data::addToFingerprint(unsigned long long &fingerprint, const string &filename) {
+    struct stat info;
+    unsigned long long values[2] = {0, 0};
+    if (stat(filename.c_str(), &info) == 0) {
+        values[0] = (unsigned long long) info.st_size;
+        values[1] = (unsigned long long) info.st_mtime;
+    }
+    for (unsigned long long value : values) {
+        for (int i = 0; i < 8; i++) {
+            fingerprint ^= (value >> (8 * i)) & 0xFF;
+            fingerprint *= 1099511628211ULL;
+        }
+    }
+}
+
+/**
+ * @brief Get the fingerprint of the dataset files.
+ *
+ * @return A hash of the size and the modification time of the files read, used to tell if a snapshot derived from
+ * them is still up to date.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+unsigned long long Data::getFingerprint() const {
+    return fingerprint;
 }
 
 /**
@@ -28,28 +285,21 @@ Data::Data() : flights(airports) {
  * @complexity Time Complexity: O(N), where N is the number of airlines in the file.
  */
 void Data::readAirlines(const string& filename) {
-    ifstream file(filename);
+    CsvReader file;
 
-    if (!file.is_open()) {
+    if (!file.open(filename)) {
         cerr << "Erro ao abrir o arquivo de Airlines." << endl;
         return;
     }
 
-    string line;
-    getline(file, line);
-
-    while (getline(file, line)) {
-        istringstream ss(line);
-        string code, name, callsign, country;
-        getline(ss, code, ',');
-        getline(ss, name, ',');
-        getline(ss, callsign, ',');
-        getline(ss, country, ',');
+    for (int row = 1; row < file.getNumRows(); row++) {
+        string code = file.getField(row, 0);
+        string name = file.getField(row, 1);
+        string callsign = file.getField(row, 2);
+        string country = file.getField(row, 3);
 
         airlines.insert({code ,Airline{code, name, callsign, country}});
     }
-
-    file.close();
 }
 
 /**
@@ -57,37 +307,30 @@ void Data::readAirlines(const string& filename) {
  *
  * @param filename The path to the CSV file containing airport information.
  *
- * @info This method reads airport information from a CSV file and populates the airports unordered_map.
+ * @info This method reads airport information from a CSV file and populates the airports unordered_map. Quoted
+ * fields, such as names that contain commas, are read whole.
  *
  * @complexity Time Complexity: O(M), where M is the number of airports in the file.
  */
 void Data::readAirports(const string& filename) {
-    ifstream file(filename);
+    CsvReader file;
 
-    if (!file.is_open()) {
+    if (!file.open(filename)) {
         cerr << "Erro ao abrir o arquivo de Airports." << endl;
         return;
     }
 
-    string line;
-    getline(file, line);
+    for (int row = 1; row < file.getNumRows(); row++) {
+        string code = file.getField(row, 0);
+        string name = file.getField(row, 1);
+        string city = file.getField(row, 2);
+        string country = file.getField(row, 3);
+        double latitude = file.getDouble(row, 4);
+        double longitude = file.getDouble(row, 5);
 
-    while (getline(file, line)) {
-        istringstream ss(line);
-        string code, name, city, country;
-        double latitude, longitude;
-
-        getline(ss, code, ',');
-        getline(ss, name, ',');
-        getline(ss, city, ',');
-        getline(ss, country, ',');
-        ss >> latitude; ss.ignore();
-        ss >> longitude; ss.ignore();
-
-        airports.insert({code, Airport{code, name, city, country, latitude, longitude}});
+        if (airports.insert({code, Airport{code, name, city, country, latitude, longitude}}).second)
+            readOrder.push_back(code);
     }
-
-    file.close();
 }
 
 /**
@@ -100,21 +343,91 @@ void Data::readAirports(const string& filename) {
  * @complexity Time Complexity: O(N), where N is the number of flights in the file.
  */
 void Data::createFlightsGraph(const string& filename){
-    ifstream file(filename);
+    createFlightsGraph(readFlights(filename));
+}
+
+/**
+ * @brief Read flight information from a CSV file, without resolving the airports.
+ *
+ * @param filename The path to the CSV file containing flight information.
+ *
+ * @return The flights, in file order, as airport and airline codes.
+ *
+ * @info Does not touch any member, so it can run while the airports are still being read.
+ *
+ * @complexity Time Complexity: O(N), where N is the number of flights in the file.
+ */
+vector<FlightRecord> Data::readFlights(const string &filename) {
+    vector<FlightRecord> records;
+    CsvReader file;
+    file.open(filename);
+    for (int row = 1; row < file.getNumRows(); row++) {
+        records.push_back({file.getField(row, 0), file.getField(row, 1), file.getField(row, 2)});
+    }
+    return records;
+}
 
+/**
+ * @brief Create the flights graph from flights already read.
+ *
+ * @param records The flights, as airport and airline codes. The airports must be loaded.
+ *
+ * @complexity Time Complexity: O(N), where N is the number of flights.
+ */
+void Data::createFlightsGraph(const vector<FlightRecord> &records) {
     flights = Graph(airports);
 
-    string source, target, airline, aLine;
-    getline(file, aLine);
-    while (getline(file, aLine)){
-        istringstream inn(aLine);
-        getline(inn, source, ',');
-        getline(inn, target, ',');
-        getline(inn, airline, ',');
-        Position p1 = airports.find(source)->second.getPosition();
-        Position p2 = airports.find(target)->second.getPosition();
-        flights.addEdge(source, target, airline, p1.haversineDistance(p2));
+    for (const auto &record : records){
+        Position p1 = airports.find(record.source)->second.getPosition();
+        Position p2 = airports.find(record.target)->second.getPosition();
+        flights.addEdge(record.source, record.target, record.airline, p1.haversineDistance(p2));
     }
+    countDegrees();
+}
+
+/**
+ * @brief Rebuilds the airports, the airlines and the flights graph from a snapshot.
+ *
+ * @param snapshot A snapshot of the same dataset.
+ *
+ * @info Airports are inserted in their original order, so the maps and the vertex ids come out exactly as if the CSV
+ * files had been read, and airlines are registered in the order of their ids before any flight is added.
+ *
+ * @complexity Time Complexity: O(N + M + F), where N is the number of airlines, M is the number of airports and F is
+ * the number of flights.
+ */
+void Data::loadSnapshot(const GraphSnapshot &snapshot) {
+    for (int i = 0; i < snapshot.getNumAirports(); i++) {
+        Airport airport = snapshot.getAirport(snapshot.getAirportInReadOrder(i));
+        readOrder.push_back(airport.getCode());
+        airports.insert({airport.getCode(), airport});
+    }
+    for (int airline = 0; airline < snapshot.getNumAirlines(); airline++) {
+        Airline record = snapshot.getAirline(airline);
+        // airlines that only appear in flights have no catalog entry
+        if (!record.getName().empty() || !record.getCountry().empty())
+            airlines.insert({record.getCode(), record});
+    }
+
+    flights = Graph(airports);
+    for (int airline = 0; airline < snapshot.getNumFlightAirlines(); airline++)
+        flights.addAirline(snapshot.getAirlineCode(airline));
+    for (int airport = 0; airport < snapshot.getNumAirports(); airport++) {
+        string source = snapshot.getAirportCode(airport);
+        for (int flight = snapshot.getFirstFlight(airport); flight < snapshot.getLastFlight(airport); flight++) {
+            flights.addEdge(source, snapshot.getAirportCode(snapshot.getFlightTarget(flight)),
+                            snapshot.getAirlineCode(snapshot.getFlightAirline(flight)), snapshot.getFlightDistance(flight));
+        }
+    }
+    countDegrees();
+}
+
+/**
+ * @brief Counts the flights in and out of every airport of the flights graph.
+ *
+ * @complexity Time Complexity: O(V + E), where V is the number of vertices and E the number of edges.
+ */
+void Data::countDegrees() {
     for (auto vertex : flights.getVertexSet()){
         vertex->setOutdegree((int) vertex->getAdj().size());
         vertex->setIndegree(0);
@@ -126,6 +439,20 @@ void Data::createFlightsGraph(const string& filename){
     }
 }
 
+/**
+ * @brief Builds a position-independent snapshot of the airports, the airlines and the flights graph.
+ *
+ * @return The snapshot, in memory, ready to be saved and then mapped by other processes.
+ *
+ * @complexity Time Complexity: O(M log M + N log N + F), where N is the number of airlines, M is the number of airports
+ * and F is the number of flights.
+ */
+GraphSnapshot Data::createSnapshot() const {
+    GraphSnapshot snapshot;
+    snapshot.build(flights, airports, airlines, readOrder, fingerprint, scheduleSequence);
+    return snapshot;
+}
+
 /**
  * @brief Get the flights graph.
  *
@@ -133,7 +460,7 @@ void Data::createFlightsGraph(const string& filename){
  *
  * @complexity Time Complexity: O(1)
  */
-Graph Data::getFlightsGraph() {
+const Graph &Data::getFlightsGraph() const {
     return flights;
 }
 
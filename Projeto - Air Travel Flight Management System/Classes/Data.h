@@ -11,6 +11,14 @@
 #include "Airline.h"
 #include "Airport.h"
 #include "Graph.h"
+#include "GraphSnapshot.h"
+#include "ScheduleLog.h"
+
+struct FlightRecord {
+    std::string source;     ///< code of the source airport
+    std::string target;     ///< code of the target airport
+    std::string airline;    ///< code of the airline
+};
 
 class Data {
 private:
@@ -21,6 +29,36 @@ private:
 
     Graph flights;
 
+    std::vector<std::string> readOrder;     ///< codes of the airports, in the order they were read
+
+    unsigned long long fingerprint;         ///< identifies the dataset files that were read
+
+    std::vector<ScheduleChange> pendingChanges;     ///< changes applied to the graph but not logged yet
+
+    unsigned long long scheduleSequence = 0;        ///< sequence number of the last change logged
+
+    unsigned long long compactedSequence = 0;       ///< sequence number of the last change in graph.snapshot
+
+    int recoveredChanges = 0;                       ///< changes replayed from the log when loading
+
+    ScheduleLog scheduleLog;                        ///< schedule.log, kept open between commits
+
+    static void addToFingerprint(unsigned long long &fingerprint, const std::string &filename);
+
+    static std::vector<FlightRecord> readFlights(const std::string &filename);
+
+    void createFlightsGraph(const std::vector<FlightRecord> &records);
+
+    void loadSnapshot(const GraphSnapshot &snapshot);
+
+    void countDegrees();
+
+    void recoverSchedule();
+
+    bool applyChange(const ScheduleChange &change);
+
+    bool logPendingChanges();
+
 public:
 
     Data();
@@ -40,7 +78,27 @@ public:
 
     std::unordered_map<std::string, Airline> getAirlines();
 
-    Graph getFlightsGraph();
+    const Graph &getFlightsGraph() const;
+
+    unsigned long long getFingerprint() const;
+
+    static unsigned long long computeFingerprint();
+
+    GraphSnapshot createSnapshot() const;
+
+    bool addFlight(const std::string &source, const std::string &target, const std::string &airline);
+
+    bool removeFlight(const std::string &source, const std::string &target, const std::string &airline);
+
+    bool commitSchedule();
+
+    bool compactSchedule();
+
+    int getRecoveredChanges() const;
+
+    unsigned long long getScheduleSequence() const;
+
+    static const int compactionThreshold = 4096;    ///< logged changes that trigger a compaction
 
 };
 
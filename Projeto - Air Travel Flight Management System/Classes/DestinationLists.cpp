@@ -0,0 +1,305 @@
+
+#include "DestinationLists.h"
+#include <algorithm>
+#include <chrono>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+const size_t DestinationLists::gallopRatio;
+
+/**
+ * @brief Builds the destination lists of the airports of a graph.
+ *
+ * @param graph The flights graph.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of vertices and E the number of edges.
+ */
+void DestinationLists::build(const Graph &graph) {
+    firstDestination.clear();
+    destinations.clear();
+    airportCodes.clear();
+    for (auto vertex : graph.getVertexSet()) {
+        airportCodes.push_back(vertex->getInfo());
+        firstDestination.push_back((int) destinations.size());
+        for (const auto &edge : vertex->getAdj())
+            destinations.push_back(edge.getDest()->getId());
+    }
+    firstDestination.push_back((int) destinations.size());
+    index();
+}
+
+/**
+ * @brief Builds the destination lists of the airports of a snapshot.
+ *
+ * @param snapshot The snapshot.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of airports and E the number of flights.
+ */
+void DestinationLists::build(const GraphSnapshot &snapshot) {
+    firstDestination.clear();
+    destinations.clear();
+    airportCodes.clear();
+    for (int id = 0; id < snapshot.getNumAirports(); id++) {
+        airportCodes.push_back(snapshot.getAirportCode(id));
+        firstDestination.push_back((int) destinations.size());
+        for (int flight = snapshot.getFirstFlight(id); flight < snapshot.getLastFlight(id); flight++)
+            destinations.push_back(snapshot.getFlightTarget(flight));
+    }
+    firstDestination.push_back((int) destinations.size());
+    index();
+}
+
+/**
+ * @brief Sorts the targets of the flights of every airport and drops the repeated ones, in place.
+ *
+ * @info A route flown by several airlines is a single destination.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of airports and E the number of flights.
+ */
+void DestinationLists::index() {
+    int end = 0;
+    for (size_t airport = 0; airport + 1 < firstDestination.size(); airport++) {
+        auto first = destinations.begin() + firstDestination[airport];
+        auto last = destinations.begin() + firstDestination[airport + 1];
+        sort(first, last);
+        last = unique(first, last);
+        firstDestination[airport] = end;
+        for (auto destination = first; destination != last; destination++)
+            destinations[end++] = *destination;
+    }
+    firstDestination.back() = end;
+    destinations.resize(end);
+    destinations.shrink_to_fit();
+
+    airportIds.clear();
+    for (int id = 0; id < (int) airportCodes.size(); id++)
+        airportIds[airportCodes[id]] = id;
+}
+
+/**
+ * @brief Get the number of distinct nonstop destinations of an airport.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return The number of destinations.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int DestinationLists::getNumDestinations(int airport) const {
+    return firstDestination[airport + 1] - firstDestination[airport];
+}
+
+/**
+ * @brief Get the nonstop destinations of an airport.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return The ids of the destinations, sorted and distinct. There are getNumDestinations(airport) of them.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const int32_t *DestinationLists::getDestinations(int airport) const {
+    return destinations.data() + firstDestination[airport];
+}
+
+/**
+ * @brief Finds the airports every one of a group of airports flies to nonstop.
+ *
+ * @param airports The ids of the airports.
+ *
+ * @return The ids of the common destinations, sorted. Empty if the group is empty.
+ *
+ * @info The lists are intersected from the shortest one up, so every step is bounded by the result so far and can
+ * stop as soon as it is empty.
+ *
+ * @complexity Time Complexity: O(k log k + k * d), where k is the number of airports and d the size of the shortest
+ * list, less when the lists differ much in size.
+ */
+vector<int32_t> DestinationLists::common(const vector<int> &airports) const {
+    if (airports.empty())
+        return {};
+    vector<int> order = airports;
+    sort(order.begin(), order.end(), [this](int a, int b) { return getNumDestinations(a) < getNumDestinations(b); });
+
+    vector<int32_t> res(getDestinations(order[0]), getDestinations(order[0]) + getNumDestinations(order[0])), next;
+    for (size_t i = 1; i < order.size() && !res.empty(); i++) {
+        next.resize(res.size());
+        next.resize(intersect(res.data(), res.size(), getDestinations(order[i]), getNumDestinations(order[i]),
+                              next.data()));
+        res.swap(next);
+    }
+    return res;
+}
+
+/**
+ * @brief Prints the nonstop destinations shared by a group of airports.
+ *
+ * @param codes The codes of the airports.
+ * @param out The stream the answer is written to.
+ *
+ * @complexity Time Complexity: O(k log k + k * d + R log R), where k is the number of airports, d the size of the
+ * shortest list and R the number of common destinations.
+ */
+void DestinationLists::query(const vector<string> &codes, ostream &out) const {
+    if (codes.empty()) {
+        out << "Missing airports" << endl;
+        return;
+    }
+    vector<int> airports;
+    for (const auto &code : codes) {
+        auto it = airportIds.find(code);
+        if (it == airportIds.end()) {
+            out << "Airport " << code << " doesn't exist" << endl;
+            return;
+        }
+        airports.push_back(it->second);
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<int32_t> res = common(airports);
+    auto end = chrono::steady_clock::now();
+
+    vector<string> names;
+    for (int32_t id : res)
+        names.push_back(airportCodes[id]);
+    sort(names.begin(), names.end());
+    for (size_t i = 0; i < names.size(); i++)
+        out << names[i] << (i % 16 == 15 || i + 1 == names.size() ? "\n" : " ");
+    out << "Destinations:";
+    for (size_t i = 0; i < codes.size(); i++)
+        out << " " << codes[i] << " " << getNumDestinations(airports[i]);
+    out << endl;
+    out << res.size() << " common nonstop destinations, in "
+        << chrono::duration<double, micro>(end - start).count() << " us" << endl;
+}
+
+/**
+ * @brief Intersects two sorted lists of distinct ids.
+ *
+ * @param a The first list.
+ * @param sizeA The size of the first list.
+ * @param b The second list.
+ * @param sizeB The size of the second list.
+ * @param out Where the common ids are written, sorted. It must have room for the shorter list.
+ *
+ * @return The number of common ids.
+ *
+ * @info Lists of similar sizes are merged block by block; when one is at least gallopRatio times longer, the ids of
+ * the shorter one are searched in it instead.
+ *
+ * @complexity Time Complexity: O(min(a + b, a log(b / a))), where a is the size of the shorter list and b of the
+ * longer one.
+ */
+size_t DestinationLists::intersect(const int32_t *a, size_t sizeA, const int32_t *b, size_t sizeB, int32_t *out) {
+    if (sizeA > sizeB) {
+        swap(a, b);
+        swap(sizeA, sizeB);
+    }
+    if (sizeA == 0)
+        return 0;
+    if (sizeB / sizeA >= gallopRatio)
+        return gallop(a, sizeA, b, sizeB, out);
+    return merge(a, sizeA, b, sizeB, out);
+}
+
+/**
+ * @brief Intersects a short sorted list with a much longer one by galloping search.
+ *
+ * @param small The shorter list.
+ * @param sizeSmall The size of the shorter list.
+ * @param large The longer list.
+ * @param sizeLarge The size of the longer list.
+ * @param out Where the common ids are written, sorted.
+ *
+ * @return The number of common ids.
+ *
+ * @info Every id of the shorter list is looked for from where the previous one stopped, doubling the step until it
+ * is passed and then searching binarily in the last step, so the cost depends on the gaps and not on the longer list.
+ *
+ * @complexity Time Complexity: O(s log(l / s)), where s is the size of the shorter list and l of the longer one.
+ */
+size_t DestinationLists::gallop(const int32_t *small, size_t sizeSmall, const int32_t *large, size_t sizeLarge,
+                                int32_t *out) {
+    size_t count = 0, low = 0;
+    for (size_t i = 0; i < sizeSmall && low < sizeLarge; i++) {
+        int32_t id = small[i];
+        if (large[low] < id) {
+            size_t step = 1;
+            while (low + step < sizeLarge && large[low + step] < id)
+                step <<= 1;
+            low = lower_bound(large + low + step / 2, large + min(low + step, sizeLarge), id) - large;
+        }
+        if (low < sizeLarge && large[low] == id)
+            out[count++] = large[low++];
+    }
+    return count;
+}
+
+/**
+ * @brief Intersects two sorted lists of similar sizes.
+ *
+ * @param a The first list.
+ * @param sizeA The size of the first list.
+ * @param b The second list.
+ * @param sizeB The size of the second list.
+ * @param out Where the common ids are written, sorted.
+ *
+ * @return The number of common ids.
+ *
+ * @info Compares a block of 8 (AVX2) or 4 (SSE2) ids of each list against every rotation of the other block, and
+ * then moves past the block that ends first, or both. The ids left over at the end are merged one by one, as is the
+ * whole list on other targets.
+ *
+ * @complexity Time Complexity: O(a + b), where a and b are the sizes of the lists.
+ */
+size_t DestinationLists::merge(const int32_t *a, size_t sizeA, const int32_t *b, size_t sizeB, int32_t *out) {
+    size_t i = 0, j = 0, count = 0;
+#if defined(__AVX2__)
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= sizeA && j + 8 <= sizeB) {
+        __m256i blockA = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i blockB = _mm256_loadu_si256((const __m256i *) (b + j));
+        __m256i match = _mm256_cmpeq_epi32(blockA, blockB);
+        for (int r = 1; r < 8; r++) {
+            blockB = _mm256_permutevar8x32_epi32(blockB, rotate);
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi32(blockA, blockB));
+        }
+        unsigned mask = (unsigned) _mm256_movemask_ps(_mm256_castsi256_ps(match));
+        for (; mask != 0; mask &= mask - 1)
+            out[count++] = a[i + __builtin_ctz(mask)];
+        int32_t lastA = a[i + 7], lastB = b[j + 7];
+        i += lastA <= lastB ? 8 : 0;
+        j += lastB <= lastA ? 8 : 0;
+    }
+#elif defined(__SSE2__)
+    while (i + 4 <= sizeA && j + 4 <= sizeB) {
+        __m128i blockA = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i blockB = _mm_loadu_si128((const __m128i *) (b + j));
+        __m128i match = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(blockA, blockB),
+                             _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2))),
+                             _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(2, 1, 0, 3)))));
+        unsigned mask = (unsigned) _mm_movemask_ps(_mm_castsi128_ps(match));
+        for (; mask != 0; mask &= mask - 1)
+            out[count++] = a[i + __builtin_ctz(mask)];
+        int32_t lastA = a[i + 3], lastB = b[j + 3];
+        i += lastA <= lastB ? 4 : 0;
+        j += lastB <= lastA ? 4 : 0;
+    }
+#endif
+    while (i < sizeA && j < sizeB) {
+        int32_t x = a[i], y = b[j];
+        if (x == y)
+            out[count++] = x;
+        i += x <= y;
+        j += y <= x;
+    }
+    return count;
+}
@@ -0,0 +1,43 @@
+
+#ifndef PROJETO2_DESTINATIONLISTS_H
+#define PROJETO2_DESTINATIONLISTS_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Graph.h"
+#include "GraphSnapshot.h"
+
+class DestinationLists {
+public:
+    void build(const Graph &graph);
+    void build(const GraphSnapshot &snapshot);
+
+    int getNumDestinations(int airport) const;
+    const int32_t *getDestinations(int airport) const;
+    std::vector<int32_t> common(const std::vector<int> &airports) const;
+    void query(const std::vector<std::string> &codes, std::ostream &out) const;
+
+    static size_t intersect(const int32_t *a, size_t sizeA, const int32_t *b, size_t sizeB, int32_t *out);
+
+private:
+    std::vector<int> firstDestination;                  ///< first destination of each airport, then the end
+    std::vector<int32_t> destinations;                  ///< sorted, distinct destination ids of each airport
+    std::vector<std::string> airportCodes;              ///< code of each airport id
+    std::unordered_map<std::string, int> airportIds;    ///< id of each airport code
+
+    void index();
+
+    static const size_t gallopRatio = 32;               ///< size ratio from which the smaller list gallops
+
+    static size_t gallop(const int32_t *small, size_t sizeSmall, const int32_t *large, size_t sizeLarge,
+                         int32_t *out);
+    static size_t merge(const int32_t *a, size_t sizeA, const int32_t *b, size_t sizeB, int32_t *out);
+};
+
+
+#endif //PROJETO2_DESTINATIONLISTS_H
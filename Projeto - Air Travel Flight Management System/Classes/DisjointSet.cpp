@@ -0,0 +1,71 @@
+
+#include "DisjointSet.h"
+#include <utility>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the DisjointSet class.
+ *
+ * @param n The number of elements, each one starting in its own set.
+ *
+ * @complexity Time Complexity: O(n)
+ */
+DisjointSet::DisjointSet(int n) : parent(n), size(n, 1) {
+    for (int i = 0; i < n; i++)
+        parent[i] = i;
+}
+
+/**
+ * @brief Finds the representative of the set that contains an element.
+ *
+ * @param x The element.
+ *
+ * @return The root of the set of x.
+ *
+ * @info Uses path halving, so the trees stay almost flat.
+ *
+ * @complexity Time Complexity: O(α(n)) amortized, where α is the inverse Ackermann function.
+ */
+int DisjointSet::find(int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/**
+ * @brief Merges the sets that contain two elements.
+ *
+ * @param a The first element.
+ * @param b The second element.
+ *
+ * @return True if the sets were merged, false if both elements were already in the same set.
+ *
+ * @complexity Time Complexity: O(α(n)) amortized.
+ */
+bool DisjointSet::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b)
+        return false;
+    if (size[a] < size[b])
+        swap(a, b);
+    parent[b] = a;
+    size[a] += size[b];
+    return true;
+}
+
+/**
+ * @brief Gets the number of elements of the set that contains an element.
+ *
+ * @param x The element.
+ *
+ * @return The size of the set of x.
+ *
+ * @complexity Time Complexity: O(α(n)) amortized.
+ */
+int DisjointSet::getSize(int x) {
+    return size[find(x)];
+}
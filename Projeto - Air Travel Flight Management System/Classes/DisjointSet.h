@@ -0,0 +1,22 @@
+
+#ifndef PROJETO2_DISJOINTSET_H
+#define PROJETO2_DISJOINTSET_H
+
+
+#include <vector>
+
+class DisjointSet {
+public:
+    DisjointSet(int n);
+
+    int find(int x);
+    bool unite(int a, int b);
+    int getSize(int x);
+
+private:
+    std::vector<int> parent;    ///< parent of each element (roots point to themselves)
+    std::vector<int> size;      ///< number of elements of each set, valid for roots only
+};
+
+
+#endif //PROJETO2_DISJOINTSET_H
@@ -0,0 +1,151 @@
+
+#include "DistanceMatrix.h"
+#include "NetworkStatistics.h"
+#include "Parallel.h"
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the DistanceMatrix class. Computes every value of the matrix.
+ *
+ * @param view The network of the matrix.
+ * @param sources The vertex ids of the rows.
+ * @param targets The vertex ids of the columns.
+ * @param metric Whether the values are numbers of flights or flown kilometers.
+ *
+ * @complexity Time Complexity: see computeFlights and computeKilometers.
+ */
+DistanceMatrix::DistanceMatrix(const GraphView &view, const vector<int> &sources, const vector<int> &targets,
+                               MatrixMetric metric)
+        : view(view), sources(sources), targets(targets), metric(metric),
+          values(sources.size() * targets.size(), -1) {
+    if (metric == MatrixMetric::Flights)
+        computeFlights();
+    else
+        computeKilometers();
+}
+
+/**
+ * @brief Fills the matrix with the fewest flights between each source and each target.
+ *
+ * @info Sources are grouped in batches of 64 that share a single bit-parallel BFS, and batches run in parallel, so a
+ * few hundred sources cost a handful of graph traversals instead of one per pair.
+ *
+ * @complexity Time Complexity: O(S / 64 * D * (V + E) / P), where S is the number of sources, D the diameter and P the
+ * number of hardware threads.
+ */
+void DistanceMatrix::computeFlights() {
+    vector<vector<int>> columns(view.getNumVertex());
+    for (int j = 0; j < (int) targets.size(); j++)
+        columns[targets[j]].push_back(j);
+
+    size_t batches = (sources.size() + 63) / 64;
+    parallelFor(batches, [&](size_t batch) {
+        size_t first = batch * 64;
+        vector<int> origins(sources.begin() + first, sources.begin() + min(first + 64, sources.size()));
+        NetworkStatistics::bitParallelBfs(view, origins, [&](int v, int level, uint64_t fresh) {
+            if (columns[v].empty())
+                return;
+            for (; fresh != 0; fresh &= fresh - 1) {
+                size_t row = first + __builtin_ctzll(fresh);
+                for (int column : columns[v])
+                    values[row * targets.size() + column] = (float) level;
+            }
+        });
+    });
+}
+
+/**
+ * @brief Fills the matrix with the smallest flown distance between each source and each target.
+ *
+ * @info One Dijkstra per source, in parallel. Each search stops as soon as every target is settled.
+ *
+ * @complexity Time Complexity: O(S * (V + E) log V / P), where S is the number of sources and P the number of
+ * hardware threads.
+ */
+void DistanceMatrix::computeKilometers() {
+    vector<bool> isTarget(view.getNumVertex(), false);
+    int numTargets = 0;
+    for (int t : targets) {
+        if (!isTarget[t])
+            numTargets++;
+        isTarget[t] = true;
+    }
+
+    parallelFor(sources.size(), [&](size_t row) {
+        vector<double> distance;
+        NetworkStatistics::dijkstra(view, sources[row], distance, &isTarget, numTargets);
+        for (int column = 0; column < (int) targets.size(); column++) {
+            double d = distance[targets[column]];
+            values[row * targets.size() + column] = isinf(d) ? -1.0f : (float) d;
+        }
+    });
+}
+
+/**
+ * @brief Gets a value of the matrix.
+ *
+ * @param row The index of the source.
+ * @param column The index of the target.
+ *
+ * @return The flights or kilometers from the source to the target, or -1 if it is unreachable.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+float DistanceMatrix::get(int row, int column) const {
+    return values[(size_t) row * targets.size() + column];
+}
+
+/**
+ * @brief Writes the matrix as CSV: a header with the target codes, then one row per source.
+ *
+ * @param out The output stream.
+ *
+ * @complexity Time Complexity: O(S * T), where S is the number of sources and T the number of targets.
+ */
+void DistanceMatrix::writeCsv(ostream &out) const {
+    const auto &vertices = view.getGraph().getVertexSet();
+    out << (metric == MatrixMetric::Flights ? "flights" : "km");
+    for (int t : targets)
+        out << ',' << vertices[t]->getInfo();
+    out << '\n';
+    for (int row = 0; row < (int) sources.size(); row++) {
+        out << vertices[sources[row]]->getInfo();
+        for (int column = 0; column < (int) targets.size(); column++)
+            out << ',' << get(row, column);
+        out << '\n';
+    }
+    out.flush();
+}
+
+/**
+ * @brief Writes the matrix in a compact binary format.
+ *
+ * @param out The output stream (opened in binary mode).
+ *
+ * @info Layout: the 8 bytes "FMSMTX1\0", the metric (uint32, 0 = flights, 1 = km), the number of rows and of columns
+ * (uint32 each), every row code and then every column code (uint8 length followed by the characters), and finally the
+ * row-major values as float32 (-1 when unreachable). Integers and floats are written in the byte order of the machine.
+ *
+ * @complexity Time Complexity: O(S * T), where S is the number of sources and T the number of targets.
+ */
+void DistanceMatrix::writeBinary(ostream &out) const {
+    const auto &vertices = view.getGraph().getVertexSet();
+    out.write("FMSMTX1", 8);
+    uint32_t header[3] = {(uint32_t) metric, (uint32_t) sources.size(), (uint32_t) targets.size()};
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    auto writeCode = [&out, &vertices](int v) {
+        string code = vertices[v]->getInfo().substr(0, 255);
+        out.put((char) code.size());
+        out.write(code.data(), code.size());
+    };
+    for (int s : sources)
+        writeCode(s);
+    for (int t : targets)
+        writeCode(t);
+    out.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(float));
+    out.flush();
+}
@@ -0,0 +1,36 @@
+
+#ifndef PROJETO2_DISTANCEMATRIX_H
+#define PROJETO2_DISTANCEMATRIX_H
+
+
+#include <ostream>
+#include <vector>
+#include "GraphView.h"
+
+enum class MatrixMetric {
+    Flights,        ///< fewest flights between two airports
+    Kilometers      ///< smallest flown distance between two airports
+};
+
+class DistanceMatrix {
+public:
+    DistanceMatrix(const GraphView &view, const std::vector<int> &sources, const std::vector<int> &targets,
+                   MatrixMetric metric);
+
+    float get(int row, int column) const;
+    void writeCsv(std::ostream &out) const;
+    void writeBinary(std::ostream &out) const;
+
+private:
+    const GraphView &view;          ///< the network of the matrix
+    std::vector<int> sources;       ///< vertex ids of the rows
+    std::vector<int> targets;       ///< vertex ids of the columns
+    MatrixMetric metric;            ///< what the values measure
+    std::vector<float> values;      ///< row-major values, -1 when the target is unreachable
+
+    void computeFlights();
+    void computeKilometers();
+};
+
+
+#endif //PROJETO2_DISTANCEMATRIX_H
@@ -0,0 +1,90 @@
+
+#ifndef PROJETO2_DURABLEFILE_H
+#define PROJETO2_DURABLEFILE_H
+
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#ifndef _WIN32
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Flushes the directory entry of a file to the disk, so a rename or a creation survives a crash.
+ *
+ * @param filename The path of the file.
+ *
+ * @return True if the directory was synced, or on systems where directories cannot be.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+inline bool syncDirectory(const std::string &filename) {
+#ifndef _WIN32
+    std::size_t slash = filename.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : filename.substr(0, slash);
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#else
+    return true;
+#endif
+}
+
+/**
+ * @brief Writes a file and makes it durable before it replaces the previous version.
+ *
+ * @param filename The path of the file.
+ * @param data The new contents.
+ * @param size The size of the new contents, in bytes.
+ *
+ * @return True if the new contents reached the disk under the final name.
+ *
+ * @info The contents go to a temporary file with a unique name, so processes replacing the same file at the same time
+ * never write into each other's copy; the last rename wins. The temporary file is fsynced before it is renamed over
+ * the old one, and the directory is fsynced after. A crash at any point leaves either the complete old file or the
+ * complete new one.
+ *
+ * @complexity Time Complexity: O(size)
+ */
+inline bool replaceFile(const std::string &filename, const char *data, std::size_t size) {
+#ifndef _WIN32
+    std::string temporary = filename + ".XXXXXX";
+    int fd = mkstemp(&temporary[0]);
+    if (fd < 0)
+        return false;
+    bool written = fchmod(fd, 0644) == 0;
+    for (std::size_t done = 0; written && done < size;) {
+        ssize_t count = write(fd, data + done, size - done);
+        written = count > 0;
+        done += written ? (std::size_t) count : 0;
+    }
+    written = written && fsync(fd) == 0;
+    close(fd);
+    if (!written || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    return syncDirectory(filename);
+#else
+    std::string temporary = filename + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(data, (std::streamsize) size);
+        if (!out)
+            return false;
+    }
+    return std::rename(temporary.c_str(), filename.c_str()) == 0;
+#endif
+}
+
+
+#endif //PROJETO2_DURABLEFILE_H
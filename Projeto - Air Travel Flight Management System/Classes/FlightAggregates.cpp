@@ -0,0 +1,336 @@
+
+#include "FlightAggregates.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Gives dense ids to the cities, countries and airlines of a graph and counts its flights by each of them.
+ *
+ * @param graph The flights graph.
+ * @param airports The airports, by code.
+ *
+ * @info Cities and countries are numbered in alphabetical order, so walking the ids lists them sorted. Every
+ * aggregate is a flat array indexed by those ids (two ids for the combined ones), so a statistic is read without any
+ * string comparison or hashing.
+ *
+ * @complexity Time Complexity: O(V log V + E + A * C + C^2 + Y * C), where V is the number of vertices, E the number of
+ * edges, A the number of airlines, C the number of countries and Y the number of cities.
+ */
+void FlightAggregates::build(const Graph &graph, const unordered_map<string, Airport> &airports) {
+    const vector<Vertex *> &vertices = graph.getVertexSet();
+    cities.clear();
+    countries.clear();
+    for (auto vertex : vertices) {
+        const Airport &airport = airports.find(vertex->getInfo())->second;
+        cities.push_back({airport.getCity(), airport.getCountry()});
+        countries.push_back(airport.getCountry());
+    }
+    sort(cities.begin(), cities.end());
+    cities.erase(unique(cities.begin(), cities.end()), cities.end());
+    sort(countries.begin(), countries.end());
+    countries.erase(unique(countries.begin(), countries.end()), countries.end());
+
+    cityIds.clear();
+    countryIds.clear();
+    for (int id = 0; id < (int) cities.size(); id++)
+        cityIds[cities[id].first + '\n' + cities[id].second] = id;
+    for (int id = 0; id < (int) countries.size(); id++)
+        countryIds[countries[id]] = id;
+    cityOf.assign(vertices.size(), 0);
+    countryOf.assign(vertices.size(), 0);
+    for (auto vertex : vertices) {
+        const Airport &airport = airports.find(vertex->getInfo())->second;
+        cityOf[vertex->getId()] = cityIds[airport.getCity() + '\n' + airport.getCountry()];
+        countryOf[vertex->getId()] = countryIds[airport.getCountry()];
+    }
+
+    size_t C = countries.size();
+    cityFlights.assign(cities.size(), 0);
+    countryFlights.assign(C, 0);
+    countryPairFlights.assign(C * C, 0);
+    cityCountryFlights.assign(cities.size() * C, 0);
+    countriesFromCity.assign(cities.size(), 0);
+    airlineCodes.clear();
+    airlinesByCode.clear();
+    airlineFlights.clear();
+    airlineCountryFlights.clear();
+    for (int airline = 0; airline < graph.getNumAirlines(); airline++)
+        registerAirline(airline, graph.getAirlineCode(airline));
+
+    for (auto vertex : vertices) {
+        for (const auto &edge : vertex->getAdj())
+            count(vertex->getId(), edge.getDest()->getId(), edge.getAirlineId(), 1);
+    }
+}
+
+/**
+ * @brief Gives an airline its row in the aggregates, if it does not have one yet.
+ *
+ * @param airline The id of the airline in the graph. Ids are given in order, so it is at most one past the last.
+ * @param code The code of the airline.
+ *
+ * @complexity Time Complexity: O(A + C), where A is the number of airlines and C the number of countries.
+ */
+void FlightAggregates::registerAirline(int airline, const string &code) {
+    if (airline < (int) airlineCodes.size())
+        return;
+    airlineCodes.push_back(code);
+    airlineFlights.push_back(0);
+    airlineCountryFlights.resize(airlineCodes.size() * countries.size(), 0);
+    auto position = lower_bound(airlinesByCode.begin(), airlinesByCode.end(), airline, [this](int a, int b) {
+        return airlineCodes[a] < airlineCodes[b];
+    });
+    airlinesByCode.insert(position, airline);
+}
+
+/**
+ * @brief Adds a flight (or removes it, with a negative delta) from every aggregate.
+ *
+ * @param source The vertex id of the source airport.
+ * @param target The vertex id of the target airport.
+ * @param airline The id of the airline.
+ * @param delta 1 to add the flight, -1 to remove it.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void FlightAggregates::count(int source, int target, int airline, int delta) {
+    size_t C = countries.size();
+    int city = cityOf[source], origin = countryOf[source], destination = countryOf[target];
+    cityFlights[city] += delta;
+    cityFlights[cityOf[target]] += delta;
+    countryFlights[origin] += delta;
+    countryFlights[destination] += delta;
+    airlineFlights[airline] += delta;
+    airlineCountryFlights[airline * C + origin] += delta;
+    countryPairFlights[origin * C + destination] += delta;
+
+    int &reached = cityCountryFlights[city * C + destination];
+    if (reached == 0 && delta > 0)
+        countriesFromCity[city]++;
+    reached += delta;
+    if (reached == 0 && delta < 0)
+        countriesFromCity[city]--;
+}
+
+/**
+ * @brief Counts a new flight.
+ *
+ * @param source The vertex id of the source airport.
+ * @param target The vertex id of the target airport.
+ * @param airline The id of the airline in the graph.
+ * @param code The code of the airline, used if the airline is new.
+ *
+ * @complexity Time Complexity: O(1), or O(A + C) for a new airline.
+ */
+void FlightAggregates::addFlight(int source, int target, int airline, const string &code) {
+    registerAirline(airline, code);
+    count(source, target, airline, 1);
+}
+
+/**
+ * @brief Uncounts a removed flight.
+ *
+ * @param source The vertex id of the source airport.
+ * @param target The vertex id of the target airport.
+ * @param airline The id of the airline in the graph.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void FlightAggregates::removeFlight(int source, int target, int airline) {
+    count(source, target, airline, -1);
+}
+
+/**
+ * @brief Gets the number of cities.
+ *
+ * @return The number of distinct (city, country) pairs of the airports.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getNumCities() const {
+    return (int) cities.size();
+}
+
+/**
+ * @brief Gets the number of countries.
+ *
+ * @return The number of distinct countries of the airports.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getNumCountries() const {
+    return (int) countries.size();
+}
+
+/**
+ * @brief Finds the id of a city.
+ *
+ * @param city The name of the city.
+ * @param country The country of the city.
+ *
+ * @return The id of the city, or -1 if no airport is there.
+ *
+ * @complexity Time Complexity: O(1) average.
+ */
+int FlightAggregates::findCity(const string &city, const string &country) const {
+    auto it = cityIds.find(city + '\n' + country);
+    return it == cityIds.end() ? -1 : it->second;
+}
+
+/**
+ * @brief Finds the id of a country.
+ *
+ * @param country The name of the country.
+ *
+ * @return The id of the country, or -1 if no airport is there.
+ *
+ * @complexity Time Complexity: O(1) average.
+ */
+int FlightAggregates::findCountry(const string &country) const {
+    auto it = countryIds.find(country);
+    return it == countryIds.end() ? -1 : it->second;
+}
+
+/**
+ * @brief Gets a city.
+ *
+ * @param city The id of the city.
+ *
+ * @return The name of the city and its country.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const pair<string, string> &FlightAggregates::getCity(int city) const {
+    return cities[city];
+}
+
+/**
+ * @brief Gets a country.
+ *
+ * @param country The id of the country.
+ *
+ * @return The name of the country.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const string &FlightAggregates::getCountry(int country) const {
+    return countries[country];
+}
+
+/**
+ * @brief Gets the airlines in alphabetical order of their codes.
+ *
+ * @return The ids of the airlines, sorted by code.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const vector<int> &FlightAggregates::getAirlinesByCode() const {
+    return airlinesByCode;
+}
+
+/**
+ * @brief Gets the city of an airport.
+ *
+ * @param airport The vertex id of the airport.
+ *
+ * @return The id of its city.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getCityOfAirport(int airport) const {
+    return cityOf[airport];
+}
+
+/**
+ * @brief Gets the country of an airport.
+ *
+ * @param airport The vertex id of the airport.
+ *
+ * @return The id of its country.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getCountryOfAirport(int airport) const {
+    return countryOf[airport];
+}
+
+/**
+ * @brief Gets the number of flights in and out of a city.
+ *
+ * @param city The id of the city.
+ *
+ * @return The number of flights.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getCityFlights(int city) const {
+    return cityFlights[city];
+}
+
+/**
+ * @brief Gets the number of flights in and out of a country.
+ *
+ * @param country The id of the country.
+ *
+ * @return The number of flights. Domestic flights count twice, once as they leave and once as they arrive.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getCountryFlights(int country) const {
+    return countryFlights[country];
+}
+
+/**
+ * @brief Gets the number of flights of an airline.
+ *
+ * @param airline The id of the airline.
+ *
+ * @return The number of flights.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getAirlineFlights(int airline) const {
+    return airlineFlights[airline];
+}
+
+/**
+ * @brief Gets the number of flights of an airline leaving a country.
+ *
+ * @param airline The id of the airline.
+ * @param country The id of the country.
+ *
+ * @return The number of flights.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getAirlineCountryFlights(int airline, int country) const {
+    return airlineCountryFlights[airline * countries.size() + country];
+}
+
+/**
+ * @brief Gets the number of flights from a country to another.
+ *
+ * @param origin The id of the origin country.
+ * @param destination The id of the destination country.
+ *
+ * @return The number of flights.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getCountryPairFlights(int origin, int destination) const {
+    return countryPairFlights[origin * countries.size() + destination];
+}
+
+/**
+ * @brief Gets the number of countries reached by a nonstop flight from a city.
+ *
+ * @param city The id of the city.
+ *
+ * @return The number of countries, its own included if it has domestic flights.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightAggregates::getCountriesFromCity(int city) const {
+    return countriesFromCity[city];
+}
@@ -0,0 +1,59 @@
+
+#ifndef PROJETO2_FLIGHTAGGREGATES_H
+#define PROJETO2_FLIGHTAGGREGATES_H
+
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Airport.h"
+#include "Graph.h"
+
+class FlightAggregates {
+public:
+    void build(const Graph &graph, const std::unordered_map<std::string, Airport> &airports);
+    void addFlight(int source, int target, int airline, const std::string &code);
+    void removeFlight(int source, int target, int airline);
+
+    int getNumCities() const;
+    int getNumCountries() const;
+    int findCity(const std::string &city, const std::string &country) const;
+    int findCountry(const std::string &country) const;
+    const std::pair<std::string, std::string> &getCity(int city) const;
+    const std::string &getCountry(int country) const;
+    const std::vector<int> &getAirlinesByCode() const;
+    int getCityOfAirport(int airport) const;
+    int getCountryOfAirport(int airport) const;
+
+    int getCityFlights(int city) const;
+    int getCountryFlights(int country) const;
+    int getAirlineFlights(int airline) const;
+    int getAirlineCountryFlights(int airline, int country) const;
+    int getCountryPairFlights(int origin, int destination) const;
+    int getCountriesFromCity(int city) const;
+
+private:
+    std::vector<std::pair<std::string, std::string>> cities;    ///< (city, country) of each city id, sorted
+    std::vector<std::string> countries;                         ///< name of each country id, sorted
+    std::unordered_map<std::string, int> cityIds;               ///< id of each "city\ncountry"
+    std::unordered_map<std::string, int> countryIds;            ///< id of each country
+    std::vector<int> cityOf;                                    ///< city id of each vertex
+    std::vector<int> countryOf;                                 ///< country id of each vertex
+    std::vector<std::string> airlineCodes;                      ///< code of each airline id of the graph
+    std::vector<int> airlinesByCode;                            ///< airline ids sorted by code
+
+    std::vector<int> cityFlights;               ///< flights in and out of each city
+    std::vector<int> countryFlights;            ///< flights in and out of each country
+    std::vector<int> airlineFlights;            ///< flights of each airline
+    std::vector<int> airlineCountryFlights;     ///< flights of each airline out of each country, airline-major
+    std::vector<int> countryPairFlights;        ///< flights from each country to each country, origin-major
+    std::vector<int> cityCountryFlights;        ///< flights from each city to each country, city-major
+    std::vector<int> countriesFromCity;         ///< countries reached by a nonstop flight from each city
+
+    void count(int source, int target, int airline, int delta);
+    void registerAirline(int airline, const std::string &code);
+};
+
+
+#endif //PROJETO2_FLIGHTAGGREGATES_H
@@ -3,6 +3,8 @@
 #include <set>
 
 #include "FlightManagementSystem.h"
+#include "Parallel.h"
+#include "RouteSimilarity.h"
 #include <climits>
 #include <cfloat>
 
@@ -13,12 +15,124 @@ using namespace std;
  *
  * @param d Data object
  *
- * @complexity Time complexity: O(1)
+ * @info The system can answer queries as soon as this returns. The derived indexes are built by a background thread,
+ * in order of priority, and the queries that use one wait until it is ready.
+ *
+ * @complexity Time complexity: O(V + E), where V is the number of vertices and E the number of edges in the flights
+ * graph.
  */
 FlightManagementSystem::FlightManagementSystem(Data d) {
     airports = d.getAirports();
     airlines = d.getAirlines();
     flights = d.getFlightsGraph();
+
+    vector<promise<void>> ready(5);
+    namesReady = ready[0].get_future().share();
+    spatialReady = ready[1].get_future().share();
+    hubsReady = ready[2].get_future().share();
+    completionsReady = ready[3].get_future().share();
+    routesReady = ready[4].get_future().share();
+    unsigned long long fingerprint = d.getFingerprint(), sequence = d.getScheduleSequence();
+    indexBuilder = thread([this, fingerprint, sequence](vector<promise<void>> promises) {
+        buildIndexes(fingerprint, sequence, promises);
+    }, move(ready));
+}
+
+/**
+ * @brief Destructor. Waits for the background index builder to finish.
+ *
+ * @complexity Time complexity: O(1) once the indexes are built.
+ */
+FlightManagementSystem::~FlightManagementSystem() {
+    if (indexBuilder.joinable())
+        indexBuilder.join();
+}
+
+/**
+ * @brief Builds the derived indexes, most needed first, fulfilling each promise as soon as its index is ready.
+ *
+ * @param fingerprint The fingerprint of the dataset files, used to validate the autocomplete snapshot.
+ * @param sequence The number of schedule changes applied to the dataset, also used to validate the snapshot.
+ * @param ready The promises of the name, spatial, traffic, autocomplete and route indexes, in that order.
+ *
+ * @info Name lookups come first because every name and city based search checks its input against them; then the
+ * airport map behind the coordinate searches, the traffic ranking and flight statistics, the autocomplete trie
+ * (memory-mapped from its snapshot file when it is up to date) and finally the route corridors, the slowest and least
+ * used.
+ *
+ * @complexity Time complexity: O(V log V + E log E), where V is the number of vertices and E the number of edges in the
+ * flights graph.
+ */
+void FlightManagementSystem::buildIndexes(unsigned long long fingerprint, unsigned long long sequence,
+                                          vector<promise<void>> &ready) {
+    for (const auto &airport : airports) {
+        airportNameIndex.add(airport.second.getName());
+        cityIndex.add(airport.second.getCity() + ", " + airport.second.getCountry());
+        countryIndex.add(airport.second.getCountry());
+    }
+    ready[0].set_value();
+
+    vector<SpatialEntry> points;
+    vector<Position> positions;
+    for (auto vertex : flights.getVertexSet()) {
+        Position position = airports.find(vertex->getInfo())->second.getPosition();
+        points.push_back({position.getLatitude(), position.getLongitude(), vertex->getId()});
+        positions.push_back(position);
+    }
+    airportIndex.build(points);
+    ready[1].set_value();
+
+    trafficRanking.build(flights);
+    aggregates.build(flights, airports);
+    flightTable.build(flights, airports);
+    vector<int> cityOf(flights.getNumVertex()), countryOf(flights.getNumVertex());
+    for (int airport = 0; airport < flights.getNumVertex(); airport++) {
+        cityOf[airport] = aggregates.getCityOfAirport(airport);
+        countryOf[airport] = aggregates.getCountryOfAirport(airport);
+    }
+    cityGraph.build(flights, cityOf, aggregates.getNumCities());
+    countryGraph.build(flights, countryOf, aggregates.getNumCountries());
+    countryGraph.buildHops();
+    airportSets.build(flights, airports);
+    destinationLists.build(flights);
+    ready[2].set_value();
+
+    if (!autocomplete.load("autocomplete.snapshot", fingerprint, sequence)) {
+        vector<CompletionEntry> completions;
+        for (auto vertex : flights.getVertexSet()) {
+            const Airport &airport = airports.find(vertex->getInfo())->second;
+            int traffic = vertex->getIndegree() + vertex->getOutdegree();
+            completions.push_back({airport.getCode(), airport.getCode(), traffic, CompletionKind::Code});
+            completions.push_back({airport.getName(), airport.getCode(), traffic, CompletionKind::Name});
+            completions.push_back({airport.getCity(), airport.getCode(), traffic, CompletionKind::City});
+        }
+        autocomplete.build(completions, fingerprint, sequence);
+        autocomplete.save("autocomplete.snapshot");
+    }
+    ready[3].set_value();
+
+    routeIndex.build(flights, positions);
+    ready[4].set_value();
+}
+
+/**
+ * @brief Describes the indexes still being built in the background.
+ *
+ * @return A message such as "Building in the background: map, routes", or an empty string if every index is ready.
+ *
+ * @complexity Time complexity: O(1)
+ */
+string FlightManagementSystem::getLoadingStatus() const {
+    const pair<const shared_future<void> *, const char *> indexes[] = {
+        {&namesReady, "names"}, {&spatialReady, "map"}, {&hubsReady, "statistics"},
+        {&completionsReady, "autocomplete"}, {&routesReady, "routes"}
+    };
+    string pending;
+    for (const auto &index : indexes) {
+        if (index.first->wait_for(chrono::seconds(0)) != future_status::ready)
+            pending += (pending.empty() ? "" : ", ") + string(index.second);
+    }
+    return pending.empty() ? "" : "Building in the background: " + pending;
 }
 
 /**
@@ -86,21 +200,15 @@ int FlightManagementSystem::getNumberOfAirlinesFromAirport(const string &airport
  *
  * @return The number of flights departing from the specified city.
  *
- * @complexity Time Complexity: O(V), where V is the number of vertices in the flights graph.
+ * @info Read from the precomputed aggregates, which list the cities in alphabetical order.
+ *
+ * @complexity Time Complexity: O(Y), where Y is the number of cities.
  */
 void FlightManagementSystem::numberOfFlightsPerCity() const {
-    map<pair<string, string>, int> cityFlights;
-
-    for(auto vertex : flights.getVertexSet()) {
-        string city = airports.find(vertex->getInfo())->second.getCity();
-        string country = airports.find(vertex->getInfo())->second.getCountry();
-        auto pair = make_pair(city, country);
-        int degree = vertex->getOutdegree() + vertex->getIndegree();
-        cityFlights[pair] += degree;
-    }
-
-    for(const auto& pair : cityFlights) {
-        cout << "City: " << pair.first.first << " (" << pair.first.second << ") -- " << pair.second << " flights" << endl;
+    hubsReady.wait();
+    for (int city = 0; city < aggregates.getNumCities(); city++) {
+        const auto &name = aggregates.getCity(city);
+        cout << "City: " << name.first << " (" << name.second << ") -- " << aggregates.getCityFlights(city) << " flights" << endl;
     }
 }
 
@@ -109,21 +217,237 @@ void FlightManagementSystem::numberOfFlightsPerCity() const {
  *
  * @return The number of flights operated by the specified airline.
  *
- * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
+ * @info Read from the precomputed aggregates. Airlines without flights are left out.
+ *
+ * @complexity Time Complexity: O(A), where A is the number of airlines.
  */
 void FlightManagementSystem::numberOfFlightsPerAirline() const {
-    map<string, int> airlineFlights;
+    hubsReady.wait();
+    for (int airline : aggregates.getAirlinesByCode()) {
+        int count = aggregates.getAirlineFlights(airline);
+        if (count == 0)
+            continue;
+        string code = flights.getAirlineCode(airline);
+        cout << "Airline: " << code << " (" << airlines.find(code)->second.getName() << ") -- " << count << " flights" << endl;
+    }
+}
 
-    for(auto vertex : flights.getVertexSet()) {
-        for(auto edge : vertex->getAdj()) {
-            string airline = edge.getAirline();
-            airlineFlights[airline]++;
-        }
+/**
+ * @brief Prints the number of flights in and out of each country.
+ *
+ * @info Domestic flights count once as they leave and once as they arrive, like the flights of a city.
+ *
+ * @complexity Time Complexity: O(C), where C is the number of countries.
+ */
+void FlightManagementSystem::numberOfFlightsPerCountry() const {
+    hubsReady.wait();
+    for (int country = 0; country < aggregates.getNumCountries(); country++)
+        cout << "Country: " << aggregates.getCountry(country) << " -- " << aggregates.getCountryFlights(country) << " flights" << endl;
+}
+
+/**
+ * @brief Prints the number of flights each airline operates out of a country.
+ *
+ * @param country The name of the country.
+ *
+ * @complexity Time Complexity: O(A), where A is the number of airlines.
+ */
+void FlightManagementSystem::numberOfFlightsPerAirlineFromCountry(const string &country) const {
+    hubsReady.wait();
+    int id = aggregates.findCountry(country);
+    if (id == -1) {
+        cout << "Country " << country << " doesn't exist" << endl;
+        return;
+    }
+    for (int airline : aggregates.getAirlinesByCode()) {
+        int count = aggregates.getAirlineCountryFlights(airline, id);
+        if (count == 0)
+            continue;
+        string code = flights.getAirlineCode(airline);
+        cout << "Airline: " << code << " (" << airlines.find(code)->second.getName() << ") -- " << count << " flights" << endl;
     }
+}
 
-    for(const auto& pair : airlineFlights) {
-        cout << "Airline: " << pair.first << " (" << airlines.find(pair.first)->second.getName() << ") -- " << pair.second << " flights" << endl;
+/**
+ * @brief Get the number of flights from a country to another.
+ *
+ * @param origin The name of the origin country.
+ * @param destination The name of the destination country. It may be the origin, for domestic flights.
+ *
+ * @return The number of flights, or 0 if either country has no airports.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightManagementSystem::getNumberOfFlightsBetweenCountries(const string &origin, const string &destination) const {
+    hubsReady.wait();
+    int from = aggregates.findCountry(origin), to = aggregates.findCountry(destination);
+    if (from == -1 || to == -1)
+        return 0;
+    return aggregates.getCountryPairFlights(from, to);
+}
+
+/**
+ * @brief Runs an ad-hoc query over the flights and prints its result.
+ *
+ * @param query The query, such as "avg where origin = Portugal by airline top 5". See FlightTable::parse.
+ *
+ * @complexity Time Complexity: O(P * E + G log G), where P is the number of conditions, E the number of edges and G
+ * the number of groups.
+ */
+void FlightManagementSystem::queryFlights(const string &query) const {
+    hubsReady.wait();
+    flightTable.query(query, cout);
+}
+
+/**
+ * @brief Evaluates a set expression over the airports and prints the result.
+ *
+ * @param expression The expression, such as "reach(OPO, 2) - reach(LIS, 2)". See AirportSets::evaluate.
+ *
+ * @complexity Time Complexity: O(S * (V + E) + W), where S is the number of reach sets in the expression and W the
+ * work of the Roaring bitmap operations.
+ */
+void FlightManagementSystem::queryAirportSets(const string &expression) const {
+    hubsReady.wait();
+    airportSets.query(expression, cout);
+}
+
+/**
+ * @brief Prints the nonstop destinations shared by a group of airports.
+ *
+ * @param airportCodes The codes of the airports, such as two hubs whose common destinations are wanted.
+ *
+ * @info Intersects the sorted destination lists of the airports, built once from their adjacency lists.
+ *
+ * @complexity Time Complexity: O(k log k + k * d + R log R), where k is the number of airports, d the number of
+ * destinations of the one with fewest and R the number of common destinations.
+ */
+void FlightManagementSystem::commonDestinations(const vector<string> &airportCodes) const {
+    hubsReady.wait();
+    destinationLists.query(airportCodes, cout);
+}
+
+/**
+ * @brief Prints the fewest flights between two cities, changing airports within a city if needed.
+ *
+ * @param sourceCity The name of the source city.
+ * @param sourceCountry The name of the source country.
+ * @param destinationCity The name of the destination city.
+ * @param destinationCountry The name of the destination country.
+ *
+ * @info Runs on the city graph, so the result is a lower bound on the flights of any airport-level trip.
+ *
+ * @complexity Time Complexity: O(Y + Q), where Y is the number of cities and Q the number of edges between them.
+ */
+void FlightManagementSystem::cityHopDistance(const string &sourceCity, const string &sourceCountry,
+                                             const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(sourceCity, sourceCountry) || !checkCity(destinationCity, destinationCountry))
+        return;
+    hubsReady.wait();
+    int source = aggregates.findCity(sourceCity, sourceCountry);
+    int destination = aggregates.findCity(destinationCity, destinationCountry);
+    int hops = cityGraph.getHops(source, destination);
+    cout << sourceCity << " (" << sourceCountry << ") -> " << destinationCity << " (" << destinationCountry << "): ";
+    if (hops < 0)
+        cout << "not reachable" << endl;
+    else
+        cout << "at least " << hops << " flights" << endl;
+}
+
+/**
+ * @brief Prints the fewest border crossings between two countries and the direct connection, if any.
+ *
+ * @param origin The name of the origin country.
+ * @param destination The name of the destination country.
+ *
+ * @complexity Time Complexity: O(log Q), where Q is the number of edges out of the origin in the country graph.
+ */
+void FlightManagementSystem::countryHopDistance(const string &origin, const string &destination) const {
+    hubsReady.wait();
+    int from = aggregates.findCountry(origin), to = aggregates.findCountry(destination);
+    for (const auto &country : {make_pair(from, origin), make_pair(to, destination)}) {
+        if (country.first == -1) {
+            cout << "Country " << country.second << " doesn't exist" << endl;
+            return;
+        }
+    }
+    int hops = countryGraph.getHops(from, to);
+    cout << origin << " -> " << destination << ": ";
+    if (hops < 0) {
+        cout << "not reachable" << endl;
+        return;
     }
+    cout << hops << " border crossings" << endl;
+    int first = countryGraph.getFirstEdge(from), last = countryGraph.getLastEdge(from);
+    int edge = first;
+    while (edge < last && countryGraph.getEdgeTarget(edge) < to)
+        edge++;
+    if (edge < last && countryGraph.getEdgeTarget(edge) == to)
+        cout << "Direct: " << countryGraph.getEdgeFlights(edge) << " flights by "
+             << countryGraph.getEdgeNumAirlines(edge) << " airlines" << endl;
+}
+
+/**
+ * @brief Prints the countries reachable from a country with at most k border crossings, nearest first.
+ *
+ * @param country The name of the country.
+ * @param k The maximum number of border crossings.
+ *
+ * @complexity Time Complexity: O(C log C), where C is the number of countries.
+ */
+void FlightManagementSystem::countriesWithinBorderCrossings(const string &country, int k) const {
+    hubsReady.wait();
+    int source = aggregates.findCountry(country);
+    if (source == -1) {
+        cout << "Country " << country << " doesn't exist" << endl;
+        return;
+    }
+    vector<pair<int, string>> reached;
+    for (int other = 0; other < countryGraph.getNumRegions(); other++) {
+        int hops = countryGraph.getHops(source, other);
+        if (other != source && hops >= 0 && hops <= k)
+            reached.push_back({hops, aggregates.getCountry(other)});
+    }
+    sort(reached.begin(), reached.end());
+    for (const auto &other : reached)
+        cout << other.first << " -- " << other.second << endl;
+    cout << "Number of countries within " << k << " border crossings of " << country << ": " << reached.size() << endl;
+}
+
+/**
+ * @brief Prints the pairs of airlines whose route sets overlap the most.
+ *
+ * @param threshold The minimum Jaccard similarity (0 to 1) between the (source, target) route sets of two airlines.
+ *
+ * @info Candidate pairs come from MinHash signatures with LSH banding sized for the threshold and are then verified
+ * with the exact Jaccard similarity, so only a small fraction of the airline pairs is ever intersected. Thresholds
+ * too low for banding verify every pair.
+ *
+ * @complexity Time Complexity: O(E * H + C * R), where E is the number of edges, H the length of the signatures, C the
+ * number of candidate pairs and R the number of routes of an airline.
+ */
+void FlightManagementSystem::airlineRouteOverlap(double threshold) const {
+    RouteSimilarity similarity(flights);
+    int candidates;
+    auto overlaps = similarity.findOverlaps(threshold, candidates);
+
+    auto name = [this](const string &code) {
+        auto it = airlines.find(code);
+        return it == airlines.end() ? string() : it->second.getName();
+    };
+    for (const auto &overlap : overlaps) {
+        string a = flights.getAirlineCode(overlap.first);
+        string b = flights.getAirlineCode(overlap.second);
+        cout << a << " (" << name(a) << ") & " << b << " (" << name(b) << ") -- Jaccard " << overlap.jaccard
+             << " (estimated " << overlap.estimate << "), " << overlap.sharedRoutes << " shared routes of "
+             << similarity.getNumberOfRoutes(overlap.first) << "/" << similarity.getNumberOfRoutes(overlap.second) << endl;
+    }
+    int rows = similarity.chooseRows(threshold);
+    cout << overlaps.size() << " pairs above " << threshold << " (" << candidates << " candidate pairs verified, ";
+    if (rows == 0)
+        cout << "exact scan of all pairs)" << endl;
+    else
+        cout << similarity.getNumHashes() / rows << " LSH bands of " << rows << " rows)" << endl;
 }
 
 /**
@@ -152,18 +476,12 @@ int FlightManagementSystem::getNumberOfCountriesFromAirport(const string &airpor
  *
  * @return The number of unique countries connected to the specified city.
  *
- * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
+ * @complexity Time Complexity: O(1)
  */
 int FlightManagementSystem::getNumberOfCountriesFromCity(const string &city, const string &country) const {
-    set<string> countries;
-    for(auto vertex : flights.getVertexSet()){
-        if(airports.find(vertex->getInfo())->second.getCity() == city && airports.find(vertex->getInfo())->second.getCountry() == country){
-            for (const auto& edge : vertex->getAdj()) {
-                countries.insert(airports.find(edge.getDest()->getInfo())->second.getCountry());
-            }
-        }
-    }
-    return (int) countries.size();
+    hubsReady.wait();
+    int id = aggregates.findCity(city, country);
+    return id == -1 ? 0 : aggregates.getCountriesFromCity(id);
 }
 
 /**
@@ -257,90 +575,50 @@ void FlightManagementSystem::numberOfReachableDestinationsFromAirportWithStops(c
     cout << "Number of reachable countries: " << countries.size() - (int) flagCountry << endl;
 }
 
-void FlightManagementSystem::getMaxTripWithStops() {
-    int maxStops = 0;
-    vector<pair<string, string>> maxTripAirports;
-
-    for (auto sourceVertex : flights.getVertexSet()) {
-        vector<pair<string,string>> aux;
-        int stops = calcStopsBFS(sourceVertex, aux);
-        if (stops > maxStops) {
-            maxStops = stops;
-            maxTripAirports = aux;
-        }
-        else if (stops == maxStops) {
-            maxTripAirports.insert(maxTripAirports.end(), aux.begin(), aux.end());
-        }
-    }
+/**
+ * @brief Prints the pairs of airports whose shortest trip has the most flights.
+ *
+ * @info Uses the bit-parallel BFS of NetworkStatistics over an unfiltered view, the same kernels as the network
+ * statistics report.
+ *
+ * @complexity Time Complexity: O(V / 64 * D * (V + E) / P), where V is the number of vertices, E the number of edges,
+ * D the diameter and P the number of hardware threads.
+ */
+void FlightManagementSystem::getMaxTripWithStops() const {
+    GraphView view(flights);
+    vector<int> degree;
+    vector<pair<int, int>> trips;
+    int maxStops = NetworkStatistics::longestTrips(view, NetworkStatistics::servedAirports(view, degree), trips);
 
+    const auto &vertices = flights.getVertexSet();
     cout << "Maximum Trips have " << maxStops << " stops: " << endl;
-    for (const auto& a : maxTripAirports) {
-        cout << a.first << " (" << airports.find(a.first)->second.getName() << ") --> "
-        << a.second << " (" << airports.find(a.second)->second.getName() << ")" << endl;
-    }
-}
-
-int FlightManagementSystem::calcStopsBFS(Vertex* source, vector<pair<string,string>> &aux) {
-    int maxdistance = 0;
-
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setVisited(false);
-        vertex->setProcessing(false);
-    }
-
-    queue<pair<Vertex*, int>> q;
-    q.push({source, 0});
-    source->setProcessing(true);
-
-    unordered_set<string> visited;
-    visited.insert(source->getInfo());
-
-    while (!q.empty()) {
-        auto current = q.front().first;
-
-        if (q.front().second > maxdistance) {
-            maxdistance = q.front().second;
-            aux = {{source->getInfo(), current->getInfo()}};
-        } else if (q.front().second == maxdistance) {
-            aux.push_back({source->getInfo(), current->getInfo()});
-        }
-
-        for (const Edge& edge : current->getAdj()) {
-            auto w = edge.getDest();
-            if (visited.find(w->getInfo()) == visited.end()) {
-                q.push({w, q.front().second + 1});
-                w->setProcessing(true);
-
-                visited.insert(w->getInfo());
-            }
-        }
-
-        q.pop();
-        current->setVisited(true);
-        current->setProcessing(false);
+    for (const auto &trip : trips) {
+        const string &source = vertices[trip.first]->getInfo();
+        const string &target = vertices[trip.second]->getInfo();
+        cout << source << " (" << airports.find(source)->second.getName() << ") --> "
+        << target << " (" << airports.find(target)->second.getName() << ")" << endl;
     }
-
-    return maxdistance;
 }
 
 /**
  * @brief Get the top k airports with most traffic.
  *
  * @param k The number of airports to return.
+ * @param metric What traffic is measured by: flights in and out, distinct destinations, distinct airlines or km flown.
  *
- * @return A vector containing the top k airports with most traffic.
+ * @info Prints the top k airports with most traffic, each one with its score.
  *
- * @complexity Time Complexity: O(V log V), where V is the number of vertices in the flights graph.
+ * @complexity Time Complexity: O(k), once the traffic ranking is built.
  */
-void FlightManagementSystem::getTopAirportWithMostTraffic(int k) const {
-    vector<Vertex*> res = flights.getVertexSet();
-    sort(res.begin(), res.end(), [](Vertex* a, Vertex* b) {
-        return (a->getIndegree() + a->getOutdegree()) > (b->getIndegree() + b->getOutdegree());
-    });
-
+void FlightManagementSystem::getTopAirportWithMostTraffic(int k, TrafficMetric metric) const {
+    hubsReady.wait();
     if (k <= 0 || k > flights.getVertexSet().size()) return;
-    for (int i = 0; i < k; i++){
-        cout << i+1 << " -> " << res[i]->getInfo() << " -- " << airports.find(res[i]->getInfo())->second.getName() << endl;
+
+    vector<pair<int, double>> res = trafficRanking.top(metric, k);
+    for (int i = 0; i < (int) res.size(); i++){
+        const string &code = flights.getVertexSet()[res[i].first]->getInfo();
+        cout << i+1 << " -> " << code << " -- " << airports.find(code)->second.getName() << " ("
+             << llround(res[i].second) << " " << TrafficRanking::getMetricName(metric) << ")" << endl;
     }
 }
 
@@ -349,10 +627,18 @@ void FlightManagementSystem::getTopAirportWithMostTraffic(int k) const {
  *
  * @return A set containing the essential airports.
  *
- * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
+ * @info The articulation points of the flights graph ignoring the direction of the flights, found by the iterative
+ * Tarjan search of NetworkStatistics, the same kernel as the network statistics report.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 unordered_set<string> FlightManagementSystem::getEssentialAirports() const {
-    return flights.articulationPoints();
+    GraphView view(flights);
+    vector<int> degree;
+    unordered_set<string> res;
+    for (int v : NetworkStatistics::articulationPoints(view, NetworkStatistics::servedAirports(view, degree)))
+        res.insert(flights.getVertexSet()[v]->getInfo());
+    return res;
 }
 
 
@@ -376,10 +662,14 @@ void FlightManagementSystem::printRoute(const Route& route) const {
  *
  * @return A vector containing the best flight option between the two airports.
  *
+ * @info Airports in countries the country graph cannot connect are answered without searching the flights graph.
+ *
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 vector<vector<Route>> FlightManagementSystem::findBestFlightOptions(const string &source, const string &destination) const {
     vector<vector<Route>> paths;
+    if (!mayConnect(source, destination, nullptr))
+        return paths;
     auto shortestPaths = flights.shortestPathsBFS(source, destination);
 
     for (const auto& path : shortestPaths) {
@@ -430,11 +720,13 @@ void FlightManagementSystem::findBestFlightOptionsByAirportName(const string &so
 
     if (!flagSource) {
         cout << "Airport " << source << " doesn't exist" << endl;
+        suggestAirportNames(source);
         return;
     }
 
     if (!flagDestination) {
         cout << "Airport " << destination << " doesn't exist" << endl;
+        suggestAirportNames(destination);
         return;
     }
 
@@ -450,6 +742,9 @@ void FlightManagementSystem::findBestFlightOptionsByAirportName(const string &so
 }
 
 void FlightManagementSystem::findBestFlightOptionsByAirportCodeToCityName(const string &source, const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> destinationCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == destinationCity && airports.find(vertex->getInfo())->second.getCountry() == destinationCountry){
@@ -474,6 +769,9 @@ void FlightManagementSystem::findBestFlightOptionsByAirportCodeToCityName(const
 }
 
 void FlightManagementSystem::findBestFlightOptionsByAirportNameToCityName(const string &sourceName, const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     string sourceCode;
     bool flagSource = false;
 
@@ -487,6 +785,7 @@ void FlightManagementSystem::findBestFlightOptionsByAirportNameToCityName(const
 
     if (!flagSource) {
         cout << "Airport " << sourceName << " doesn't exist" << endl;
+        suggestAirportNames(sourceName);
         return;
     }
 
@@ -495,21 +794,7 @@ void FlightManagementSystem::findBestFlightOptionsByAirportNameToCityName(const
 
 void FlightManagementSystem::findBestFlightOptionsByAirportCodeToCoordinates(const string &source, double latitude, double longitude) const {
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> min;
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            min.clear();
-            min.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            min.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> min = getClosestAirports(position);
     int option = 1;
     for (const auto& airport : min){
         cout << "Option " << option << ": " << endl;
@@ -541,6 +826,7 @@ void FlightManagementSystem::findBestFlightOptionsByAirportNameToCoordinates(con
 
     if (!flagSource) {
         cout << "Airport " << sourceName << " doesn't exist" << endl;
+        suggestAirportNames(sourceName);
         return;
     }
 
@@ -560,6 +846,11 @@ void FlightManagementSystem::findBestFlightOptionsByAirportNameToCoordinates(con
  * @complexity Time Complexity: O(V² + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 void FlightManagementSystem::findBestFlightOptionsByCity(const string &sourceCity, const string &sourceCountry, const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> sourceCodes;
     vector<string> destinationCodes;
     for(auto vertex : flights.getVertexSet()){
@@ -590,6 +881,9 @@ void FlightManagementSystem::findBestFlightOptionsByCity(const string &sourceCit
 }
 
 void FlightManagementSystem::findBestFlightOptionsByCityToAirportCode(const string &sourceCity, const string &sourceCountry, const string &destinationCode) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == sourceCity && airports.find(vertex->getInfo())->second.getCountry() == sourceCountry){
@@ -614,6 +908,9 @@ void FlightManagementSystem::findBestFlightOptionsByCityToAirportCode(const stri
 }
 
 void FlightManagementSystem::findBestFlightOptionsByCityToAirportName(const string &sourceCity, const string &sourceCountry, const string &destinationName) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     string destinationCode;
     bool flagDestination = false;
@@ -630,6 +927,7 @@ void FlightManagementSystem::findBestFlightOptionsByCityToAirportName(const stri
 
     if (!flagDestination) {
         cout << "Airport " << destinationName << " doesn't exist" << endl;
+        suggestAirportNames(destinationName);
         return;
     }
 
@@ -637,6 +935,9 @@ void FlightManagementSystem::findBestFlightOptionsByCityToAirportName(const stri
 }
 
 void FlightManagementSystem::findBestFlightOptionsByCityToCoordinates(const string &sourceCity, const string &sourceCountry, double latitude, double longitude) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == sourceCity && airports.find(vertex->getInfo())->second.getCountry() == sourceCountry){
@@ -654,7 +955,7 @@ void FlightManagementSystem::findBestFlightOptionsByCityToCoordinates(const stri
 /**
  * @brief Find the best flight options from the nearest airport (in terms of haversine distance) to the given coordinates to the specified destination.
  *
- * This function calculates the haversine distance from the given coordinates to each airport's coordinates in the system,
+ * This function looks up the airports nearest to the given coordinates in the spatial index of the airports,
  * selects the nearest airport, and then finds the best flight options from that airport to the specified destination.
  *
  * @param latitude The latitude of the target coordinates.
@@ -667,21 +968,7 @@ void FlightManagementSystem::findBestFlightOptionsByCityToCoordinates(const stri
  */
 void FlightManagementSystem::findBestFlightOptionsByCoordinates(double latitude, double longitude, const string &destination) const {
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> min;
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            min.clear();
-            min.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            min.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> min = getClosestAirports(position);
     bool flag=false;
     if(airports.find(destination) == airports.end()){
         flag = true;
@@ -722,6 +1009,7 @@ void FlightManagementSystem::findBestFlightOptionsByCoordinatesToAirportName(dou
 
     if (!flagDestination) {
         cout << "Airport " << destinationName << " doesn't exist" << endl;
+        suggestAirportNames(destinationName);
         return;
     }
 
@@ -729,24 +1017,14 @@ void FlightManagementSystem::findBestFlightOptionsByCoordinatesToAirportName(dou
 }
 
 void FlightManagementSystem::findBestFlightOptionsByCoordinatesToCity(double latitude, double longitude, const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> sourceCodes;
     vector<string> destinationCodes;
 
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            sourceCodes.clear();
-            sourceCodes.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            sourceCodes.push_back(vertex->getInfo());
-        }
-    }
+    sourceCodes = getClosestAirports(position);
 
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == destinationCity && airports.find(vertex->getInfo())->second.getCountry() == destinationCountry){
@@ -775,38 +1053,10 @@ void FlightManagementSystem::findBestFlightOptionsByCoordinatesToCity(double lat
 
 void FlightManagementSystem::findBestFlightOptionsByCoordinatesToCoordinates(double sourceLatitude, double sourceLongitude, double destinationLatitude, double destinationLongitude) const {
     Position sourcePosition = Position(sourceLatitude, sourceLongitude);
-    int minSourceDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)sourcePosition.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> minSource;
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minSourceDistance){
-            minSourceDistance = vertex->getNum();
-            minSource.clear();
-            minSource.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minSourceDistance){
-            minSource.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> minSource = getClosestAirports(sourcePosition);
 
     Position destinationPosition = Position(destinationLatitude, destinationLongitude);
-    int minDestinationDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)destinationPosition.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> minDestination;
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDestinationDistance){
-            minDestinationDistance = vertex->getNum();
-            minDestination.clear();
-            minDestination.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDestinationDistance){
-            minDestination.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> minDestination = getClosestAirports(destinationPosition);
 
     int option = 1;
     for (const auto& source : minSource){
@@ -840,10 +1090,15 @@ void FlightManagementSystem::findBestFlightOptionsByCoordinatesToCoordinates(dou
  *
  * @return A vector of vectors of Route objects representing the best flight options from the source to the destination.
  *
+ * @info Pairs whose countries cannot be connected by the selected airlines, as seen on the country graph, are answered
+ * without searching the flights graph.
+ *
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 vector<vector<Route>> FlightManagementSystem::findBestFlightOptions(const string &source, const string &destination, const vector<string> &selectedAirlines) const {
     vector<vector<Route>> paths;
+    if (!mayConnect(source, destination, &selectedAirlines))
+        return paths;
     auto shortestPaths = flights.shortestPathsBFS(source, destination,selectedAirlines);
 
     for (const auto& path : shortestPaths) {
@@ -897,11 +1152,13 @@ void FlightManagementSystem::findBestFlightOptionsByAirportName(const string &so
 
     if (!flagSource) {
         cout << "Airport " << source << " doesn't exist" << endl;
+        suggestAirportNames(source);
         return;
     }
 
     if (!flagDestination) {
         cout << "Airport " << destination << " doesn't exist" << endl;
+        suggestAirportNames(destination);
         return;
     }
 
@@ -929,6 +1186,9 @@ void FlightManagementSystem::findBestFlightOptionsByAirportName(const string &so
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 void FlightManagementSystem::findBestFlightOptionsByAirportCodeToCityName(const string &source, const string &destinationCity, const string &destinationCountry, const vector<string> &selectedAirlines) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> destinationCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == destinationCity && airports.find(vertex->getInfo())->second.getCountry() == destinationCountry){
@@ -966,6 +1226,9 @@ void FlightManagementSystem::findBestFlightOptionsByAirportCodeToCityName(const
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 void FlightManagementSystem::findBestFlightOptionsByAirportNameToCityName(const string &sourceName, const string &destinationCity, const string &destinationCountry,const vector<string> &selectedAirlines) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     string sourceCode;
     bool flagSource = false;
 
@@ -979,6 +1242,7 @@ void FlightManagementSystem::findBestFlightOptionsByAirportNameToCityName(const
 
     if (!flagSource) {
         cout << "Airport " << sourceName << " doesn't exist" << endl;
+        suggestAirportNames(sourceName);
         return;
     }
 
@@ -1000,21 +1264,7 @@ void FlightManagementSystem::findBestFlightOptionsByAirportNameToCityName(const
  */
 void FlightManagementSystem::findBestFlightOptionsByAirportCodeToCoordinates(const string &source, double latitude, double longitude,const vector<string> &selectedAirlines) const {
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> min;
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            min.clear();
-            min.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            min.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> min = getClosestAirports(position);
     int option = 1;
     for (const auto& airport : min){
         cout << "Option " << option << ": " << endl;
@@ -1059,6 +1309,7 @@ void FlightManagementSystem::findBestFlightOptionsByAirportNameToCoordinates(con
 
     if (!flagSource) {
         cout << "Airport " << sourceName << " doesn't exist" << endl;
+        suggestAirportNames(sourceName);
         return;
     }
 
@@ -1080,6 +1331,11 @@ void FlightManagementSystem::findBestFlightOptionsByAirportNameToCoordinates(con
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 void FlightManagementSystem::findBestFlightOptionsByCity(const string &sourceCity, const string &sourceCountry, const string &destinationCity, const string &destinationCountry,const vector<string> &selectedAirlines) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> sourceCodes;
     vector<string> destinationCodes;
     for(auto vertex : flights.getVertexSet()){
@@ -1124,6 +1380,9 @@ void FlightManagementSystem::findBestFlightOptionsByCity(const string &sourceCit
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 void FlightManagementSystem::findBestFlightOptionsByCityToAirportCode(const string &sourceCity, const string &sourceCountry, const string &destinationCode,const vector<string> &selectedAirlines) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == sourceCity && airports.find(vertex->getInfo())->second.getCountry() == sourceCountry){
@@ -1164,6 +1423,9 @@ void FlightManagementSystem::findBestFlightOptionsByCityToAirportCode(const stri
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 void FlightManagementSystem::findBestFlightOptionsByCityToAirportName(const string &sourceCity, const string &sourceCountry, const string &destinationName,const vector<string> &selectedAirlines) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     string destinationCode;
     bool flagDestination = false;
@@ -1180,6 +1442,7 @@ void FlightManagementSystem::findBestFlightOptionsByCityToAirportName(const stri
 
     if (!flagDestination) {
         cout << "Airport " << destinationName << " doesn't exist" << endl;
+        suggestAirportNames(destinationName);
         return;
     }
 
@@ -1201,6 +1464,9 @@ void FlightManagementSystem::findBestFlightOptionsByCityToAirportName(const stri
  * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the flights graph.
  */
 void FlightManagementSystem::findBestFlightOptionsByCityToCoordinates(const string &sourceCity, const string &sourceCountry, double latitude, double longitude,const vector<string> &selectedAirlines) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == sourceCity && airports.find(vertex->getInfo())->second.getCountry() == sourceCountry){
@@ -1227,21 +1493,7 @@ void FlightManagementSystem::findBestFlightOptionsByCityToCoordinates(const stri
  */
 void FlightManagementSystem::findBestFlightOptionsByCoordinates(double latitude, double longitude, const string &destination, const vector<string> &selectedAirlines) const {
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> min;
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            min.clear();
-            min.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            min.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> min = getClosestAirports(position);
     bool flag=false;
     if(airports.find(destination) == airports.end()){
         flag = true;
@@ -1295,6 +1547,7 @@ void FlightManagementSystem::findBestFlightOptionsByCoordinatesToAirportName(dou
 
     if (!flagDestination) {
         cout << "Airport " << destinationName << " doesn't exist" << endl;
+        suggestAirportNames(destinationName);
         return;
     }
 
@@ -1304,7 +1557,7 @@ void FlightManagementSystem::findBestFlightOptionsByCoordinatesToAirportName(dou
 /**
  * @brief Find the best flight options from the nearest airport (in terms of haversine distance) to the given coordinates to the specified destination.
  *
- * This function calculates the haversine distance from the given coordinates to each airport's coordinates in the system,
+ * This function looks up the airports nearest to the given coordinates in the spatial index of the airports,
  * selects the nearest airport, and then finds the best flight options from that airport to the specified destination.
  *
  * @param latitude The latitude of the target coordinates.
@@ -1318,24 +1571,14 @@ void FlightManagementSystem::findBestFlightOptionsByCoordinatesToAirportName(dou
  * @complexity Time Complexity: O(V), where V is the number of vertices in the flights graph.
  */
 void FlightManagementSystem::findBestFlightOptionsByCoordinatesToCity(double latitude, double longitude, const string &destinationCity, const string &destinationCountry, const vector<string> &selectedAirlines) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> sourceCodes;
     vector<string> destinationCodes;
 
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            sourceCodes.clear();
-            sourceCodes.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            sourceCodes.push_back(vertex->getInfo());
-        }
-    }
+    sourceCodes = getClosestAirports(position);
 
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == destinationCity && airports.find(vertex->getInfo())->second.getCountry() == destinationCountry){
@@ -1378,37 +1621,10 @@ void FlightManagementSystem::findBestFlightOptionsByCoordinatesToCity(double lat
  */
 void FlightManagementSystem::findBestFlightOptionsByCoordinatesToCoordinates(double sourceLatitude, double sourceLongitude, double destinationLatitude, double destinationLongitude, const vector<string> &selectedAirlines) const {
     Position sourcePosition = Position(sourceLatitude, sourceLongitude);
-    int minSourceDistance = INT_MAX;
-    for (auto vertex: flights.getVertexSet()) {
-        vertex->setNum((int) sourcePosition.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> minSource;
-    for (auto vertex: flights.getVertexSet()) {
-        if (vertex->getNum() < minSourceDistance) {
-            minSourceDistance = vertex->getNum();
-            minSource.clear();
-            minSource.push_back(vertex->getInfo());
-        } else if (vertex->getNum() == minSourceDistance) {
-            minSource.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> minSource = getClosestAirports(sourcePosition);
 
     Position destinationPosition = Position(destinationLatitude, destinationLongitude);
-    int minDestinationDistance = INT_MAX;
-    for (auto vertex: flights.getVertexSet()) {
-        vertex->setNum(
-                (int) destinationPosition.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> minDestination;
-    for (auto vertex: flights.getVertexSet()) {
-        if (vertex->getNum() < minDestinationDistance) {
-            minDestinationDistance = vertex->getNum();
-            minDestination.clear();
-            minDestination.push_back(vertex->getInfo());
-        } else if (vertex->getNum() == minDestinationDistance) {
-            minDestination.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> minDestination = getClosestAirports(destinationPosition);
 
     int option = 1;
     for (const auto &source: minSource) {
@@ -1528,11 +1744,13 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportNam
 
     if (!flagSource) {
         cout << "Airport " << sourceName << " doesn't exist" << endl;
+        suggestAirportNames(sourceName);
         return;
     }
 
     if (!flagDestination) {
         cout << "Airport " << destinationName << " doesn't exist" << endl;
+        suggestAirportNames(destinationName);
         return;
     }
 
@@ -1559,6 +1777,9 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportNam
  * @complexity Time Complexity: Depends on findBestFlightOptionsWithFewestAirlines function, which is O(V + E).
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportCodeToCity(const string &sourceCode, const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> destinationCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == destinationCity && airports.find(vertex->getInfo())->second.getCountry() == destinationCountry){
@@ -1594,6 +1815,9 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportCod
  * @complexity Time Complexity: Depends on findBestFlightOptionsWithFewestAirlines function, which is O(V + E).
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportNameToCity(const string &sourceName, const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     string sourceCode;
     bool flagSource = false;
 
@@ -1607,6 +1831,7 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportNam
 
     if (!flagSource) {
         cout << "Airport " << sourceName << " doesn't exist" << endl;
+        suggestAirportNames(sourceName);
         return;
     }
 
@@ -1626,21 +1851,7 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportNam
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportCodeToCoordinates(const string &source, double latitude, double longitude) const {
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> min;
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            min.clear();
-            min.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            min.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> min = getClosestAirports(position);
     int option = 1;
     for (const auto& airport : min){
         cout << "Option " << option << ": " << endl;
@@ -1683,6 +1894,7 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportNam
 
     if (!flagSource) {
         cout << "Airport " << sourceName << " doesn't exist" << endl;
+        suggestAirportNames(sourceName);
         return;
     }
 
@@ -1702,6 +1914,11 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByAirportNam
  * @complexity Time Complexity: Depends on findBestFlightOptionsWithFewestAirlines function, which is O(V + E).
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCity(const string &sourceCity, const string &sourceCountry, const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> sourceCodes;
     vector<string> destinationCodes;
     for(auto vertex : flights.getVertexSet()){
@@ -1743,6 +1960,9 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCity(const
  * @complexity Time Complexity: Depends on findBestFlightOptionsWithFewestAirlines function, which is O(V + E).
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCityToAirportCode(const string &sourceCity, const string &sourceCountry, const string &destinationCode) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == sourceCity && airports.find(vertex->getInfo())->second.getCountry() == sourceCountry){
@@ -1778,6 +1998,9 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCityToAirp
  * @complexity Time Complexity: Depends on findBestFlightOptionsWithFewestAirlines function, which is O(V + E).
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCityToAirportName(const string &sourceCity, const string &sourceCountry, const string &destinationName) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     string destinationCode;
     bool flagDestination = false;
@@ -1794,6 +2017,7 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCityToAirp
 
     if (!flagDestination) {
         cout << "Airport " << destinationName << " doesn't exist" << endl;
+        suggestAirportNames(destinationName);
         return;
     }
 
@@ -1827,6 +2051,9 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCityToAirp
  * @complexity Time Complexity: Depends on findBestFlightOptionsWithFewestAirlinesByAirportCodeToCoordinates function, which is O(V + E).
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCityToCoordinates(const string &sourceCity, const string &sourceCountry, double latitude, double longitude) const {
+    if (!checkCity(sourceCity, sourceCountry))
+        return;
+
     vector<string> sourceCodes;
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == sourceCity && airports.find(vertex->getInfo())->second.getCountry() == sourceCountry){
@@ -1851,21 +2078,7 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCityToCoor
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCoordinatesToAirportCode(double latitude, double longitude, const string &destination) const {
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> min;
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            min.clear();
-            min.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            min.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> min = getClosestAirports(position);
     bool flag=false;
     if(airports.find(destination) == airports.end()){
         flag = true;
@@ -1916,6 +2129,7 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCoordinate
 
     if (!flagDestination) {
         cout << "Airport " << destinationName << " doesn't exist" << endl;
+        suggestAirportNames(destinationName);
         return;
     }
 
@@ -1936,24 +2150,14 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCoordinate
  */
 
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCoordinatesToCity(double latitude, double longitude, const string &destinationCity, const string &destinationCountry) const {
+    if (!checkCity(destinationCity, destinationCountry))
+        return;
+
     vector<string> sourceCodes;
     vector<string> destinationCodes;
 
     Position position = Position(latitude, longitude);
-    int minDistance = INT_MAX;
-    for (auto vertex : flights.getVertexSet()) {
-        vertex->setNum((int)position.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    for (auto vertex : flights.getVertexSet()){
-        if(vertex->getNum() < minDistance){
-            minDistance = vertex->getNum();
-            sourceCodes.clear();
-            sourceCodes.push_back(vertex->getInfo());
-        }
-        else if(vertex->getNum() == minDistance){
-            sourceCodes.push_back(vertex->getInfo());
-        }
-    }
+    sourceCodes = getClosestAirports(position);
 
     for(auto vertex : flights.getVertexSet()){
         if(airports.find(vertex->getInfo())->second.getCity() == destinationCity && airports.find(vertex->getInfo())->second.getCountry() == destinationCountry){
@@ -1994,37 +2198,10 @@ void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCoordinate
  */
 void FlightManagementSystem::findBestFlightOptionsWithFewestAirlinesByCoordinatesToCoordinates(double sourceLatitude, double sourceLongitude, double destinationLatitude, double destinationLongitude) const {
     Position sourcePosition = Position(sourceLatitude, sourceLongitude);
-    int minSourceDistance = INT_MAX;
-    for (auto vertex: flights.getVertexSet()) {
-        vertex->setNum((int) sourcePosition.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> minSource;
-    for (auto vertex: flights.getVertexSet()) {
-        if (vertex->getNum() < minSourceDistance) {
-            minSourceDistance = vertex->getNum();
-            minSource.clear();
-            minSource.push_back(vertex->getInfo());
-        } else if (vertex->getNum() == minSourceDistance) {
-            minSource.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> minSource = getClosestAirports(sourcePosition);
 
     Position destinationPosition = Position(destinationLatitude, destinationLongitude);
-    int minDestinationDistance = INT_MAX;
-    for (auto vertex: flights.getVertexSet()) {
-        vertex->setNum(
-                (int) destinationPosition.haversineDistance(airports.find(vertex->getInfo())->second.getPosition()));
-    }
-    vector<string> minDestination;
-    for (auto vertex: flights.getVertexSet()) {
-        if (vertex->getNum() < minDestinationDistance) {
-            minDestinationDistance = vertex->getNum();
-            minDestination.clear();
-            minDestination.push_back(vertex->getInfo());
-        } else if (vertex->getNum() == minDestinationDistance) {
-            minDestination.push_back(vertex->getInfo());
-        }
-    }
+    vector<string> minDestination = getClosestAirports(destinationPosition);
 
     int option = 1;
     for (const auto &source: minSource) {
@@ -2097,3 +2274,620 @@ double FlightManagementSystem::findSmallestDistance(const string &source, const
     cout << "Total distance: ";
     return minDistance;
 }
+
+/**
+ * @brief Runs Monte Carlo failure trials over the flights network and writes the connectivity curve as CSV.
+ *
+ * @param mode Whether airports or routes fail, and whether they are chosen at random or by degree.
+ * @param fractions The removed fractions (0 to 1) to evaluate.
+ * @param trials The number of trials per fraction.
+ * @param seed The seed of the run. The same seed always produces the same curve.
+ * @param out The stream where the CSV is written.
+ *
+ * @complexity Time Complexity: O(F * T * (V log V + E α(V)) / P), where F is the number of fractions, T the number of
+ * trials and P the number of hardware threads.
+ */
+void FlightManagementSystem::analyseNetworkResilience(FailureMode mode, const vector<double> &fractions, int trials, unsigned long long seed, ostream &out) const {
+    ResilienceAnalysis analysis(flights);
+    analysis.run(mode, fractions, trials, seed, out);
+}
+
+/**
+ * @brief Writes, as CSV, the local clustering coefficient of every airport.
+ *
+ * @param out The stream where the CSV is written.
+ *
+ * @info The coefficient is the fraction of the pairs of airports sharing a route with an airport that also share a
+ * route with each other, ignoring flight direction and airline. Airports are printed in code order.
+ *
+ * @complexity Time Complexity: O(V log V + E log E + R^1.5 / P), where V is the number of airports, E the number of
+ * flights, R the number of undirected routes and P the number of hardware threads.
+ */
+void FlightManagementSystem::clusteringPerAirport(ostream &out) const {
+    ClusteringAnalysis analysis(flights);
+    vector<pair<string, int>> order;
+    for (auto vertex : flights.getVertexSet()) {
+        order.push_back({vertex->getInfo(), vertex->getId()});
+    }
+    sort(order.begin(), order.end());
+
+    out << "airport,name,routes,triangles,clustering" << endl;
+    for (const auto &airport : order) {
+        out << airport.first << ",\"" << airports.at(airport.first).getName() << "\","
+            << analysis.getDegree(airport.second) << ',' << analysis.getTriangles(airport.second) << ','
+            << analysis.getClustering(airport.second) << endl;
+    }
+}
+
+/**
+ * @brief Prints how interlinked the network is and the new routes that would close the most open triads.
+ *
+ * @param k The number of suggested routes.
+ *
+ * @info An open triad is a pair of routes A-B and B-C without a route A-C. The suggested routes are the pairs of
+ * airports without a route between them that share a route with the most airports.
+ *
+ * @complexity Time Complexity: O(E log E + R^1.5 / P + (sum of d^2) / P), where E is the number of flights, R the
+ * number of undirected routes, P the number of hardware threads and d the degree of each airport.
+ */
+void FlightManagementSystem::suggestMissingRoutes(int k) const {
+    auto start = chrono::steady_clock::now();
+    ClusteringAnalysis analysis(flights);
+    vector<MissingLink> links = analysis.suggestLinks(k);
+    auto end = chrono::steady_clock::now();
+
+    cout << "Airports: " << analysis.getNumberOfAirports() << ", routes: " << analysis.getNumberOfRoutes()
+         << ", triangles: " << analysis.getNumberOfTriangles() << endl;
+    cout << "Global transitivity: " << analysis.getTransitivity() << endl;
+    cout << "Average clustering: " << analysis.getAverageClustering() << endl;
+    cout << "Routes that would close the most open triads:" << endl;
+    const auto &vertices = flights.getVertexSet();
+    for (int i = 0; i < (int) links.size(); i++) {
+        const string &first = vertices[links[i].first]->getInfo(), &second = vertices[links[i].second]->getInfo();
+        cout << i + 1 << " -> " << first << " (" << airports.at(first).getCity() << ") - " << second << " ("
+             << airports.at(second).getCity() << "): " << links[i].commonNeighbours << " airports fly to both" << endl;
+    }
+    cout << "Computed in " << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+}
+
+/**
+ * @brief Writes, as CSV, the network metrics of the whole network and of the subnetwork of every airline.
+ *
+ * @param out The stream where the CSV is written.
+ *
+ * @info Each airline is a GraphView over the flights graph, so no subgraph is copied, and the metrics are computed by
+ * the same NetworkStatistics kernels used for the global row. Airlines are processed in parallel and printed in
+ * code order.
+ *
+ * @complexity Time Complexity: O(A * V * (V + E) / P), where A is the number of airlines and P the number of hardware
+ * threads.
+ */
+void FlightManagementSystem::networkStatisticsPerAirline(ostream &out) const {
+    const int hubs = 3;
+    int numAirlines = flights.getNumAirlines();
+    vector<NetworkMetrics> metrics(numAirlines);
+    parallelFor(numAirlines, [&](size_t id) {
+        GraphView view(flights, {(int) id});
+        metrics[id] = NetworkStatistics::compute(view, hubs);
+    });
+
+    vector<pair<string, int>> order;
+    for (int id = 0; id < numAirlines; id++) {
+        order.push_back({flights.getAirlineCode(id), id});
+    }
+    sort(order.begin(), order.end());
+
+    auto writeRow = [&out](const string &code, const string &name, const NetworkMetrics &m) {
+        out << code << ",\"" << name << "\"," << m.airports << ',' << m.flights << ',' << m.components << ','
+            << m.largestComponent << ',' << m.diameter << ',' << m.essentialAirports << ',';
+        for (int i = 0; i < (int) m.hubReach.size(); i++) {
+            out << (i ? " " : "") << m.hubReach[i].first << ':' << m.hubReach[i].second;
+        }
+        out << endl;
+    };
+
+    out << "airline,name,airports,flights,components,largest_component,diameter,essential_airports,hub_reachability" << endl;
+    writeRow("ALL", "All airlines", NetworkStatistics::compute(GraphView(flights), hubs));
+    for (const auto &entry : order) {
+        auto airline = airlines.find(entry.first);
+        writeRow(entry.first, airline == airlines.end() ? "" : airline->second.getName(), metrics[entry.second]);
+    }
+}
+
+/**
+ * @brief Prints the best airports for a group travelling from several origins to meet, with a sample trip per traveller.
+ *
+ * @param origins The codes of the origin airports, one per traveller.
+ * @param criterion Whether the longest trip or the total number of flights is minimized first.
+ * @param k The number of meeting airports to print.
+ *
+ * @complexity Time Complexity: O(D * (V + E)) for up to 64 origins, O(N * (V + E)) otherwise, where D is the diameter and
+ * N the number of origins.
+ */
+void FlightManagementSystem::findMeetingPoint(const vector<string> &origins, MeetingCriterion criterion, int k) const {
+    vector<int> ids;
+    for (const auto &code : origins) {
+        auto vertex = flights.findVertex(code);
+        if (vertex == nullptr) {
+            cout << "Airport " << code << " doesn't exist" << endl;
+            return;
+        }
+        ids.push_back(vertex->getId());
+    }
+
+    GraphView view(flights);
+    MeetingPoint meetingPoint(view);
+    auto candidates = meetingPoint.search(ids, criterion, k);
+    if (candidates.empty()) {
+        cout << "No airport is reachable from every origin" << endl;
+        return;
+    }
+
+    vector<int> meetingAirports;
+    for (const auto &candidate : candidates) {
+        meetingAirports.push_back(candidate.airport);
+    }
+    vector<vector<vector<int>>> trips;
+    for (int origin : ids) {
+        trips.push_back(meetingPoint.itineraries(origin, meetingAirports));
+    }
+
+    const auto &vertices = flights.getVertexSet();
+    for (int i = 0; i < (int) candidates.size(); i++) {
+        const auto &airport = airports.find(vertices[candidates[i].airport]->getInfo())->second;
+        cout << "Option " << i + 1 << ": " << airport.getCode() << " (" << airport.getName() << ") - "
+             << airport.getCity() << ", " << airport.getCountry() << " -- longest trip " << candidates[i].maxFlights
+             << " flights, total " << candidates[i].totalFlights << " flights" << endl;
+        for (const auto &originTrips : trips) {
+            const auto &path = originTrips[i];
+            cout << '\t';
+            for (int j = 0; j < (int) path.size(); j++) {
+                cout << (j ? " -> " : "") << vertices[path[j]]->getInfo();
+            }
+            cout << endl;
+        }
+    }
+}
+
+/**
+ * @brief Computes the matrix of fewest flights or smallest flown distances between two lists of airports.
+ *
+ * @param sources The codes of the airports of the rows.
+ * @param targets The codes of the airports of the columns.
+ * @param metric Whether the values are numbers of flights or kilometers.
+ * @param out The stream where the matrix is written.
+ * @param binary Whether to write the compact binary format instead of CSV.
+ *
+ * @return False (and nothing is written) if some code is invalid.
+ *
+ * @info Unlike calling findBestFlightOptions or findSmallestDistance for every pair, searches are shared between
+ * sources and run in parallel. Kilometers are the smallest flown distance over any number of flights, not only over
+ * the trips with the fewest flights.
+ *
+ * @complexity Time Complexity: O(S / 64 * D * (V + E) / P) for flights and O(S * (V + E) log V / P) for kilometers,
+ * where S is the number of sources, D the diameter and P the number of hardware threads.
+ */
+bool FlightManagementSystem::computeDistanceMatrix(const vector<string> &sources, const vector<string> &targets, MatrixMetric metric, ostream &out, bool binary) const {
+    vector<int> sourceIds, targetIds;
+    for (const auto &code : sources) {
+        auto vertex = flights.findVertex(code);
+        if (vertex == nullptr) {
+            cout << "Airport " << code << " doesn't exist" << endl;
+            return false;
+        }
+        sourceIds.push_back(vertex->getId());
+    }
+    for (const auto &code : targets) {
+        auto vertex = flights.findVertex(code);
+        if (vertex == nullptr) {
+            cout << "Airport " << code << " doesn't exist" << endl;
+            return false;
+        }
+        targetIds.push_back(vertex->getId());
+    }
+
+    GraphView view(flights);
+    DistanceMatrix matrix(view, sourceIds, targetIds, metric);
+    if (binary) {
+        matrix.writeBinary(out);
+    } else {
+        matrix.writeCsv(out);
+    }
+    return true;
+}
+
+/**
+ * @brief Prints every airport, city and country reachable from an airport within a budget of flown kilometers.
+ *
+ * @param airportCode The code of the source airport.
+ * @param budget The maximum total flown distance, in km.
+ *
+ * @info Unlike numberOfReachableDestinationsFromAirportWithStops, the bound is on the sum of Edge::distance of the
+ * trip, not on its number of flights. Cities and countries are reported with the distance of their closest airport.
+ *
+ * @complexity Time Complexity: O(E' + V' log C), where V' and E' are the vertices and edges within the budget.
+ */
+void FlightManagementSystem::reachableWithinDistance(const string &airportCode, double budget) const {
+    auto vertex = flights.findVertex(airportCode);
+    if (vertex == nullptr) {
+        cout << "Airport " << airportCode << " doesn't exist" << endl;
+        return;
+    }
+
+    auto reachable = isochrone.query(GraphView(flights), vertex->getId(), budget);
+    const auto &vertices = flights.getVertexSet();
+    map<pair<string, string>, double> cities;
+    map<string, double> countries;
+    for (const auto &entry : reachable) {
+        if (entry.airport == vertex->getId()) {
+            continue;
+        }
+        const auto &airport = airports.find(vertices[entry.airport]->getInfo())->second;
+        auto city = make_pair(airport.getCity(), airport.getCountry());
+        if (cities.find(city) == cities.end()) {
+            cities[city] = entry.km;
+        }
+        if (countries.find(airport.getCountry()) == countries.end()) {
+            countries[airport.getCountry()] = entry.km;
+        }
+        cout << airport.getCode() << " (" << airport.getName() << ") - " << airport.getCity() << ", "
+             << airport.getCountry() << " -- " << entry.km << " km, " << entry.flights << " flights" << endl;
+    }
+
+    cout << endl << "Cities:" << endl;
+    for (const auto &city : cities) {
+        cout << city.first.first << ", " << city.first.second << " -- " << city.second << " km" << endl;
+    }
+    cout << endl << "Countries:" << endl;
+    for (const auto &country : countries) {
+        cout << country.first << " -- " << country.second << " km" << endl;
+    }
+    cout << endl;
+    cout << "Number of reachable airports: " << reachable.size() - 1 << endl;
+    cout << "Number of reachable cities: " << cities.size() << endl;
+    cout << "Number of reachable countries: " << countries.size() << endl;
+}
+
+/**
+ * @brief Gets the airports inside a latitude/longitude box.
+ *
+ * @param minLatitude The southern edge of the box.
+ * @param minLongitude The western edge of the box.
+ * @param maxLatitude The northern edge of the box.
+ * @param maxLongitude The eastern edge of the box (smaller than minLongitude if the box crosses the antimeridian).
+ *
+ * @return The codes of the airports inside the box.
+ *
+ * @complexity Time Complexity: O(log V + K), where K is the number of airports found.
+ */
+vector<string> FlightManagementSystem::getAirportsInBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const {
+    spatialReady.wait();
+    vector<string> res;
+    for (int id : airportIndex.queryBox(minLatitude, minLongitude, maxLatitude, maxLongitude)) {
+        res.push_back(flights.getVertexSet()[id]->getInfo());
+    }
+    return res;
+}
+
+/**
+ * @brief Gets the airports within a great-circle distance of some coordinates.
+ *
+ * @param latitude The latitude of the center.
+ * @param longitude The longitude of the center.
+ * @param radius The distance, in kilometers.
+ *
+ * @return The distance and the code of every airport found, closest first.
+ *
+ * @complexity Time Complexity: O(log V + K log K), where K is the number of airports found.
+ */
+vector<pair<double, string>> FlightManagementSystem::getAirportsWithinRadius(double latitude, double longitude, double radius) const {
+    spatialReady.wait();
+    vector<pair<double, string>> res;
+    for (const auto &found : airportIndex.queryRadius(Position(latitude, longitude), radius)) {
+        res.push_back({found.first, flights.getVertexSet()[found.second]->getInfo()});
+    }
+    return res;
+}
+
+/**
+ * @brief Gets the k airports closest to some coordinates.
+ *
+ * @param latitude The latitude.
+ * @param longitude The longitude.
+ * @param k The number of airports.
+ *
+ * @return The distance and the code of the k closest airports, closest first.
+ *
+ * @complexity Time Complexity: O((log V + k) log V)
+ */
+vector<pair<double, string>> FlightManagementSystem::getNearestAirports(double latitude, double longitude, int k) const {
+    spatialReady.wait();
+    vector<pair<double, string>> res;
+    for (const auto &found : airportIndex.nearest(Position(latitude, longitude), k)) {
+        res.push_back({found.first, flights.getVertexSet()[found.second]->getInfo()});
+    }
+    return res;
+}
+
+/**
+ * @brief Gets the flights whose source and target airports are both inside a latitude/longitude box.
+ *
+ * @param minLatitude The southern edge of the box.
+ * @param minLongitude The western edge of the box.
+ * @param maxLatitude The northern edge of the box.
+ * @param maxLongitude The eastern edge of the box (smaller than minLongitude if the box crosses the antimeridian).
+ *
+ * @return One route per (source, target) pair, with every airline that flies it.
+ *
+ * @complexity Time Complexity: O(log V + K + F), where K is the number of airports in the box and F their flights.
+ */
+vector<Route> FlightManagementSystem::getFlightsInBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const {
+    spatialReady.wait();
+    const auto &vertices = flights.getVertexSet();
+    vector<int> inside = airportIndex.queryBox(minLatitude, minLongitude, maxLatitude, maxLongitude);
+    vector<bool> isInside(vertices.size(), false);
+    for (int id : inside) {
+        isInside[id] = true;
+    }
+
+    vector<Route> res;
+    for (int id : inside) {
+        map<int, vector<string>> targets;
+        for (auto edge : vertices[id]->getAdj()) {
+            if (isInside[edge.getDest()->getId()]) {
+                targets[edge.getDest()->getId()].push_back(edge.getAirline());
+            }
+        }
+        for (const auto &target : targets) {
+            res.push_back({vertices[id]->getInfo(), vertices[target.first]->getInfo(), target.second});
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Builds the route between two airports, in either direction, with every airline that flies it.
+ *
+ * @param first The vertex id of the first airport.
+ * @param second The vertex id of the second airport.
+ *
+ * @return The route from the first to the second airport, with the sorted airlines of both directions.
+ *
+ * @complexity Time Complexity: O(D log D), where D is the number of flights of both airports.
+ */
+Route FlightManagementSystem::getUndirectedRoute(int first, int second) const {
+    const auto &vertices = flights.getVertexSet();
+    set<string> routeAirlines;
+    for (const auto &edge : vertices[first]->getAdj()) {
+        if (edge.getDest()->getId() == second)
+            routeAirlines.insert(flights.getAirlineCode(edge.getAirlineId()));
+    }
+    for (const auto &edge : vertices[second]->getAdj()) {
+        if (edge.getDest()->getId() == first)
+            routeAirlines.insert(flights.getAirlineCode(edge.getAirlineId()));
+    }
+    return {vertices[first]->getInfo(), vertices[second]->getInfo(), vector<string>(routeAirlines.begin(), routeAirlines.end())};
+}
+
+/**
+ * @brief Gets the routes whose great-circle path passes within a distance of some coordinates.
+ *
+ * @param latitude The latitude of the point.
+ * @param longitude The longitude of the point.
+ * @param radius The distance, in kilometers.
+ *
+ * @return The distance from the point to each route found and the route itself, closest first.
+ *
+ * @complexity Time Complexity: O(log E + C + K log K), where C is the number of candidate routes and K of matches.
+ */
+vector<pair<double, Route>> FlightManagementSystem::getRoutesNearPoint(double latitude, double longitude, double radius) const {
+    routesReady.wait();
+    vector<pair<double, Route>> res;
+    for (const auto &match : routeIndex.queryPoint(Position(latitude, longitude), radius)) {
+        res.push_back({match.distance, getUndirectedRoute(match.source, match.target)});
+    }
+    return res;
+}
+
+/**
+ * @brief Gets the routes whose great-circle path crosses or lies inside a region.
+ *
+ * @param region The vertices of the region, in order. It must be smaller than a hemisphere.
+ *
+ * @return The routes found, sorted.
+ *
+ * @complexity Time Complexity: O(log E + C * P + K log K), where C is the number of candidate routes, P the number of
+ * vertices of the region and K the number of matches.
+ */
+vector<Route> FlightManagementSystem::getRoutesCrossingRegion(const vector<Position> &region) const {
+    routesReady.wait();
+    vector<Route> res;
+    for (const auto &match : routeIndex.queryPolygon(region)) {
+        res.push_back(getUndirectedRoute(match.first, match.second));
+    }
+    sort(res.begin(), res.end());
+    return res;
+}
+
+/**
+ * @brief Gets the airports closest to a position.
+ *
+ * @param position The position.
+ *
+ * @return The codes of every airport whose distance, truncated to whole kilometers, is the smallest, in vertex order.
+ *
+ * @info The spatial index ranks airports by the dot product of their unit vectors, so the haversine distance is only
+ * calculated for the closest airport and for the few airports tied with it.
+ *
+ * @complexity Time Complexity: O(log V + K log K), where K is the number of airports within a kilometer of the closest.
+ */
+vector<string> FlightManagementSystem::getClosestAirports(const Position &position) const {
+    spatialReady.wait();
+    vector<string> res;
+    auto closest = airportIndex.nearest(position, 1);
+    if (closest.empty())
+        return res;
+    int minDistance = (int) closest[0].first;
+    vector<int> ids;
+    for (const auto &found : airportIndex.queryRadius(position, minDistance + 1)) {
+        if ((int) found.first == minDistance)
+            ids.push_back(found.second);
+    }
+    sort(ids.begin(), ids.end());
+    for (int id : ids) {
+        res.push_back(flights.getVertexSet()[id]->getInfo());
+    }
+    return res;
+}
+
+/**
+ * @brief Finds the airport names most similar to a query.
+ *
+ * @param query The (possibly misspelled) name.
+ * @param k The maximum number of names.
+ *
+ * @return The similarity (0 to 1) and the name of the best matches, most similar first.
+ *
+ * @complexity Time Complexity: O(P + C log k), where P is the number of indexed names that share a trigram with the
+ * query, counted once per shared trigram, and C the number of those names.
+ */
+vector<pair<double, string>> FlightManagementSystem::searchAirportNames(const string &query, int k) const {
+    namesReady.wait();
+    vector<pair<double, string>> res;
+    for (const auto &found : airportNameIndex.search(query, k)) {
+        res.push_back({found.first, airportNameIndex.get(found.second)});
+    }
+    return res;
+}
+
+/**
+ * @brief Finds the cities most similar to a query.
+ *
+ * @param city The (possibly misspelled) city.
+ * @param country The (possibly misspelled) country. May be empty.
+ * @param k The maximum number of cities.
+ *
+ * @return The similarity (0 to 1) and the city, as "city, country", of the best matches, most similar first.
+ *
+ * @complexity Time Complexity: O(P + C log k), as in searchAirportNames.
+ */
+vector<pair<double, string>> FlightManagementSystem::searchCities(const string &city, const string &country, int k) const {
+    namesReady.wait();
+    vector<pair<double, string>> res;
+    for (const auto &found : cityIndex.search(city + " " + country, k)) {
+        res.push_back({found.first, cityIndex.get(found.second)});
+    }
+    return res;
+}
+
+/**
+ * @brief Finds the countries most similar to a query.
+ *
+ * @param query The (possibly misspelled) country.
+ * @param k The maximum number of countries.
+ *
+ * @return The similarity (0 to 1) and the name of the best matches, most similar first.
+ *
+ * @complexity Time Complexity: O(P + C log k), as in searchAirportNames.
+ */
+vector<pair<double, string>> FlightManagementSystem::searchCountries(const string &query, int k) const {
+    namesReady.wait();
+    vector<pair<double, string>> res;
+    for (const auto &found : countryIndex.search(query, k)) {
+        res.push_back({found.first, countryIndex.get(found.second)});
+    }
+    return res;
+}
+
+/**
+ * @brief Prints the airport names most similar to a name that was not found.
+ *
+ * @param name The name.
+ *
+ * @complexity Time Complexity: O(P + C log k), as in searchAirportNames.
+ */
+void FlightManagementSystem::suggestAirportNames(const string &name) const {
+    auto found = searchAirportNames(name, 5);
+    if (found.empty())
+        return;
+    cout << "Did you mean:" << endl;
+    for (const auto &match : found) {
+        cout << '\t' << match.second << endl;
+    }
+}
+
+/**
+ * @brief Checks if a city exists, printing the most similar cities if it does not.
+ *
+ * @param city The name of the city.
+ * @param country The name of the country of the city.
+ *
+ * @return True if some airport is in the city.
+ *
+ * @complexity Time Complexity: O(1) if the city exists, O(P + C log k) otherwise, as in searchAirportNames.
+ */
+bool FlightManagementSystem::checkCity(const string &city, const string &country) const {
+    namesReady.wait();
+    if (cityIndex.find(city + ", " + country) != -1)
+        return true;
+    cout << "City " << city << ", " << country << " doesn't exist" << endl;
+    auto found = searchCities(city, country, 5);
+    if (!found.empty()) {
+        cout << "Did you mean:" << endl;
+        for (const auto &match : found) {
+            cout << '\t' << match.second << endl;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks on the country graph whether a trip between two airports can exist, before searching the airports.
+ *
+ * @param source The code of the source airport.
+ * @param destination The code of the destination airport.
+ * @param selectedAirlines If given, the airlines the trip may use.
+ *
+ * @return False only if no trip exists, so the airport-level search can be skipped. True if it may exist, or if the
+ * country graph is still being built.
+ *
+ * @info Without airlines this is a lookup in the precomputed hop table; with them, a breadth-first search over the
+ * country edges some selected airline flies, which is a few hundred nodes instead of thousands of airports.
+ *
+ * @complexity Time Complexity: O(1) without airlines, O(C + Q * a) with them, where C is the number of countries, Q the
+ * number of edges between them and a the number of airlines of an edge.
+ */
+bool FlightManagementSystem::mayConnect(const string &source, const string &destination,
+                                        const vector<string> *selectedAirlines) const {
+    if (hubsReady.wait_for(chrono::seconds(0)) != future_status::ready)
+        return true;
+    Vertex *s = flights.findVertex(source), *d = flights.findVertex(destination);
+    if (s == nullptr || d == nullptr)
+        return true;
+    int from = aggregates.getCountryOfAirport(s->getId()), to = aggregates.getCountryOfAirport(d->getId());
+    if (selectedAirlines == nullptr)
+        return countryGraph.getHops(from, to) >= 0;
+
+    vector<bool> allowed(flights.getNumAirlines(), false);
+    for (const auto &airline : *selectedAirlines) {
+        int id = flights.getAirlineId(airline);
+        if (id >= 0)
+            allowed[id] = true;
+    }
+    return countryGraph.getHopsFrom(from, INT_MAX, &allowed)[to] >= 0;
+}
+
+/**
+ * @brief Gets the best completions of a partially typed airport code, airport name or city.
+ *
+ * @param prefix What was typed so far.
+ * @param k The maximum number of completions.
+ *
+ * @return The completions, busiest airport first, with at most one completion per airport.
+ *
+ * @complexity Time Complexity: O(P log σ + k), where P is the length of the prefix and σ the size of the alphabet.
+ */
+vector<CompletionEntry> FlightManagementSystem::autocompleteAirports(const string &prefix, int k) const {
+    completionsReady.wait();
+    return autocomplete.complete(prefix, k);
+}
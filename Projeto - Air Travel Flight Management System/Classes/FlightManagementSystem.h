@@ -7,8 +7,26 @@
 #include <vector>
 #include <unordered_map>
 #include <map>
+#include <future>
+#include <thread>
 
 #include "Data.h"
+#include "ResilienceAnalysis.h"
+#include "ClusteringAnalysis.h"
+#include "NetworkStatistics.h"
+#include "MeetingPoint.h"
+#include "DistanceMatrix.h"
+#include "Isochrone.h"
+#include "RTree.h"
+#include "RouteCorridorIndex.h"
+#include "TrigramIndex.h"
+#include "Autocomplete.h"
+#include "TrafficRanking.h"
+#include "FlightAggregates.h"
+#include "FlightTable.h"
+#include "QuotientGraph.h"
+#include "AirportSets.h"
+#include "DestinationLists.h"
 
 struct Route {
     std::string source;
@@ -30,6 +48,11 @@ struct Route {
 class FlightManagementSystem {
 public:
     FlightManagementSystem(Data d);
+    FlightManagementSystem(const FlightManagementSystem &) = delete;
+    FlightManagementSystem &operator=(const FlightManagementSystem &) = delete;
+    ~FlightManagementSystem();
+
+    std::string getLoadingStatus() const;
 
     void loadAirports(Data data);
     void loadAirlines(Data data);
@@ -42,13 +65,23 @@ public:
     int getNumberOfAirlinesFromAirport(const std::string& airportCode) const;
     void numberOfFlightsPerCity() const;
     void numberOfFlightsPerAirline() const;
+    void numberOfFlightsPerCountry() const;
+    void numberOfFlightsPerAirlineFromCountry(const std::string &country) const;
+    int getNumberOfFlightsBetweenCountries(const std::string &origin, const std::string &destination) const;
+    void queryFlights(const std::string &query) const;
+    void queryAirportSets(const std::string &expression) const;
+    void commonDestinations(const std::vector<std::string> &airportCodes) const;
+    void cityHopDistance(const std::string &sourceCity, const std::string &sourceCountry,
+                         const std::string &destinationCity, const std::string &destinationCountry) const;
+    void countryHopDistance(const std::string &origin, const std::string &destination) const;
+    void countriesWithinBorderCrossings(const std::string &country, int k) const;
+    void airlineRouteOverlap(double threshold) const;
     int getNumberOfCountriesFromAirport(const std::string& airportCode) const;
     int getNumberOfCountriesFromCity(const std::string& city, const std::string &country) const;
     void numberOfReachableDestinationsFromAirport(const std::string &airportCode) const;
     void numberOfReachableDestinationsFromAirportWithStops(const std::string &airportCode, int maxStops) const;
-    void getMaxTripWithStops();
-    int calcStopsBFS(Vertex *source, vector<std::pair<std::string, std::string>> &aux);
-    void getTopAirportWithMostTraffic(int k) const;
+    void getMaxTripWithStops() const;
+    void getTopAirportWithMostTraffic(int k, TrafficMetric metric = TrafficMetric::Flights) const;
     unordered_set<string> getEssentialAirports() const;
     void printRoute(const Route& route) const;
 
@@ -104,6 +137,27 @@ public:
 
     double findSmallestDistance(const string &source, const string &destination) const;
 
+    void analyseNetworkResilience(FailureMode mode, const vector<double> &fractions, int trials, unsigned long long seed, ostream &out) const;
+    void networkStatisticsPerAirline(ostream &out) const;
+    void clusteringPerAirport(ostream &out) const;
+    void suggestMissingRoutes(int k) const;
+
+    void findMeetingPoint(const vector<string> &origins, MeetingCriterion criterion, int k) const;
+    bool computeDistanceMatrix(const vector<string> &sources, const vector<string> &targets, MatrixMetric metric, ostream &out, bool binary) const;
+    void reachableWithinDistance(const string &airportCode, double budget) const;
+
+    vector<string> getAirportsInBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const;
+    vector<pair<double, string>> getAirportsWithinRadius(double latitude, double longitude, double radius) const;
+    vector<pair<double, string>> getNearestAirports(double latitude, double longitude, int k) const;
+    vector<Route> getFlightsInBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const;
+    vector<pair<double, Route>> getRoutesNearPoint(double latitude, double longitude, double radius) const;
+    vector<Route> getRoutesCrossingRegion(const vector<Position> &region) const;
+
+    vector<pair<double, string>> searchAirportNames(const string &query, int k) const;
+    vector<pair<double, string>> searchCities(const string &city, const string &country, int k) const;
+    vector<pair<double, string>> searchCountries(const string &query, int k) const;
+    vector<CompletionEntry> autocompleteAirports(const string &prefix, int k) const;
+
 
 private:
     std::unordered_map<std::string, Airline> airlines;      ///< Map of airlines
@@ -111,6 +165,41 @@ private:
     std::unordered_map<std::string, Airport> airports;      ///< Map of airports
 
     Graph flights = Graph();                                ///< Graph of flights
+
+    mutable Isochrone isochrone;                            ///< Scratch memory shared by the distance-bounded queries
+
+    RTree airportIndex;                                     ///< Spatial index of the airports, by vertex id
+
+    RouteCorridorIndex routeIndex;                          ///< Spatial index of the great-circle arcs of the routes
+
+    TrigramIndex airportNameIndex;                          ///< Fuzzy index of the airport names
+    TrigramIndex cityIndex;                                 ///< Fuzzy index of the cities, as "city, country"
+    TrigramIndex countryIndex;                              ///< Fuzzy index of the countries
+
+    Autocomplete autocomplete;                              ///< Prefix trie over airport codes, names and cities
+
+    TrafficRanking trafficRanking;                          ///< Airports by flights, destinations, airlines and km
+    FlightAggregates aggregates;                            ///< Flights by city, country, airline and their pairs
+    FlightTable flightTable;                                ///< Columnar copy of the flights for ad-hoc queries
+    QuotientGraph cityGraph;                                ///< Flights collapsed into city nodes
+    QuotientGraph countryGraph;                             ///< Flights collapsed into country nodes, with all hops
+    AirportSets airportSets;                                ///< Airports by country, city and airline, as bitmaps
+    DestinationLists destinationLists;                      ///< Sorted nonstop destinations of every airport
+
+    std::shared_future<void> namesReady;                    ///< Ready once the fuzzy name indexes are built
+    std::shared_future<void> spatialReady;                  ///< Ready once the spatial index of the airports is built
+    std::shared_future<void> hubsReady;                     ///< Ready once the traffic ranking and statistics are built
+    std::shared_future<void> completionsReady;              ///< Ready once the autocomplete trie is loaded or built
+    std::shared_future<void> routesReady;                   ///< Ready once the spatial index of the routes is built
+    std::thread indexBuilder;                               ///< Builds the indexes above, in that order
+
+    void buildIndexes(unsigned long long fingerprint, unsigned long long sequence, vector<std::promise<void>> &ready);
+
+    Route getUndirectedRoute(int first, int second) const;
+    vector<string> getClosestAirports(const Position &position) const;
+    void suggestAirportNames(const string &name) const;
+    bool checkCity(const string &city, const string &country) const;
+    bool mayConnect(const string &source, const string &destination, const vector<string> *selectedAirlines) const;
 };
 #endif
 
@@ -0,0 +1,589 @@
+
+#include "FlightTable.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Loads the flights of a graph into the table.
+ *
+ * @param graph The flights graph.
+ * @param airports The airports, by code.
+ *
+ * @complexity Time Complexity: O(V log V + E), where V is the number of vertices and E the number of edges.
+ */
+void FlightTable::build(const Graph &graph, const unordered_map<string, Airport> &airports) {
+    const vector<Vertex *> &vertices = graph.getVertexSet();
+    airportCodes.clear();
+    vector<string> airportCountries;
+    for (auto vertex : vertices) {
+        airportCodes.push_back(vertex->getInfo());
+        airportCountries.push_back(airports.find(vertex->getInfo())->second.getCountry());
+    }
+    airlineCodes.clear();
+    for (int id = 0; id < graph.getNumAirlines(); id++)
+        airlineCodes.push_back(graph.getAirlineCode(id));
+
+    source.clear();
+    target.clear();
+    airline.clear();
+    distance.clear();
+    for (auto vertex : vertices) {
+        for (const auto &edge : vertex->getAdj()) {
+            source.push_back(vertex->getId());
+            target.push_back(edge.getDest()->getId());
+            airline.push_back(edge.getAirlineId());
+            distance.push_back(edge.getDistance());
+        }
+    }
+    index(airportCountries);
+}
+
+/**
+ * @brief Loads the flights of a snapshot into the table.
+ *
+ * @param snapshot The snapshot.
+ *
+ * @complexity Time Complexity: O(V log V + E), where V is the number of airports and E the number of flights.
+ */
+void FlightTable::build(const GraphSnapshot &snapshot) {
+    airportCodes.clear();
+    vector<string> airportCountries;
+    for (int id = 0; id < snapshot.getNumAirports(); id++) {
+        airportCodes.push_back(snapshot.getAirportCode(id));
+        airportCountries.push_back(snapshot.getAirport(id).getCountry());
+    }
+    airlineCodes.clear();
+    for (int id = 0; id < snapshot.getNumFlightAirlines(); id++)
+        airlineCodes.push_back(snapshot.getAirlineCode(id));
+
+    source.clear();
+    target.clear();
+    airline.clear();
+    distance.clear();
+    for (int id = 0; id < snapshot.getNumAirports(); id++) {
+        for (int flight = snapshot.getFirstFlight(id); flight < snapshot.getLastFlight(id); flight++) {
+            source.push_back(id);
+            target.push_back(snapshot.getFlightTarget(flight));
+            airline.push_back(snapshot.getFlightAirline(flight));
+            distance.push_back(snapshot.getFlightDistance(flight));
+        }
+    }
+    index(airportCountries);
+}
+
+/**
+ * @brief Numbers the countries, fills the country columns and indexes the names of every id.
+ *
+ * @param airportCountries The country of each airport id.
+ *
+ * @complexity Time Complexity: O(V log V + E), where V is the number of airports and E the number of flights.
+ */
+void FlightTable::index(const vector<string> &airportCountries) {
+    countries = airportCountries;
+    sort(countries.begin(), countries.end());
+    countries.erase(unique(countries.begin(), countries.end()), countries.end());
+
+    airportIds.clear();
+    airlineIds.clear();
+    countryIds.clear();
+    for (int id = 0; id < (int) airportCodes.size(); id++)
+        airportIds[airportCodes[id]] = id;
+    for (int id = 0; id < (int) airlineCodes.size(); id++)
+        airlineIds[airlineCodes[id]] = id;
+    for (int id = 0; id < (int) countries.size(); id++)
+        countryIds[countries[id]] = id;
+
+    vector<int32_t> countryOf(airportCodes.size());
+    for (int id = 0; id < (int) airportCodes.size(); id++)
+        countryOf[id] = countryIds[airportCountries[id]];
+    numFlights = (int) source.size();
+    sourceCountry.resize(numFlights);
+    targetCountry.resize(numFlights);
+    for (int row = 0; row < numFlights; row++) {
+        sourceCountry[row] = countryOf[source[row]];
+        targetCountry[row] = countryOf[target[row]];
+    }
+    pad();
+}
+
+/**
+ * @brief Pads every column to a whole number of 64-row blocks, so a scan never needs a scalar tail.
+ *
+ * @info The padding rows hold -1 (and NaN as the distance), which no predicate matches, and are cut from the
+ * selection before grouping anyway.
+ *
+ * @complexity Time Complexity: O(1) amortized.
+ */
+void FlightTable::pad() {
+    size_t rows = (numFlights + 63) / 64 * 64;
+    for (auto column : {&source, &target, &airline, &sourceCountry, &targetCountry})
+        column->resize(rows, -1);
+    distance.resize(rows, __builtin_nanf(""));
+}
+
+/**
+ * @brief Gets the number of flights in the table.
+ *
+ * @return The number of rows.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightTable::getNumFlights() const {
+    return numFlights;
+}
+
+/**
+ * @brief Gets the values of an id column.
+ *
+ * @param column Any column but Distance.
+ *
+ * @return The first value of the column.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const int32_t *FlightTable::getIds(FlightColumn column) const {
+    switch (column) {
+        case FlightColumn::Source: return source.data();
+        case FlightColumn::Target: return target.data();
+        case FlightColumn::Airline: return airline.data();
+        case FlightColumn::Origin: return sourceCountry.data();
+        default: return targetCountry.data();
+    }
+}
+
+/**
+ * @brief Gets the number of distinct ids of a column.
+ *
+ * @param column Any column but Distance.
+ *
+ * @return The number of airports, airlines or countries.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int FlightTable::getCardinality(FlightColumn column) const {
+    switch (column) {
+        case FlightColumn::Source:
+        case FlightColumn::Target: return (int) airportCodes.size();
+        case FlightColumn::Airline: return (int) airlineCodes.size();
+        default: return (int) countries.size();
+    }
+}
+
+/**
+ * @brief Gets the name of an id of a column.
+ *
+ * @param column Any column but Distance.
+ * @param id The id.
+ *
+ * @return The code of the airport or airline, or the name of the country.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const string &FlightTable::getName(FlightColumn column, int id) const {
+    switch (column) {
+        case FlightColumn::Source:
+        case FlightColumn::Target: return airportCodes[id];
+        case FlightColumn::Airline: return airlineCodes[id];
+        default: return countries[id];
+    }
+}
+
+/**
+ * @brief Builds the bitmask of the rows of a 64-row block equal to an id.
+ *
+ * @param column The first value of the block.
+ * @param value The id.
+ *
+ * @return A mask with bit i set if column[i] == value.
+ *
+ * @info Compares 8 (AVX2) or 4 (SSE2) values per instruction, with a plain loop on other targets.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+uint64_t FlightTable::matchIds(const int32_t *column, int32_t value) {
+    uint64_t res = 0;
+#if defined(__AVX2__)
+    __m256i target = _mm256_set1_epi32(value);
+    for (int i = 0; i < 64; i += 8) {
+        __m256i values = _mm256_loadu_si256((const __m256i *) (column + i));
+        res |= (uint64_t) (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(values, target))) << i;
+    }
+#elif defined(__SSE2__)
+    __m128i target = _mm_set1_epi32(value);
+    for (int i = 0; i < 64; i += 4) {
+        __m128i values = _mm_loadu_si128((const __m128i *) (column + i));
+        res |= (uint64_t) (uint32_t) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(values, target))) << i;
+    }
+#else
+    for (int i = 0; i < 64; i++)
+        res |= (uint64_t) (column[i] == value) << i;
+#endif
+    return res;
+}
+
+/**
+ * @brief Builds the bitmask of the rows of a 64-row block whose distance compares true with a value.
+ *
+ * @param column The first distance of the block.
+ * @param value The compared distance.
+ * @param op The comparison.
+ *
+ * @return A mask with bit i set if the comparison holds for column[i]. NaN (the padding) never matches.
+ *
+ * @info Compares 8 (AVX2) or 4 (SSE2) values per instruction, with a plain loop on other targets.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+uint64_t FlightTable::matchDistances(const float *column, float value, FlightOperator op) {
+    uint64_t res = 0;
+#if defined(__AVX2__)
+    __m256 target = _mm256_set1_ps(value);
+    for (int i = 0; i < 64; i += 8) {
+        __m256 values = _mm256_loadu_ps(column + i), mask;
+        switch (op) {
+            case FlightOperator::Equal: mask = _mm256_cmp_ps(values, target, _CMP_EQ_OQ); break;
+            case FlightOperator::NotEqual: mask = _mm256_cmp_ps(values, target, _CMP_NEQ_OQ); break;
+            case FlightOperator::Less: mask = _mm256_cmp_ps(values, target, _CMP_LT_OQ); break;
+            case FlightOperator::LessEqual: mask = _mm256_cmp_ps(values, target, _CMP_LE_OQ); break;
+            case FlightOperator::Greater: mask = _mm256_cmp_ps(values, target, _CMP_GT_OQ); break;
+            default: mask = _mm256_cmp_ps(values, target, _CMP_GE_OQ);
+        }
+        res |= (uint64_t) (uint32_t) _mm256_movemask_ps(mask) << i;
+    }
+#elif defined(__SSE2__)
+    __m128 target = _mm_set1_ps(value);
+    for (int i = 0; i < 64; i += 4) {
+        __m128 values = _mm_loadu_ps(column + i), mask;
+        switch (op) {
+            case FlightOperator::Equal: mask = _mm_cmpeq_ps(values, target); break;
+            case FlightOperator::NotEqual:
+                mask = _mm_andnot_ps(_mm_cmpunord_ps(values, values), _mm_cmpneq_ps(values, target));
+                break;
+            case FlightOperator::Less: mask = _mm_cmplt_ps(values, target); break;
+            case FlightOperator::LessEqual: mask = _mm_cmple_ps(values, target); break;
+            case FlightOperator::Greater: mask = _mm_cmpgt_ps(values, target); break;
+            default: mask = _mm_cmpge_ps(values, target);
+        }
+        res |= (uint64_t) (uint32_t) _mm_movemask_ps(mask) << i;
+    }
+#else
+    for (int i = 0; i < 64; i++) {
+        float x = column[i];
+        bool match;
+        switch (op) {
+            case FlightOperator::Equal: match = x == value; break;
+            case FlightOperator::NotEqual: match = x == x && x != value; break;
+            case FlightOperator::Less: match = x < value; break;
+            case FlightOperator::LessEqual: match = x <= value; break;
+            case FlightOperator::Greater: match = x > value; break;
+            default: match = x >= value;
+        }
+        res |= (uint64_t) match << i;
+    }
+#endif
+    return res;
+}
+
+/**
+ * @brief Clears from a selection the rows that do not meet a predicate.
+ *
+ * @param predicate The predicate.
+ * @param selection One bit per row, 64 rows per word.
+ *
+ * @info Blocks with no row left are skipped without reading the column.
+ *
+ * @complexity Time Complexity: O(E), where E is the number of flights.
+ */
+void FlightTable::filter(const FlightPredicate &predicate, vector<uint64_t> &selection) const {
+    for (size_t block = 0; block < selection.size(); block++) {
+        if (selection[block] == 0)
+            continue;
+        size_t first = block * 64;
+        uint64_t mask;
+        if (predicate.column == FlightColumn::Distance) {
+            mask = matchDistances(distance.data() + first, predicate.distance, predicate.op);
+        } else {
+            mask = matchIds(getIds(predicate.column) + first, predicate.id);
+            if (predicate.op == FlightOperator::NotEqual)
+                mask = ~mask;
+        }
+        selection[block] &= mask;
+    }
+}
+
+/**
+ * @brief Parses a query.
+ *
+ * @param text The query: an aggregate (count, sum, avg, min or max), then optionally "where" and conditions joined by
+ * "and", "by" and one or two columns, and "top" and a number of groups. A condition is a column, an operator and a
+ * value separated by spaces; values with spaces go between double quotes.
+ * @param query Set to the parsed query.
+ * @param error Set to the reason the query is invalid.
+ *
+ * @return True if the query is valid.
+ *
+ * @complexity Time Complexity: O(n), where n is the length of the text.
+ */
+bool FlightTable::parse(const string &text, FlightQuery &query, string &error) const {
+    vector<string> words;
+    for (size_t i = 0; i < text.size();) {
+        if (isspace((unsigned char) text[i])) {
+            i++;
+        } else if (text[i] == '"') {
+            size_t end = text.find('"', i + 1);
+            if (end == string::npos)
+                end = text.size();
+            words.push_back(text.substr(i + 1, end - i - 1));
+            i = end + 1;
+        } else {
+            size_t end = i;
+            while (end < text.size() && !isspace((unsigned char) text[end]))
+                end++;
+            words.push_back(text.substr(i, end - i));
+            i = end;
+        }
+    }
+
+    const unordered_map<string, FlightAggregate> aggregates = {
+        {"count", FlightAggregate::Count}, {"sum", FlightAggregate::Sum}, {"avg", FlightAggregate::Average},
+        {"min", FlightAggregate::Min}, {"max", FlightAggregate::Max}
+    };
+    const unordered_map<string, FlightColumn> columns = {
+        {"source", FlightColumn::Source}, {"target", FlightColumn::Target}, {"airline", FlightColumn::Airline},
+        {"distance", FlightColumn::Distance}, {"origin", FlightColumn::Origin},
+        {"destination", FlightColumn::Destination}
+    };
+    const unordered_map<string, FlightOperator> operators = {
+        {"=", FlightOperator::Equal}, {"!=", FlightOperator::NotEqual}, {"<", FlightOperator::Less},
+        {"<=", FlightOperator::LessEqual}, {">", FlightOperator::Greater}, {">=", FlightOperator::GreaterEqual}
+    };
+
+    query = FlightQuery();
+    size_t i = 0;
+    if (i < words.size() && aggregates.count(words[i]))
+        query.aggregate = aggregates.at(words[i++]);
+    if (i < words.size() && words[i] == "where") {
+        do {
+            if (i + 3 >= words.size()) {
+                error = "Incomplete condition";
+                return false;
+            }
+            auto column = columns.find(words[i + 1]);
+            auto op = operators.find(words[i + 2]);
+            const string &value = words[i + 3];
+            if (column == columns.end()) {
+                error = "Column " + words[i + 1] + " doesn't exist";
+                return false;
+            }
+            if (op == operators.end()) {
+                error = "Operator " + words[i + 2] + " doesn't exist";
+                return false;
+            }
+            FlightPredicate predicate = {column->second, op->second, -1, 0};
+            if (predicate.column == FlightColumn::Distance) {
+                char *end;
+                predicate.distance = strtof(value.c_str(), &end);
+                if (value.empty() || *end != '\0') {
+                    error = "Distance " + value + " is not a number";
+                    return false;
+                }
+            } else {
+                if (predicate.op != FlightOperator::Equal && predicate.op != FlightOperator::NotEqual) {
+                    error = "Column " + words[i + 1] + " can only be compared with = or !=";
+                    return false;
+                }
+                const unordered_map<string, int> &ids = predicate.column == FlightColumn::Airline ? airlineIds :
+                        predicate.column == FlightColumn::Source || predicate.column == FlightColumn::Target ?
+                        airportIds : countryIds;
+                auto id = ids.find(value);
+                if (id == ids.end()) {
+                    string kind = &ids == &airlineIds ? "Airline " : &ids == &airportIds ? "Airport " : "Country ";
+                    error = kind + value + " doesn't exist";
+                    return false;
+                }
+                predicate.id = id->second;
+            }
+            query.predicates.push_back(predicate);
+            i += 4;
+        } while (i < words.size() && words[i] == "and");
+    }
+    if (i < words.size() && words[i] == "by") {
+        i++;
+        while (i < words.size() && columns.count(words[i]) && query.groups.size() < 2) {
+            if (columns.at(words[i]) == FlightColumn::Distance) {
+                error = "Flights cannot be grouped by distance";
+                return false;
+            }
+            query.groups.push_back(columns.at(words[i++]));
+        }
+        if (query.groups.empty()) {
+            error = "Missing column after by";
+            return false;
+        }
+    }
+    if (i + 1 < words.size() && words[i] == "top") {
+        query.limit = max(atoi(words[i + 1].c_str()), 0);
+        i += 2;
+    }
+    if (i < words.size()) {
+        error = "Unexpected " + words[i];
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs a query and prints its groups, largest first.
+ *
+ * @param query The query.
+ * @param out The stream the groups are written to, followed by the number of matching flights and the time taken.
+ *
+ * @info The predicates are evaluated column by column over 64-row blocks with SIMD compares, each one narrowing a
+ * bitmap of selected rows. The selected rows are then aggregated into a dense array indexed by the group ids when the
+ * groups fit in a few times the number of rows, and otherwise (such as source and target airport pairs) into an
+ * open-addressing hash table sized for the selected rows.
+ *
+ * @complexity Time Complexity: O(P * E + G log N), where P is the number of predicates, E the number of flights, G
+ * the number of groups and N the number of groups printed.
+ */
+void FlightTable::run(const FlightQuery &query, ostream &out) const {
+    struct Group {
+        long long count = 0;
+        double sum = 0, min = 0, max = 0;
+    };
+    auto value = [&query](const Group &group) {
+        switch (query.aggregate) {
+            case FlightAggregate::Count: return (double) group.count;
+            case FlightAggregate::Sum: return group.sum;
+            case FlightAggregate::Average: return group.sum / group.count;
+            case FlightAggregate::Min: return group.min;
+            default: return group.max;
+        }
+    };
+    auto add = [](Group &group, float value) {
+        if (group.count == 0 || value < group.min)
+            group.min = value;
+        if (group.count == 0 || value > group.max)
+            group.max = value;
+        group.count++;
+        group.sum += value;
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<uint64_t> selection(distance.size() / 64, ~0ULL);
+    if (numFlights % 64 != 0)
+        selection.back() = (1ULL << (numFlights % 64)) - 1;
+    for (const auto &predicate : query.predicates)
+        filter(predicate, selection);
+
+    const int32_t *first = query.groups.empty() ? nullptr : getIds(query.groups[0]);
+    const int32_t *second = query.groups.size() < 2 ? nullptr : getIds(query.groups[1]);
+    uint64_t secondSize = query.groups.size() < 2 ? 1 : getCardinality(query.groups[1]);
+    uint64_t keys = query.groups.empty() ? 1 : getCardinality(query.groups[0]) * secondSize;
+
+    vector<pair<double, uint64_t>> groups;
+    long long matched = 0;
+    auto visit = [&](auto accumulate) {
+        for (size_t block = 0; block < selection.size(); block++) {
+            for (uint64_t bits = selection[block]; bits != 0; bits &= bits - 1) {
+                size_t row = block * 64 + __builtin_ctzll(bits);
+                uint64_t key = first == nullptr ? 0 : (uint64_t) first[row] * secondSize;
+                if (second != nullptr)
+                    key += second[row];
+                accumulate(key, distance[row]);
+                matched++;
+            }
+        }
+    };
+    if (keys <= 4 * (uint64_t) max(numFlights, 64)) {
+        vector<Group> dense(keys);
+        visit([&](uint64_t key, float value) { add(dense[key], value); });
+        for (uint64_t key = 0; key < keys; key++) {
+            if (dense[key].count > 0)
+                groups.push_back({value(dense[key]), key});
+        }
+    } else {
+        size_t selected = 0;
+        for (uint64_t bits : selection)
+            selected += __builtin_popcountll(bits);
+        size_t capacity = 16;
+        while (capacity < 2 * selected)
+            capacity <<= 1;
+        vector<uint64_t> slots(capacity, ~0ULL);
+        vector<Group> sparse(capacity);
+        visit([&](uint64_t key, float value) {
+            size_t slot = (key * 0x9E3779B97F4A7C15ULL >> 20) & (capacity - 1);
+            while (slots[slot] != key && slots[slot] != ~0ULL)
+                slot = (slot + 1) & (capacity - 1);
+            slots[slot] = key;
+            add(sparse[slot], value);
+        });
+        for (size_t slot = 0; slot < capacity; slot++) {
+            if (slots[slot] != ~0ULL)
+                groups.push_back({value(sparse[slot]), slots[slot]});
+        }
+    }
+
+    size_t shown = query.limit > 0 ? min<size_t>(query.limit, groups.size()) : groups.size();
+    partial_sort(groups.begin(), groups.begin() + shown, groups.end(), [](const pair<double, uint64_t> &a,
+                                                                          const pair<double, uint64_t> &b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    auto end = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < shown; i++) {
+        uint64_t key = groups[i].second;
+        if (query.groups.empty())
+            out << "All flights";
+        else if (query.groups.size() == 1)
+            out << getName(query.groups[0], (int) key);
+        else
+            out << getName(query.groups[0], (int) (key / secondSize)) << ", "
+                << getName(query.groups[1], (int) (key % secondSize));
+        out << " -- " << groups[i].first << (query.aggregate == FlightAggregate::Count ? " flights" : " km")
+            << endl;
+    }
+    out << matched << " of " << numFlights << " flights matched, " << groups.size() << " groups, in "
+        << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us" << endl;
+}
+
+/**
+ * @brief Parses and runs a query, printing why it is invalid if it cannot be run.
+ *
+ * @param text The query.
+ * @param out The stream the answer is written to.
+ *
+ * @complexity Time Complexity: O(P * E + G log G); see run.
+ */
+void FlightTable::query(const string &text, ostream &out) const {
+    FlightQuery parsed;
+    string error;
+    if (parse(text, parsed, error))
+        run(parsed, out);
+    else
+        out << error << endl;
+}
+
+/**
+ * @brief Prints the syntax of the queries.
+ *
+ * @param out The stream the help is written to.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void FlightTable::showHelp(ostream &out) {
+    out << "count|sum|avg|min|max [where COLUMN OP VALUE [and ...]] [by COLUMN [COLUMN]] [top N]" << endl;
+    out << "Columns: source, target, airline, distance, origin, destination (countries)" << endl;
+    out << "Operators: = != (any column), < <= > >= (distance); sum, avg, min and max are in km" << endl;
+    out << "Example: avg where origin = Portugal and distance > 1000 by airline top 5" << endl;
+}
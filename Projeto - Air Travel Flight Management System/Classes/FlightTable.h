@@ -0,0 +1,90 @@
+
+#ifndef PROJETO2_FLIGHTTABLE_H
+#define PROJETO2_FLIGHTTABLE_H
+
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Airport.h"
+#include "Graph.h"
+#include "GraphSnapshot.h"
+
+enum class FlightColumn {
+    Source,         ///< source airport, by code
+    Target,         ///< target airport, by code
+    Airline,        ///< airline, by code
+    Distance,       ///< length of the flight, in km
+    Origin,         ///< country of the source airport
+    Destination     ///< country of the target airport
+};
+
+enum class FlightOperator {
+    Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual
+};
+
+enum class FlightAggregate {
+    Count,          ///< number of flights
+    Sum,            ///< total km
+    Average,        ///< average km per flight
+    Min,            ///< shortest flight, in km
+    Max             ///< longest flight, in km
+};
+
+struct FlightPredicate {
+    FlightColumn column;        ///< the filtered column
+    FlightOperator op;          ///< the comparison
+    int id;                     ///< the compared airport, airline or country id, for every column but Distance
+    float distance;             ///< the compared length, for the Distance column
+};
+
+struct FlightQuery {
+    FlightAggregate aggregate = FlightAggregate::Count;     ///< what is computed for each group
+    std::vector<FlightPredicate> predicates;                ///< conditions every counted flight meets
+    std::vector<FlightColumn> groups;                       ///< columns the flights are grouped by, at most two
+    int limit = 0;                                          ///< maximum number of groups printed, 0 for all
+};
+
+class FlightTable {
+public:
+    void build(const Graph &graph, const std::unordered_map<std::string, Airport> &airports);
+    void build(const GraphSnapshot &snapshot);
+
+    int getNumFlights() const;
+    bool parse(const std::string &text, FlightQuery &query, std::string &error) const;
+    void run(const FlightQuery &query, std::ostream &out) const;
+    void query(const std::string &text, std::ostream &out) const;
+
+    static void showHelp(std::ostream &out);
+
+private:
+    int numFlights = 0;                                     ///< number of rows
+    std::vector<int32_t> source;                            ///< source airport id of each flight
+    std::vector<int32_t> target;                            ///< target airport id of each flight
+    std::vector<int32_t> airline;                           ///< airline id of each flight
+    std::vector<float> distance;                            ///< length in km of each flight
+    std::vector<int32_t> sourceCountry;                     ///< country id of the source of each flight
+    std::vector<int32_t> targetCountry;                     ///< country id of the target of each flight
+
+    std::vector<std::string> airportCodes;                  ///< code of each airport id
+    std::vector<std::string> airlineCodes;                  ///< code of each airline id
+    std::vector<std::string> countries;                     ///< name of each country id, sorted
+    std::unordered_map<std::string, int> airportIds;        ///< id of each airport code
+    std::unordered_map<std::string, int> airlineIds;        ///< id of each airline code
+    std::unordered_map<std::string, int> countryIds;        ///< id of each country
+
+    void index(const std::vector<std::string> &airportCountries);
+    void pad();
+    const int32_t *getIds(FlightColumn column) const;
+    int getCardinality(FlightColumn column) const;
+    const std::string &getName(FlightColumn column, int id) const;
+    void filter(const FlightPredicate &predicate, std::vector<uint64_t> &selection) const;
+
+    static uint64_t matchIds(const int32_t *column, int32_t value);
+    static uint64_t matchDistances(const float *column, float value, FlightOperator op);
+};
+
+
+#endif //PROJETO2_FLIGHTTABLE_H
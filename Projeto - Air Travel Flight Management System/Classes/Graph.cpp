@@ -3,6 +3,7 @@
 #include "Graph.h"
 #include <iostream>
 #include <climits>
+#include <algorithm>
 
 
 /**
@@ -15,6 +16,7 @@ Vertex::Vertex(string in): info(in) {
     outDegree = 0;
     num = 0;
     low = 0;
+    id = 0;
 }
 
 /**
@@ -24,7 +26,7 @@ Vertex::Vertex(string in): info(in) {
  * @param line The airline associated with the edge.
  * @param w The distance/weight of the edge.
  */
-Edge::Edge(Vertex *d, string line,float w): dest(d), airline(line),distance(w) {}
+Edge::Edge(Vertex *d, string line,float w): dest(d), airline(line),distance(w), airlineId(-1) {}
 
 
 /**
@@ -45,10 +47,48 @@ int Graph::getNumVertex() const {
  *
  * @complexity Time Complexity: O(1)
  */
-vector<Vertex * > Graph::getVertexSet() const {
+const vector<Vertex * > &Graph::getVertexSet() const {
     return vertexSet;
 }
 
+/**
+ * @brief Gets the dense id given to an airline when its first flight was added to the graph.
+ *
+ * @param airline The code of the airline.
+ *
+ * @return The id of the airline (0 .. getNumAirlines() - 1), or -1 if the airline has no flights in the graph.
+ *
+ * @complexity Time Complexity: O(1) average.
+ */
+int Graph::getAirlineId(const string &airline) const {
+    auto it = airlineIds.find(airline);
+    return it == airlineIds.end() ? -1 : it->second;
+}
+
+/**
+ * @brief Gets the code of the airline with a given id.
+ *
+ * @param id The id of the airline.
+ *
+ * @return The code of the airline.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+string Graph::getAirlineCode(int id) const {
+    return airlineCodes[id];
+}
+
+/**
+ * @brief Gets the number of distinct airlines with flights in the graph.
+ *
+ * @return The number of airlines.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int Graph::getNumAirlines() const {
+    return (int) airlineCodes.size();
+}
+
 /**
  * @brief Gets the information/content of the vertex.
  *
@@ -159,6 +199,17 @@ string Edge::getAirline() {
     return airline;
 }
 
+/**
+ * @brief Gets the dense id of the airline associated with the edge.
+ *
+ * @return The id of the airline, as given by Graph::getAirlineId.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int Edge::getAirlineId() const {
+    return airlineId;
+}
+
 /**
  * @brief Constructor for the Graph class.
  *
@@ -181,13 +232,13 @@ Graph::Graph() {
  *
  * @return A pointer to the vertex if found, otherwise nullptr.
  *
- * @complexity Time Complexity: O(V), where V is the number of vertices in the graph.
+ * @complexity Time Complexity: O(1) on average.
  */
 Vertex * Graph::findVertex(const string &in) const {
-    for (auto v : vertexSet)
-        if (v->info == in)
-            return v;
-    return NULL;
+    auto it = vertexIndex.find(in);
+    if (it == vertexIndex.end())
+        return NULL;
+    return it->second;
 }
 
 /**
@@ -287,6 +338,19 @@ void Vertex::setLow(int low) {
     Vertex::low = low;
 }
 
+/**
+ * @brief Gets the id of the vertex, i.e. its position in the vertex set of the graph.
+ *
+ * @return The id of the vertex.
+ *
+ * @info Ids are dense (0 .. V-1), so they can be used to index flat arrays instead of hashing airport codes.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int Vertex::getId() const {
+    return id;
+}
+
 /**
  * @brief Sets the visited state of the vertex.
  *
@@ -327,12 +391,21 @@ void Vertex::setAdj(const vector<Edge> &adj) {
  * @param in The content of the vertex.
  * @return True if successful, false if the vertex already exists.
  *
+ * @info Copies of a graph share its vertices, so the vertex is owned by a pool shared by all of them and deleted along
+ * with the last copy.
+ *
  * Time Complexity: O(1)
  */
 bool Graph::addVertex(const string &in) {
     if ( findVertex(in) != NULL)
         return false;
-    vertexSet.push_back(new Vertex(in));
+    auto v = new Vertex(in);
+    if (!ownedVertices)
+        ownedVertices = make_shared<vector<unique_ptr<Vertex>>>();
+    ownedVertices->emplace_back(v);
+    v->id = (int) vertexSet.size();
+    vertexSet.push_back(v);
+    vertexIndex[in] = v;
     return true;
 }
 
@@ -346,17 +419,38 @@ bool Graph::addVertex(const string &in) {
  * @param w The distance/weight of the edge.
  * @return True if successful, false if the source or destination vertex does not exist.
  *
- * Time Complexity: O(V), where V is the number of vertices in the graph.
+ * Time Complexity: O(1) on average.
  */
 bool Graph::addEdge(const string &sourc, const string &dest,string airline, float w) {
     auto v1 = findVertex(sourc);
     auto v2 = findVertex(dest);
     if (v1 == NULL || v2 == NULL)
         return false;
+    int id = addAirline(airline);
     v1->addEdge(v2,airline,w);
+    v1->adj.back().airlineId = id;
     return true;
 }
 
+/**
+ * @brief Gives an airline the next dense id, if it does not have one yet.
+ *
+ * @param airline The code of the airline.
+ *
+ * @return The id of the airline.
+ *
+ * @info Airlines get their ids in the order of their first flight, so registering them up front in a saved order
+ * reproduces the ids of a graph whose flights are then added in a different order.
+ *
+ * @complexity Time Complexity: O(1) average.
+ */
+int Graph::addAirline(const string &airline) {
+    auto id = airlineIds.insert({airline, (int) airlineCodes.size()});
+    if (id.second)
+        airlineCodes.push_back(airline);
+    return id.first->second;
+}
+
 /**
  * @brief Adds an outgoing edge to a vertex with a given destination vertex and edge distance.
  *
@@ -388,6 +482,24 @@ bool Graph::removeEdge(const string &sourc, const string &dest) {
     return v1->removeEdgeTo(v2);
 }
 
+/**
+ * @brief Removes a flight of a given airline from the graph.
+ *
+ * @param sourc The source vertex content.
+ * @param dest The destination vertex content.
+ * @param airline The airline of the flight.
+ * @return True if successful, false if there is no such flight.
+ *
+ * Time Complexity: O(d), where d is the number of outgoing edges of the source.
+ */
+bool Graph::removeEdge(const string &sourc, const string &dest, const string &airline) {
+    auto v1 = findVertex(sourc);
+    auto v2 = findVertex(dest);
+    if (v1 == NULL || v2 == NULL)
+        return false;
+    return v1->removeEdgeTo(v2, airline);
+}
+
 /**
  * @brief Removes an outgoing edge from a vertex.
  *
@@ -405,6 +517,24 @@ bool Vertex::removeEdgeTo(Vertex *d) {
     return false;
 }
 
+/**
+ * @brief Removes an outgoing edge of a given airline from a vertex.
+ *
+ * @param d The destination vertex.
+ * @param airline The airline of the edge.
+ * @return True if successful, false if the edge does not exist.
+ *
+ * Time Complexity: O(d), where d is the number of outgoing edges of the vertex.
+ */
+bool Vertex::removeEdgeTo(Vertex *d, const string &airline) {
+    for (auto it = adj.begin(); it != adj.end(); it++)
+        if (it->dest == d && it->airline == airline) {
+            adj.erase(it);
+            return true;
+        }
+    return false;
+}
+
 
 /**
  * @brief Removes a vertex and all its outgoing and incoming edges from the graph.
@@ -419,9 +549,13 @@ bool Graph::removeVertex(const string &in) {
         if ((*it)->info  == in) {
             auto v = *it;
             vertexSet.erase(it);
+            vertexIndex.erase(in);
             for (auto u : vertexSet)
                 u->removeEdgeTo(v);
-            delete v;
+            for (int i = 0; i < (int) vertexSet.size(); i++)
+                vertexSet[i]->id = i;
+            auto &owned = *ownedVertices;
+            owned.erase(find_if(owned.begin(), owned.end(), [v](const unique_ptr<Vertex> &p) { return p.get() == v; }));
             return true;
         }
     return false;
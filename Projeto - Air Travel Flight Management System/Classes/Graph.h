@@ -3,6 +3,7 @@
 #ifndef PROJETO2_GRAPH_H
 #define PROJETO2_GRAPH_H
 #include <cstddef>
+#include <memory>
 #include <vector>
 #include <queue>
 #include <stack>
@@ -30,10 +31,12 @@ class Vertex {
     int outDegree;         ///< auxiliary field
     int num;               ///< auxiliary field
     int low;               ///< auxiliary field
+    int id;                ///< position of the vertex in the vertex set
 
 
     void addEdge(Vertex *dest,string airline, float w);
     bool removeEdgeTo(Vertex *d);
+    bool removeEdgeTo(Vertex *d, const string &airline);
 public:
     Vertex(string in);
     string getInfo() const;
@@ -58,6 +61,8 @@ public:
 
     void setLow(int low);
 
+    int getId() const;
+
     friend class Graph;
 };
 
@@ -66,6 +71,7 @@ class Edge {
     Vertex * dest;      // destination vertex
     float distance;         // edge distance
     string airline;
+    int airlineId;          // dense id of the airline in the graph
 public:
     Edge(Vertex *d, string airline,float w);
     Vertex *getDest() const;
@@ -77,6 +83,7 @@ public:
 
     void setAirline(string line);
     string getAirline();
+    int getAirlineId() const;
 };
 
 
@@ -85,6 +92,10 @@ class Graph {
     int _index_;                        // auxiliary field
     stack<Vertex> _stack_;           // auxiliary field
     list<list<string>> _list_sccs_;        // auxiliary field
+    unordered_map<string, int> airlineIds;  // dense id of each airline code
+    vector<string> airlineCodes;            // airline code of each id
+    unordered_map<string, Vertex *> vertexIndex;    // vertex of each airport code
+    shared_ptr<vector<unique_ptr<Vertex>>> ownedVertices;   // every vertex, shared by all copies, freed with the last
 
     bool dfsIsDAG(Vertex *v) const;
 public:
@@ -93,8 +104,13 @@ public:
     bool addVertex(const string &in);
     bool removeVertex(const string &in);
     bool addEdge(const string &sourc, const string &dest, string airline,float w);
+    int addAirline(const string &airline);
     bool removeEdge(const string &sourc, const string &dest);
-    vector<Vertex * > getVertexSet() const;
+    bool removeEdge(const string &sourc, const string &dest, const string &airline);
+    const vector<Vertex * > &getVertexSet() const;
+    int getAirlineId(const string &airline) const;
+    string getAirlineCode(int id) const;
+    int getNumAirlines() const;
     vector<string> dfs() const;
     void dfsVisit(Vertex *v,  vector<string> & res) const;
     vector<string> dfs(const string & source) const;
@@ -0,0 +1,598 @@
+
+#include "GraphSnapshot.h"
+#include "DurableFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Constructor for the GraphSnapshot class. The snapshot starts empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+GraphSnapshot::GraphSnapshot() {}
+
+/**
+ * @brief Move constructor. The image (owned or mapped) is handed over to the new object.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+GraphSnapshot::GraphSnapshot(GraphSnapshot &&other) noexcept {
+    *this = move(other);
+}
+
+/**
+ * @brief Move assignment. Releases the current image and takes over the image of another snapshot.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+GraphSnapshot &GraphSnapshot::operator=(GraphSnapshot &&other) noexcept {
+    if (this == &other)
+        return *this;
+    release();
+    owned = move(other.owned);
+    mapping = other.mapping;
+    mappingSize = other.mappingSize;
+    header = other.header;
+    coordinates = other.coordinates;
+    distances = other.distances;
+    airportStrings = other.airportStrings;
+    readOrder = other.readOrder;
+    airportsByCode = other.airportsByCode;
+    airlineStrings = other.airlineStrings;
+    airlinesByCode = other.airlinesByCode;
+    firstFlight = other.firstFlight;
+    targets = other.targets;
+    flightAirlines = other.flightAirlines;
+    strings = other.strings;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+    other.header = nullptr;
+    return *this;
+}
+
+/**
+ * @brief Destructor. Unmaps the snapshot file, if it was mapped.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+GraphSnapshot::~GraphSnapshot() {
+    release();
+}
+
+/**
+ * @brief Drops the current image.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void GraphSnapshot::release() {
+#ifndef _WIN32
+    if (mapping != nullptr)
+        munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    owned.clear();
+    header = nullptr;
+}
+
+/**
+ * @brief Points the arrays of the snapshot into an image, after checking that it is complete.
+ *
+ * @param image The image, in the snapshot file format.
+ * @param size The size of the image, in bytes.
+ *
+ * @return True if the image is valid.
+ *
+ * @info The image only holds indexes and offsets, never pointers: a flight names its target by airport number and
+ * every string by its offset in the pool. It works at any address, so every process can map the same file wherever
+ * its address space has room and all of them share the same physical pages. Since the file may have been damaged or
+ * written by another build, every index and offset is checked to be in range, and the pool to end in a terminator,
+ * before anything reads through them.
+ *
+ * @complexity Time Complexity: O(V + A + E + S), where V is the number of airports, A the number of airlines, E the
+ * number of flights and S the size of the string pool.
+ */
+bool GraphSnapshot::attach(const char *image, size_t size) {
+    if (size < sizeof(Header))
+        return false;
+    const Header *h = reinterpret_cast<const Header *>(image);
+    if (memcmp(h->magic, "FMSGRF2", 8) != 0 || h->numFlightAirlines > h->numAirlines)
+        return false;
+    size_t V = h->numAirports, A = h->numAirlines, E = h->numFlights;
+    size_t distanceBytes = (4 * E + 7) / 8 * 8;
+    size_t expected = sizeof(Header) + 16 * V + distanceBytes + 4 * (4 * V + V + V + 4 * A + A + V + 1 + E + E)
+                      + h->stringBytes;
+    if (size != expected)
+        return false;
+
+    header = h;
+    coordinates = reinterpret_cast<const double *>(image + sizeof(Header));
+    distances = reinterpret_cast<const float *>(coordinates + 2 * V);
+    airportStrings = reinterpret_cast<const uint32_t *>(image + sizeof(Header) + 16 * V + distanceBytes);
+    readOrder = airportStrings + 4 * V;
+    airportsByCode = readOrder + V;
+    airlineStrings = airportsByCode + V;
+    airlinesByCode = airlineStrings + 4 * A;
+    firstFlight = airlinesByCode + A;
+    targets = firstFlight + V + 1;
+    flightAirlines = targets + E;
+    strings = reinterpret_cast<const char *>(flightAirlines + E);
+
+    bool valid = firstFlight[0] == 0 && firstFlight[V] == E;
+    valid = valid && (h->stringBytes == 0 || strings[h->stringBytes - 1] == 0);
+    for (size_t i = 0; valid && i < V; i++)
+        valid = firstFlight[i] <= firstFlight[i + 1] && readOrder[i] < V && airportsByCode[i] < V;
+    for (size_t i = 0; valid && i < E; i++)
+        valid = targets[i] < V && flightAirlines[i] < h->numFlightAirlines;
+    for (size_t i = 0; valid && i < A; i++)
+        valid = airlinesByCode[i] < A;
+    for (size_t i = 0; valid && i < 4 * V; i++)
+        valid = airportStrings[i] < h->stringBytes;
+    for (size_t i = 0; valid && i < 4 * A; i++)
+        valid = airlineStrings[i] < h->stringBytes;
+    if (!valid)
+        header = nullptr;
+    return valid;
+}
+
+/**
+ * @brief Builds the snapshot in memory.
+ *
+ * @param graph The flights graph.
+ * @param airports The airports, by code.
+ * @param airlines The airlines, by code.
+ * @param order The codes of the airports in the order they were read, so the catalog can be rebuilt identically.
+ * @param fingerprint Identifies the dataset, so a saved snapshot can be checked against it later.
+ * @param sequence The number of schedule changes applied to the graph since the dataset was read.
+ *
+ * @info Airports keep the ids of the graph vertices and airlines the ids of the graph, followed by the airlines with no
+ * flights. The flights are laid out in compressed sparse row form: the flights of an airport are contiguous, in the
+ * same order as its adjacency list.
+ *
+ * @complexity Time Complexity: O(V log V + A log A + E), where V is the number of airports, A the number of airlines
+ * and E the number of flights.
+ */
+void GraphSnapshot::build(const Graph &graph, const unordered_map<string, Airport> &airports,
+                          const unordered_map<string, Airline> &airlines, const vector<string> &order,
+                          uint64_t fingerprint, uint64_t sequence) {
+    const vector<Vertex *> &vertices = graph.getVertexSet();
+    string pool;
+    auto intern = [&pool](const string &text) {
+        uint32_t offset = (uint32_t) pool.size();
+        pool += text + '\0';
+        return offset;
+    };
+
+    vector<double> coordinateValues;
+    vector<uint32_t> airportWords, orderWords, airportIds(vertices.size());
+    for (auto vertex : vertices) {
+        const Airport &airport = airports.find(vertex->getInfo())->second;
+        coordinateValues.push_back(airport.getPosition().getLatitude());
+        coordinateValues.push_back(airport.getPosition().getLongitude());
+        airportWords.push_back(intern(airport.getCode()));
+        airportWords.push_back(intern(airport.getName()));
+        airportWords.push_back(intern(airport.getCity()));
+        airportWords.push_back(intern(airport.getCountry()));
+    }
+    for (const auto &code : order)
+        orderWords.push_back((uint32_t) graph.findVertex(code)->getId());
+    for (uint32_t i = 0; i < airportIds.size(); i++)
+        airportIds[i] = i;
+    sort(airportIds.begin(), airportIds.end(), [&vertices](uint32_t a, uint32_t b) {
+        return vertices[a]->getInfo() < vertices[b]->getInfo();
+    });
+
+    vector<string> airlineCodes;
+    for (int id = 0; id < graph.getNumAirlines(); id++)
+        airlineCodes.push_back(graph.getAirlineCode(id));
+    vector<string> unused;
+    for (const auto &airline : airlines) {
+        if (graph.getAirlineId(airline.first) < 0)
+            unused.push_back(airline.first);
+    }
+    sort(unused.begin(), unused.end());
+    airlineCodes.insert(airlineCodes.end(), unused.begin(), unused.end());
+    vector<uint32_t> airlineWords, airlineIds(airlineCodes.size());
+    for (const auto &code : airlineCodes) {
+        auto it = airlines.find(code);
+        airlineWords.push_back(intern(code));
+        airlineWords.push_back(intern(it == airlines.end() ? "" : it->second.getName()));
+        airlineWords.push_back(intern(it == airlines.end() ? "" : it->second.getCallsign()));
+        airlineWords.push_back(intern(it == airlines.end() ? "" : it->second.getCountry()));
+    }
+    for (uint32_t i = 0; i < airlineIds.size(); i++)
+        airlineIds[i] = i;
+    sort(airlineIds.begin(), airlineIds.end(), [&airlineCodes](uint32_t a, uint32_t b) {
+        return airlineCodes[a] < airlineCodes[b];
+    });
+
+    vector<uint32_t> firstWords, targetWords, airlineOfFlight;
+    vector<float> distanceValues;
+    for (auto vertex : vertices) {
+        firstWords.push_back((uint32_t) targetWords.size());
+        for (const auto &edge : vertex->getAdj()) {
+            targetWords.push_back((uint32_t) edge.getDest()->getId());
+            airlineOfFlight.push_back((uint32_t) edge.getAirlineId());
+            distanceValues.push_back(edge.getDistance());
+        }
+    }
+    firstWords.push_back((uint32_t) targetWords.size());
+    distanceValues.resize((distanceValues.size() + 1) / 2 * 2, 0);
+
+    Header h = {};
+    memcpy(h.magic, "FMSGRF2", 8);
+    h.fingerprint = fingerprint;
+    h.sequence = sequence;
+    h.numAirports = (uint32_t) vertices.size();
+    h.numAirlines = (uint32_t) airlineCodes.size();
+    h.numFlightAirlines = (uint32_t) graph.getNumAirlines();
+    h.numFlights = (uint32_t) targetWords.size();
+    h.stringBytes = (uint32_t) pool.size();
+
+    release();
+    auto append = [this](const void *data, size_t bytes) {
+        owned.insert(owned.end(), (const char *) data, (const char *) data + bytes);
+    };
+    append(&h, sizeof(h));
+    append(coordinateValues.data(), 8 * coordinateValues.size());
+    append(distanceValues.data(), 4 * distanceValues.size());
+    append(airportWords.data(), 4 * airportWords.size());
+    append(orderWords.data(), 4 * orderWords.size());
+    append(airportIds.data(), 4 * airportIds.size());
+    append(airlineWords.data(), 4 * airlineWords.size());
+    append(airlineIds.data(), 4 * airlineIds.size());
+    append(firstWords.data(), 4 * firstWords.size());
+    append(targetWords.data(), 4 * targetWords.size());
+    append(airlineOfFlight.data(), 4 * airlineOfFlight.size());
+    append(pool.data(), pool.size());
+    attach(owned.data(), owned.size());
+}
+
+/**
+ * @brief Writes the snapshot to a file.
+ *
+ * @param filename The path of the file.
+ *
+ * @return True if the file was written.
+ *
+ * @info The image is written to a temporary file that is then renamed over the old one, so a process that maps the
+ * file at the same time sees either the old snapshot or the new one, never half of each. Processes that already mapped
+ * the old file keep it until they unmap it. The file and its directory are fsynced before returning, so the caller can
+ * drop whatever the snapshot replaces.
+ *
+ * @complexity Time Complexity: O(S), where S is the size of the image.
+ */
+bool GraphSnapshot::save(const string &filename) const {
+    if (header == nullptr)
+        return false;
+    return replaceFile(filename, reinterpret_cast<const char *>(header), getSize());
+}
+
+/**
+ * @brief Memory-maps the snapshot from a file.
+ *
+ * @param filename The path of the file.
+ * @param fingerprint The fingerprint of the current dataset.
+ *
+ * @return True if the file exists, is valid and was built from the same dataset. Otherwise the snapshot is left empty.
+ *
+ * @info The mapping is shared and read-only: the arrays point straight into the page cache, so every process that maps
+ * the file uses the same physical memory. Loading only reads the indexes once, to check them, and never copies the
+ * image. Systems without mmap read the file instead.
+ *
+ * @complexity Time Complexity: O(S), where S is the size of the file.
+ */
+bool GraphSnapshot::load(const string &filename, uint64_t fingerprint) {
+    release();
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void *address = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+        return false;
+    mapping = address;
+    mappingSize = (size_t) info.st_size;
+    bool valid = attach((const char *) mapping, mappingSize);
+#else
+    ifstream in(filename, ios::binary);
+    if (!in)
+        return false;
+    owned.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    bool valid = attach(owned.data(), owned.size());
+#endif
+    if (!valid || header->fingerprint != fingerprint) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if the snapshot is served from a memory-mapped file.
+ *
+ * @return True if the snapshot is mapped, false if it lives in memory (or is empty).
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool GraphSnapshot::isMapped() const {
+    return mapping != nullptr;
+}
+
+/**
+ * @brief Checks if the snapshot holds no image.
+ *
+ * @return True if nothing was built or loaded.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool GraphSnapshot::isEmpty() const {
+    return header == nullptr;
+}
+
+/**
+ * @brief Gets the size of the image.
+ *
+ * @return The size, in bytes.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+size_t GraphSnapshot::getSize() const {
+    if (header == nullptr)
+        return 0;
+    return mapping != nullptr ? mappingSize : owned.size();
+}
+
+/**
+ * @brief Gets the fingerprint of the dataset the snapshot was built from.
+ *
+ * @return The fingerprint, or 0 if the snapshot is empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+uint64_t GraphSnapshot::getFingerprint() const {
+    return header == nullptr ? 0 : header->fingerprint;
+}
+
+/**
+ * @brief Gets the number of schedule changes folded into the snapshot.
+ *
+ * @return The sequence number of the last change, or 0 if the snapshot is the dataset as read.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+uint64_t GraphSnapshot::getSequence() const {
+    return header == nullptr ? 0 : header->sequence;
+}
+
+/**
+ * @brief Gets the number of airports.
+ *
+ * @return The number of airports.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getNumAirports() const {
+    return header == nullptr ? 0 : (int) header->numAirports;
+}
+
+/**
+ * @brief Gets the number of airlines, with or without flights.
+ *
+ * @return The number of airlines.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getNumAirlines() const {
+    return header == nullptr ? 0 : (int) header->numAirlines;
+}
+
+/**
+ * @brief Gets the number of airlines with flights. They are numbered first, with the same ids as in the graph.
+ *
+ * @return The number of airlines with flights.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getNumFlightAirlines() const {
+    return header == nullptr ? 0 : (int) header->numFlightAirlines;
+}
+
+/**
+ * @brief Gets the number of flights.
+ *
+ * @return The number of flights.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getNumFlights() const {
+    return header == nullptr ? 0 : (int) header->numFlights;
+}
+
+/**
+ * @brief Finds an airport by its code.
+ *
+ * @param code The code of the airport.
+ *
+ * @return The id of the airport, or -1 if it does not exist.
+ *
+ * @complexity Time Complexity: O(log V), where V is the number of airports.
+ */
+int GraphSnapshot::findAirport(const string &code) const {
+    const uint32_t *first = airportsByCode, *last = airportsByCode + getNumAirports();
+    const uint32_t *it = lower_bound(first, last, code, [this](uint32_t airport, const string &key) {
+        return strcmp(getAirportCode((int) airport), key.c_str()) < 0;
+    });
+    if (it == last || code != getAirportCode((int) *it))
+        return -1;
+    return (int) *it;
+}
+
+/**
+ * @brief Gets the airports in the order they were read from the dataset.
+ *
+ * @param i The position in the dataset (0 .. getNumAirports() - 1).
+ *
+ * @return The id of the i-th airport read.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getAirportInReadOrder(int i) const {
+    return (int) readOrder[i];
+}
+
+/**
+ * @brief Gets the code of an airport, without copying it.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return The code, inside the snapshot.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const char *GraphSnapshot::getAirportCode(int airport) const {
+    return strings + airportStrings[4 * (size_t) airport];
+}
+
+/**
+ * @brief Gets an airport.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return A copy of the airport.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Airport GraphSnapshot::getAirport(int airport) const {
+    const uint32_t *words = airportStrings + 4 * (size_t) airport;
+    return Airport(strings + words[0], strings + words[1], strings + words[2], strings + words[3],
+                   coordinates[2 * (size_t) airport], coordinates[2 * (size_t) airport + 1]);
+}
+
+/**
+ * @brief Finds an airline by its code.
+ *
+ * @param code The code of the airline.
+ *
+ * @return The id of the airline, or -1 if it does not exist.
+ *
+ * @complexity Time Complexity: O(log A), where A is the number of airlines.
+ */
+int GraphSnapshot::findAirline(const string &code) const {
+    const uint32_t *first = airlinesByCode, *last = airlinesByCode + getNumAirlines();
+    const uint32_t *it = lower_bound(first, last, code, [this](uint32_t airline, const string &key) {
+        return strcmp(getAirlineCode((int) airline), key.c_str()) < 0;
+    });
+    if (it == last || code != getAirlineCode((int) *it))
+        return -1;
+    return (int) *it;
+}
+
+/**
+ * @brief Gets the code of an airline, without copying it.
+ *
+ * @param airline The id of the airline.
+ *
+ * @return The code, inside the snapshot.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const char *GraphSnapshot::getAirlineCode(int airline) const {
+    return strings + airlineStrings[4 * (size_t) airline];
+}
+
+/**
+ * @brief Gets an airline.
+ *
+ * @param airline The id of the airline.
+ *
+ * @return A copy of the airline.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+Airline GraphSnapshot::getAirline(int airline) const {
+    const uint32_t *words = airlineStrings + 4 * (size_t) airline;
+    return Airline(strings + words[0], strings + words[1], strings + words[2], strings + words[3]);
+}
+
+/**
+ * @brief Gets the first flight out of an airport.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return The id of its first flight. The flights of an airport are getFirstFlight .. getLastFlight - 1.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getFirstFlight(int airport) const {
+    return (int) firstFlight[airport];
+}
+
+/**
+ * @brief Gets the end of the flights out of an airport.
+ *
+ * @param airport The id of the airport.
+ *
+ * @return One past the id of its last flight.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getLastFlight(int airport) const {
+    return (int) firstFlight[airport + 1];
+}
+
+/**
+ * @brief Gets the target of a flight.
+ *
+ * @param flight The id of the flight.
+ *
+ * @return The id of the target airport.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getFlightTarget(int flight) const {
+    return (int) targets[flight];
+}
+
+/**
+ * @brief Gets the airline of a flight.
+ *
+ * @param flight The id of the flight.
+ *
+ * @return The id of the airline.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphSnapshot::getFlightAirline(int flight) const {
+    return (int) flightAirlines[flight];
+}
+
+/**
+ * @brief Gets the length of a flight.
+ *
+ * @param flight The id of the flight.
+ *
+ * @return The great-circle distance between both airports, in km.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+float GraphSnapshot::getFlightDistance(int flight) const {
+    return distances[flight];
+}
@@ -0,0 +1,90 @@
+
+#ifndef PROJETO2_GRAPHSNAPSHOT_H
+#define PROJETO2_GRAPHSNAPSHOT_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Airline.h"
+#include "Airport.h"
+#include "Graph.h"
+
+class GraphSnapshot {
+public:
+    GraphSnapshot();
+    GraphSnapshot(GraphSnapshot &&other) noexcept;
+    GraphSnapshot &operator=(GraphSnapshot &&other) noexcept;
+    GraphSnapshot(const GraphSnapshot &) = delete;
+    GraphSnapshot &operator=(const GraphSnapshot &) = delete;
+    ~GraphSnapshot();
+
+    void build(const Graph &graph, const std::unordered_map<std::string, Airport> &airports,
+               const std::unordered_map<std::string, Airline> &airlines, const std::vector<std::string> &readOrder,
+               std::uint64_t fingerprint, std::uint64_t sequence = 0);
+    bool save(const std::string &filename) const;
+    bool load(const std::string &filename, std::uint64_t fingerprint);
+    bool isMapped() const;
+    bool isEmpty() const;
+    std::size_t getSize() const;
+    std::uint64_t getFingerprint() const;
+    std::uint64_t getSequence() const;
+
+    int getNumAirports() const;
+    int getNumAirlines() const;
+    int getNumFlightAirlines() const;
+    int getNumFlights() const;
+
+    int findAirport(const std::string &code) const;
+    int getAirportInReadOrder(int i) const;
+    const char *getAirportCode(int airport) const;
+    Airport getAirport(int airport) const;
+
+    int findAirline(const std::string &code) const;
+    const char *getAirlineCode(int airline) const;
+    Airline getAirline(int airline) const;
+
+    int getFirstFlight(int airport) const;
+    int getLastFlight(int airport) const;
+    int getFlightTarget(int flight) const;
+    int getFlightAirline(int flight) const;
+    float getFlightDistance(int flight) const;
+
+private:
+    struct Header {
+        char magic[8];                      ///< "FMSGRF2" and a zero byte
+        std::uint64_t fingerprint;          ///< identifies the dataset the snapshot was built from
+        std::uint64_t sequence;             ///< number of schedule changes folded into the snapshot
+        std::uint32_t numAirports;          ///< number of airports, numbered as the vertices of the graph
+        std::uint32_t numAirlines;          ///< number of airlines, the ones with flights first, numbered as in the graph
+        std::uint32_t numFlightAirlines;    ///< number of airlines with flights
+        std::uint32_t numFlights;           ///< number of flights
+        std::uint32_t stringBytes;          ///< size of the string pool
+        std::uint32_t reserved;             ///< keeps the arrays 8-byte aligned
+    };
+
+    std::vector<char> owned;            ///< the image, when built in memory or read without mmap
+    void *mapping = nullptr;            ///< the image, when memory-mapped
+    std::size_t mappingSize = 0;        ///< size of the mapping
+
+    const Header *header = nullptr;                 ///< header of the image
+    const double *coordinates = nullptr;            ///< latitude and longitude of each airport
+    const float *distances = nullptr;               ///< length of each flight, in km
+    const std::uint32_t *airportStrings = nullptr;  ///< per airport: code, name, city and country offsets
+    const std::uint32_t *readOrder = nullptr;       ///< airports in the order they were read from the dataset
+    const std::uint32_t *airportsByCode = nullptr;  ///< airports sorted by code
+    const std::uint32_t *airlineStrings = nullptr;  ///< per airline: code, name, callsign and country offsets
+    const std::uint32_t *airlinesByCode = nullptr;  ///< airlines sorted by code
+    const std::uint32_t *firstFlight = nullptr;     ///< first flight of each airport, plus one past the last flight
+    const std::uint32_t *targets = nullptr;         ///< target airport of each flight
+    const std::uint32_t *flightAirlines = nullptr;  ///< airline of each flight
+    const char *strings = nullptr;                  ///< the string pool, zero-terminated strings
+
+    bool attach(const char *image, std::size_t size);
+    void release();
+};
+
+
+#endif //PROJETO2_GRAPHSNAPSHOT_H
@@ -0,0 +1,69 @@
+
+#include "GraphView.h"
+
+using namespace std;
+
+/**
+ * @brief Constructor for a view over the whole graph.
+ *
+ * @param graph The graph to view.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+GraphView::GraphView(const Graph &graph) : graph(&graph) {}
+
+/**
+ * @brief Constructor for a view restricted to the flights of some airlines.
+ *
+ * @param graph The graph to view.
+ * @param airlines The ids (see Graph::getAirlineId) of the airlines whose flights belong to the view.
+ *
+ * @info Vertices and edges are not copied: the view only keeps a bit per airline and filters edges while they are
+ * traversed, so building a view for every airline is cheap.
+ *
+ * @complexity Time Complexity: O(A), where A is the number of airlines in the graph.
+ */
+GraphView::GraphView(const Graph &graph, const vector<int> &airlines)
+        : graph(&graph), airlineMask(graph.getNumAirlines(), false) {
+    for (int id : airlines)
+        if (id >= 0 && id < (int) airlineMask.size())
+            airlineMask[id] = true;
+}
+
+/**
+ * @brief Gets the viewed graph.
+ *
+ * @return The graph.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const Graph &GraphView::getGraph() const {
+    return *graph;
+}
+
+/**
+ * @brief Gets the number of vertices of the viewed graph. Vertex ids of the view are the ids of the graph.
+ *
+ * @return The number of vertices.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int GraphView::getNumVertex() const {
+    return graph->getNumVertex();
+}
+
+/**
+ * @brief Checks if an edge belongs to the view.
+ *
+ * @param edge The edge.
+ *
+ * @return True if the view is unrestricted or the airline of the edge is one of the airlines of the view.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool GraphView::includes(const Edge &edge) const {
+    if (airlineMask.empty())
+        return true;
+    int id = edge.getAirlineId();
+    return id >= 0 && id < (int) airlineMask.size() && airlineMask[id];
+}
@@ -0,0 +1,39 @@
+
+#ifndef PROJETO2_GRAPHVIEW_H
+#define PROJETO2_GRAPHVIEW_H
+
+
+#include <vector>
+#include "Graph.h"
+
+class GraphView {
+public:
+    GraphView(const Graph &graph);
+    GraphView(const Graph &graph, const std::vector<int> &airlines);
+
+    const Graph &getGraph() const;
+    int getNumVertex() const;
+    bool includes(const Edge &edge) const;
+
+    /**
+     * @brief Calls f(edge) for every outgoing edge of a vertex that belongs to the view.
+     *
+     * @param v The vertex.
+     * @param f The function to call.
+     *
+     * @complexity Time Complexity: O(deg(v)), where deg(v) is the number of outgoing edges of v in the whole graph.
+     */
+    template <typename F>
+    void forEachEdge(const Vertex *v, F f) const {
+        for (const auto &edge : v->getAdj())
+            if (includes(edge))
+                f(edge);
+    }
+
+private:
+    const Graph *graph;                 ///< the viewed graph, which is never copied
+    std::vector<bool> airlineMask;      ///< airlines whose flights belong to the view (empty means every airline)
+};
+
+
+#endif //PROJETO2_GRAPHVIEW_H
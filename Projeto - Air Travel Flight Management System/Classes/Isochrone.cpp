@@ -0,0 +1,64 @@
+
+#include "Isochrone.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+/**
+ * @brief Finds every airport reachable from a source within a budget of flown kilometers.
+ *
+ * @param view The network where the trip is made.
+ * @param source The vertex id of the source airport.
+ * @param budget The maximum total flown distance, in km.
+ *
+ * @return The reachable airports (including the source) by increasing distance, each with its smallest flown distance
+ * and the number of flights of that trip.
+ *
+ * @info Dijkstra's algorithm over Edge::distance with a radix heap, which never pushes a vertex beyond the budget.
+ * The scratch arrays are kept between queries and only the vertices touched by the previous query are reset, so a
+ * small isochrone costs time proportional to its size rather than to the whole graph.
+ *
+ * @complexity Time Complexity: O(E' + V' log C), where V' and E' are the vertices and edges within the budget and C the
+ * range of the keys of the heap.
+ */
+vector<IsochroneEntry> Isochrone::query(const GraphView &view, int source, double budget) {
+    const auto &vertices = view.getGraph().getVertexSet();
+    if (distance.size() != vertices.size()) {
+        distance.assign(vertices.size(), numeric_limits<double>::infinity());
+        flights.assign(vertices.size(), 0);
+        touched.clear();
+    }
+    for (int v : touched)
+        distance[v] = numeric_limits<double>::infinity();
+    touched.clear();
+    heap.clear();
+
+    vector<IsochroneEntry> res;
+    if (budget < 0)
+        return res;
+
+    distance[source] = 0;
+    flights[source] = 0;
+    touched.push_back(source);
+    heap.push(0, source);
+    while (!heap.empty()) {
+        auto top = heap.pop();
+        int v = top.second;
+        if (top.first > distance[v])
+            continue;
+        res.push_back({v, top.first, flights[v]});
+        view.forEachEdge(vertices[v], [&](const Edge &edge) {
+            int w = edge.getDest()->getId();
+            double d = top.first + edge.getDistance();
+            if (d <= budget && d < distance[w]) {
+                if (distance[w] == numeric_limits<double>::infinity())
+                    touched.push_back(w);
+                distance[w] = d;
+                flights[w] = flights[v] + 1;
+                heap.push(d, w);
+            }
+        });
+    }
+    return res;
+}
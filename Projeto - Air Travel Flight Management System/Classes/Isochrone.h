@@ -0,0 +1,28 @@
+
+#ifndef PROJETO2_ISOCHRONE_H
+#define PROJETO2_ISOCHRONE_H
+
+
+#include <vector>
+#include "GraphView.h"
+#include "RadixHeap.h"
+
+struct IsochroneEntry {
+    int airport;        ///< vertex id of the reachable airport
+    double km;          ///< smallest flown distance from the source
+    int flights;        ///< flights of that smallest-distance trip
+};
+
+class Isochrone {
+public:
+    std::vector<IsochroneEntry> query(const GraphView &view, int source, double budget);
+
+private:
+    std::vector<double> distance;   ///< scratch: best distance found so far for each vertex
+    std::vector<int> flights;       ///< scratch: flights of the best trip found so far for each vertex
+    std::vector<int> touched;       ///< scratch: vertices whose distance is not infinity
+    RadixHeap heap;                 ///< scratch: priority queue of the search
+};
+
+
+#endif //PROJETO2_ISOCHRONE_H
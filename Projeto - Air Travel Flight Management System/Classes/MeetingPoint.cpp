@@ -0,0 +1,125 @@
+
+#include "MeetingPoint.h"
+#include "NetworkStatistics.h"
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the MeetingPoint class.
+ *
+ * @param view The network where the group travels (usually the whole flights graph).
+ *
+ * @complexity Time Complexity: O(1)
+ */
+MeetingPoint::MeetingPoint(const GraphView &view) : view(view) {}
+
+/**
+ * @brief Accumulates the distances from every origin with one BFS per origin.
+ *
+ * @param origins The vertex ids of the origins.
+ *
+ * @complexity Time Complexity: O(N * (V + E)), where N is the number of origins.
+ */
+void MeetingPoint::accumulatePerOrigin(const vector<int> &origins) {
+    vector<int> distance, queue;
+    for (int origin : origins) {
+        NetworkStatistics::bfs(view, origin, distance, queue);
+        for (int v : queue) {
+            maxDistance[v] = max(maxDistance[v], distance[v]);
+            sumDistance[v] += distance[v];
+            reached[v]++;
+        }
+    }
+}
+
+/**
+ * @brief Accumulates the distances from up to 64 origins with a single bit-parallel BFS.
+ *
+ * @param origins The vertex ids of the origins (at most 64).
+ *
+ * @complexity Time Complexity: O(D * (V + E)), where D is the number of levels (at most the diameter).
+ */
+void MeetingPoint::accumulateBitParallel(const vector<int> &origins) {
+    NetworkStatistics::bitParallelBfs(view, origins, [this](int v, int level, uint64_t fresh) {
+        int count = __builtin_popcountll(fresh);
+        maxDistance[v] = level;
+        sumDistance[v] += level * count;
+        reached[v] += count;
+    });
+}
+
+/**
+ * @brief Finds the best airports for a group travelling from several origins to meet.
+ *
+ * @param origins The vertex ids of the origins (repeated origins count as several travellers).
+ * @param criterion Whether the longest trip or the total number of flights is minimized first.
+ * @param k The number of airports to return.
+ *
+ * @return Up to k airports reachable from every origin, best first.
+ *
+ * @info Uses the bit-parallel search when there are at most 64 origins and one BFS per origin otherwise; both fill
+ * flat per-airport arrays with the max and sum of the distances.
+ *
+ * @complexity Time Complexity: O(D * (V + E)) for N <= 64, O(N * (V + E)) otherwise, plus O(V log k).
+ */
+vector<MeetingCandidate> MeetingPoint::search(const vector<int> &origins, MeetingCriterion criterion, int k) {
+    int n = view.getNumVertex();
+    maxDistance.assign(n, 0);
+    sumDistance.assign(n, 0);
+    reached.assign(n, 0);
+    if (origins.empty() || k <= 0)
+        return {};
+
+    if (origins.size() <= 64)
+        accumulateBitParallel(origins);
+    else
+        accumulatePerOrigin(origins);
+
+    vector<MeetingCandidate> candidates;
+    for (int v = 0; v < n; v++)
+        if (reached[v] == (int) origins.size())
+            candidates.push_back({v, maxDistance[v], sumDistance[v]});
+
+    auto better = [criterion](const MeetingCandidate &a, const MeetingCandidate &b) {
+        if (criterion == MeetingCriterion::MinMax && a.maxFlights != b.maxFlights)
+            return a.maxFlights < b.maxFlights;
+        if (a.totalFlights != b.totalFlights)
+            return a.totalFlights < b.totalFlights;
+        if (a.maxFlights != b.maxFlights)
+            return a.maxFlights < b.maxFlights;
+        return a.airport < b.airport;
+    };
+    size_t top = min((size_t) k, candidates.size());
+    partial_sort(candidates.begin(), candidates.begin() + top, candidates.end(), better);
+    candidates.resize(top);
+    return candidates;
+}
+
+/**
+ * @brief Builds, for one traveller, a trip with the fewest flights to each of the given airports.
+ *
+ * @param origin The vertex id of the origin.
+ * @param destinations The vertex ids of the destinations (usually the airports returned by search).
+ *
+ * @return For each destination, the vertex ids of a trip from the origin to it, or an empty vector if there is none.
+ *
+ * @complexity Time Complexity: O(V + E + K * D), where K is the number of destinations and D the diameter.
+ */
+vector<vector<int>> MeetingPoint::itineraries(int origin, const vector<int> &destinations) const {
+    vector<int> distance, queue, parent;
+    NetworkStatistics::bfs(view, origin, distance, queue, &parent);
+
+    vector<vector<int>> res;
+    for (int destination : destinations) {
+        vector<int> path;
+        if (distance[destination] != -1) {
+            for (int v = destination; v != -1; v = parent[v])
+                path.push_back(v);
+            reverse(path.begin(), path.end());
+        }
+        res.push_back(path);
+    }
+    return res;
+}
@@ -0,0 +1,38 @@
+
+#ifndef PROJETO2_MEETINGPOINT_H
+#define PROJETO2_MEETINGPOINT_H
+
+
+#include <vector>
+#include "GraphView.h"
+
+enum class MeetingCriterion {
+    MinMax,     ///< minimize the number of flights of the longest trip, then the total
+    MinSum      ///< minimize the total number of flights, then the longest trip
+};
+
+struct MeetingCandidate {
+    int airport;        ///< vertex id of the meeting airport
+    int maxFlights;     ///< flights of the longest trip of the group
+    int totalFlights;   ///< flights of all the trips of the group
+};
+
+class MeetingPoint {
+public:
+    MeetingPoint(const GraphView &view);
+
+    std::vector<MeetingCandidate> search(const std::vector<int> &origins, MeetingCriterion criterion, int k);
+    std::vector<std::vector<int>> itineraries(int origin, const std::vector<int> &destinations) const;
+
+private:
+    const GraphView &view;              ///< the network where the group travels
+    std::vector<int> maxDistance;       ///< longest trip to each airport
+    std::vector<int> sumDistance;       ///< total flights to each airport
+    std::vector<int> reached;           ///< number of origins that reach each airport
+
+    void accumulatePerOrigin(const std::vector<int> &origins);
+    void accumulateBitParallel(const std::vector<int> &origins);
+};
+
+
+#endif //PROJETO2_MEETINGPOINT_H
@@ -3,6 +3,7 @@
 #include "Menu.h"
 #include "Data.h"
 #include "FlightManagementSystem.h"
+#include "SystemLoader.h"
 #include <iostream>
 
 using namespace std;
@@ -43,31 +44,81 @@ using namespace std;
         cout << "|__________________________________________________|" << endl;
     }
 
+/**
+ * @brief Asks the user whether to go back to the main menu.
+ *
+ * @return False if the user answered "N", true if "Y". Anything else is asked again.
+ *
+ * Time Complexity: O(1) per answer.
+ */
+    bool Menu::askToContinue() {
+        cout << endl;
+        cout << "Would you like to do something else? (Y/N) \n";
+        char newCicle;
+        cin >> newCicle;
+        while (newCicle != 'Y') {
+            if (newCicle == 'N')
+                return false;
+            cout << "Please type \"Y\" or \"N\"." << endl;
+            cin >> newCicle;
+        }
+        return true;
+    }
+
 /**
  * @brief Display the main menu and handle user interactions.
  *
- * @info This method initializes a FlightManagementSystem and Data objects, then displays a menu with different options.
- * The user can choose options related to airports, statistics, or finding the best flight options.
+ * @info This method starts loading the Data and FlightManagementSystem objects in the background and displays a menu
+ * with different options right away, with the loading progress above it. The user can choose options related to
+ * airports, statistics, or finding the best flight options; a chosen option waits for the data it needs, while
+ * mistyping an option or exiting never waits for the dataset to load (exiting only finishes a reload already in
+ * progress). When the dataset files change, the new version is loaded in the
+ * background and used from the next option on.
  *
  * @complexity Time complexity: depends on the option chosen by the user.
  */
 void Menu::showMenu() {
-    Data d = Data();
-    FlightManagementSystem fms = FlightManagementSystem(d);
+    SystemLoader loader;
 
     char key;
     bool flag = true;
     while (flag) {
+        string report = loader.takeReloadReport();
+        if (!report.empty())
+            cout << report << endl;
+        string status = loader.getStatus();
+        if (!status.empty())
+            cout << status << endl;
         drawTop();
         cout << "| 1. Get from airports                             |" << endl;
         cout << "| 2. Statistics                                    |" << endl;
         cout << "| 3. Best flight option                            |" << endl;
         cout << "| 4. Personalized preferences                      |" << endl;
         cout << "| 5. Smallest distance between two airports        |" << endl;
+        cout << "| 6. Network analysis                              |" << endl;
+        cout << "| 7. Trip planning                                 |" << endl;
+        cout << "| 8. Map queries                                   |" << endl;
+        cout << "| 9. Flight and airport set queries                |" << endl;
         cout << "| Q. Exit                                          |" << endl;
         drawBottom();
         cout << "Choose an option: ";
         cin >> key;
+        if (key < '1' || key > '9') {
+            if (key == 'Q')
+                flag = false;
+            else
+                cout << endl << "Invalid option!" << endl;
+            if (!askToContinue())
+                flag = false;
+            continue;
+        }
+        if (!loader.isReady())
+            cout << "Waiting for the data to load..." << endl;
+        // the option runs to the end on this version, even if a reload swaps in a new one meanwhile
+        shared_ptr<Data> data = loader.getData();
+        shared_ptr<FlightManagementSystem> system = loader.getSystem();
+        Data &d = *data;
+        FlightManagementSystem &fms = *system;
         switch (key) {
             case '1': {
                 char key1;
@@ -79,6 +130,8 @@ void Menu::showMenu() {
                 cout << "| 5. Number of destinations from airport with stops|" << endl;
                 cout << "| 6. Top airports with most traffic                |" << endl;
                 cout << "| 7. Essential airports                            |" << endl;
+                cout << "| 8. Search airports, cities and countries by name |" << endl;
+                cout << "| 9. Autocomplete airport codes, names and cities  |" << endl;
                 cout << "| Q. Exit                                          |" << endl;
                 drawBottom();
                 cout << "Choose an option: ";
@@ -127,10 +180,16 @@ void Menu::showMenu() {
                         break;
                     }
                     case '6': {
-                        int k;
+                        int k, metric;
                         cout << "Number of airports: ";
                         cin >> k;
-                        fms.getTopAirportWithMostTraffic(k);
+                        cout << "Rank by flights (1), destinations (2), airlines (3) or km flown (4): ";
+                        cin >> metric;
+                        if (metric < 1 || metric > 4) {
+                            cout << "Invalid option" << endl;
+                            break;
+                        }
+                        fms.getTopAirportWithMostTraffic(k, (TrafficMetric) (metric - 1));
                         break;
                     }
                     case '7': {
@@ -142,6 +201,36 @@ void Menu::showMenu() {
                         }
                         break;
                     }
+                    case '8': {
+                        string name;
+                        cout << "Name: ";
+                        cin.ignore();
+                        getline(cin, name);
+                        cout << endl << "Airports:" << endl;
+                        for (const auto &match : fms.searchAirportNames(name, 10)) {
+                            cout << match.second << " -- " << match.first << endl;
+                        }
+                        cout << endl << "Cities:" << endl;
+                        for (const auto &match : fms.searchCities(name, "", 10)) {
+                            cout << match.second << " -- " << match.first << endl;
+                        }
+                        cout << endl << "Countries:" << endl;
+                        for (const auto &match : fms.searchCountries(name, 10)) {
+                            cout << match.second << " -- " << match.first << endl;
+                        }
+                        break;
+                    }
+                    case '9': {
+                        string prefix;
+                        cout << "Start of a code, name or city: ";
+                        cin.ignore();
+                        getline(cin, prefix);
+                        for (const auto &completion : fms.autocompleteAirports(prefix, Autocomplete::maxCompletions)) {
+                            string kind = completion.kind == CompletionKind::Code ? "code" : completion.kind == CompletionKind::Name ? "name" : "city";
+                            cout << completion.text << " (" << completion.code << ", " << kind << ") -- " << completion.traffic << " flights" << endl;
+                        }
+                        break;
+                    }
                     case 'Q' : {
                         break;
                     }
@@ -160,6 +249,10 @@ void Menu::showMenu() {
                 cout << "| 3.  Get number of flights per airline            |" << endl;
                 cout << "| 4.  Get number of countries flown from city      |" << endl;
                 cout << "| 5.  Get max trip with stops                      |" << endl;
+                cout << "| 6.  Get airlines with overlapping routes         |" << endl;
+                cout << "| 7.  Get number of flights per country            |" << endl;
+                cout << "| 8.  Get flights per airline out of country       |" << endl;
+                cout << "| 9.  Get number of flights between countries      |" << endl;
                 cout << "| Q.  Exit                                         |" << endl;
                 drawBottom();
                 cout << "Choose an option: ";
@@ -190,10 +283,39 @@ void Menu::showMenu() {
                     }
 
                     case '5': {
-                        cout << "Loading... (This is going to take 20-25 seconds)" << endl;
                         fms.getMaxTripWithStops();
                         break;
                     }
+                    case '6': {
+                        double threshold;
+                        cout << "Minimum similarity (0-1): ";
+                        cin >> threshold;
+                        fms.airlineRouteOverlap(threshold);
+                        break;
+                    }
+                    case '7': {
+                        fms.numberOfFlightsPerCountry();
+                        break;
+                    }
+                    case '8': {
+                        string country;
+                        cout << "Country: ";
+                        cin.ignore();
+                        getline(cin, country);
+                        fms.numberOfFlightsPerAirlineFromCountry(country);
+                        break;
+                    }
+                    case '9': {
+                        string origin, destination;
+                        cout << "Origin country: ";
+                        cin.ignore();
+                        getline(cin, origin);
+                        cout << "Destination country: ";
+                        getline(cin, destination);
+                        cout << "Number of flights from " << origin << " to " << destination << ": "
+                             << fms.getNumberOfFlightsBetweenCountries(origin, destination) << endl;
+                        break;
+                    }
                     case 'Q' : {
                         break;
                     }
@@ -1578,30 +1700,414 @@ void Menu::showMenu() {
                 cout << " km" << endl;
                 break;
             }
-
-            case 'Q' : {
-                flag = false;
+            case '6': {
+                char key6;
+                drawTop();
+                cout << "| 1.  Resilience under failures                    |" << endl;
+                cout << "| 2.  Network statistics per airline               |" << endl;
+                cout << "| 3.  Fewest flights between two cities            |" << endl;
+                cout << "| 4.  Fewest border crossings between countries    |" << endl;
+                cout << "| 5.  Countries within k border crossings          |" << endl;
+                cout << "| 6.  Clustering coefficient of every airport      |" << endl;
+                cout << "| 7.  Routes that would close the most triads      |" << endl;
+                cout << "| Q.  Exit                                         |" << endl;
+                drawBottom();
+                cout << "Choose an option: ";
+                cin >> key6;
+                switch (key6) {
+                    case '1': {
+                        char mode;
+                        drawTop();
+                        cout << "| 1.  Random airport failures                      |" << endl;
+                        cout << "| 2.  Targeted airport failures (by degree)        |" << endl;
+                        cout << "| 3.  Random route failures                        |" << endl;
+                        cout << "| 4.  Targeted route failures (by degree)          |" << endl;
+                        drawBottom();
+                        cout << "Choose an option: ";
+                        cin >> mode;
+                        if (mode < '1' || mode > '4') {
+                            cout << endl << "Invalid option!" << endl;
+                            break;
+                        }
+                        int maxPercentage, step, trials;
+                        unsigned long long seed;
+                        string filename;
+                        cout << "Max percentage removed: ";
+                        cin >> maxPercentage;
+                        cout << "Percentage step: ";
+                        cin >> step;
+                        cout << "Trials per step: ";
+                        cin >> trials;
+                        cout << "Seed: ";
+                        cin >> seed;
+                        cout << "Output CSV file (- for screen): ";
+                        cin >> filename;
+
+                        vector<double> fractions;
+                        for (int p = 0; p <= maxPercentage && p <= 100; p += max(step, 1)) {
+                            fractions.push_back(p / 100.0);
+                        }
+                        auto failureMode = (FailureMode) (mode - '1');
+                        if (filename == "-") {
+                            fms.analyseNetworkResilience(failureMode, fractions, trials, seed, cout);
+                        } else {
+                            ofstream out(filename);
+                            if (!out.is_open()) {
+                                cout << "Could not open " << filename << endl;
+                                break;
+                            }
+                            fms.analyseNetworkResilience(failureMode, fractions, trials, seed, out);
+                            cout << "Results written to " << filename << endl;
+                        }
+                        break;
+                    }
+                    case '2': {
+                        string filename;
+                        cout << "Output CSV file (- for screen): ";
+                        cin >> filename;
+                        if (filename == "-") {
+                            fms.networkStatisticsPerAirline(cout);
+                        } else {
+                            ofstream out(filename);
+                            if (!out.is_open()) {
+                                cout << "Could not open " << filename << endl;
+                                break;
+                            }
+                            fms.networkStatisticsPerAirline(out);
+                            cout << "Results written to " << filename << endl;
+                        }
+                        break;
+                    }
+                    case '3': {
+                        string sourceCity, sourceCountry, destinationCity, destinationCountry;
+                        cin.ignore();
+                        cout << "Source city: ";
+                        getline(cin, sourceCity);
+                        cout << "Source country: ";
+                        getline(cin, sourceCountry);
+                        cout << "Destination city: ";
+                        getline(cin, destinationCity);
+                        cout << "Destination country: ";
+                        getline(cin, destinationCountry);
+                        fms.cityHopDistance(sourceCity, sourceCountry, destinationCity, destinationCountry);
+                        break;
+                    }
+                    case '4': {
+                        string origin, destination;
+                        cin.ignore();
+                        cout << "Origin country: ";
+                        getline(cin, origin);
+                        cout << "Destination country: ";
+                        getline(cin, destination);
+                        fms.countryHopDistance(origin, destination);
+                        break;
+                    }
+                    case '5': {
+                        string country;
+                        int k;
+                        cin.ignore();
+                        cout << "Country: ";
+                        getline(cin, country);
+                        cout << "Maximum border crossings: ";
+                        cin >> k;
+                        fms.countriesWithinBorderCrossings(country, k);
+                        break;
+                    }
+                    case '6': {
+                        string filename;
+                        cout << "Output CSV file (- for screen): ";
+                        cin >> filename;
+                        if (filename == "-") {
+                            fms.clusteringPerAirport(cout);
+                        } else {
+                            ofstream out(filename);
+                            if (!out.is_open()) {
+                                cout << "Could not open " << filename << endl;
+                                break;
+                            }
+                            fms.clusteringPerAirport(out);
+                            cout << "Results written to " << filename << endl;
+                        }
+                        break;
+                    }
+                    case '7': {
+                        int k;
+                        cout << "Number of routes: ";
+                        cin >> k;
+                        fms.suggestMissingRoutes(k);
+                        break;
+                    }
+                    case 'Q' : {
+                        break;
+                    }
+                    default: {
+                        cout << endl << "Invalid option!" << endl;
+                    }
+                };
                 break;
             }
-            default: {
-                cout << endl << "Invalid option!" << endl;
+            case '7': {
+                char key7;
+                drawTop();
+                cout << "| 1.  Best meeting airport for a group             |" << endl;
+                cout << "| 2.  Flights/distance matrix between airports     |" << endl;
+                cout << "| 3.  Destinations within a flying distance        |" << endl;
+                cout << "| Q.  Exit                                         |" << endl;
+                drawBottom();
+                cout << "Choose an option: ";
+                cin >> key7;
+                switch (key7) {
+                    case '1': {
+                        int travellers, k;
+                        char criterion;
+                        vector<string> origins;
+                        cout << "Number of travellers: ";
+                        cin >> travellers;
+                        for (int i = 0; i < travellers; i++) {
+                            string origin;
+                            cout << "Origin airport code of traveller " << i + 1 << ": ";
+                            cin >> origin;
+                            origins.push_back(origin);
+                        }
+                        cout << "Minimize 1. longest trip or 2. total flights: ";
+                        cin >> criterion;
+                        cout << "Number of airports: ";
+                        cin >> k;
+                        fms.findMeetingPoint(origins, criterion == '2' ? MeetingCriterion::MinSum : MeetingCriterion::MinMax, k);
+                        break;
+                    }
+                    case '2': {
+                        auto readCodes = [](const string &line) {
+                            vector<string> codes;
+                            string code;
+                            if (!line.empty() && line[0] == '@') {
+                                ifstream file(line.substr(1));
+                                while (file >> code) codes.push_back(code);
+                            } else {
+                                istringstream ss(line);
+                                while (ss >> code) codes.push_back(code);
+                            }
+                            return codes;
+                        };
+                        string line, filename;
+                        char metric, format;
+                        cout << "Source airport codes (separated by spaces, or @file): ";
+                        cin.ignore();
+                        getline(cin, line);
+                        vector<string> sources = readCodes(line);
+                        cout << "Target airport codes (separated by spaces, or @file, empty for the same): ";
+                        getline(cin, line);
+                        vector<string> targets = line.empty() ? sources : readCodes(line);
+                        cout << "Values: 1. flights or 2. kilometers: ";
+                        cin >> metric;
+                        cout << "Format: 1. CSV or 2. binary: ";
+                        cin >> format;
+                        cout << "Output file (- for screen): ";
+                        cin >> filename;
+                        auto matrixMetric = metric == '2' ? MatrixMetric::Kilometers : MatrixMetric::Flights;
+                        if (filename == "-") {
+                            fms.computeDistanceMatrix(sources, targets, matrixMetric, cout, false);
+                        } else {
+                            ofstream out(filename, format == '2' ? ios::binary : ios::out);
+                            if (!out.is_open()) {
+                                cout << "Could not open " << filename << endl;
+                                break;
+                            }
+                            if (fms.computeDistanceMatrix(sources, targets, matrixMetric, out, format == '2')) {
+                                cout << "Matrix written to " << filename << endl;
+                            }
+                        }
+                        break;
+                    }
+                    case '3': {
+                        string airport;
+                        double budget;
+                        cout << "Airport code: ";
+                        cin >> airport;
+                        cout << "Max flying distance (km): ";
+                        cin >> budget;
+                        fms.reachableWithinDistance(airport, budget);
+                        break;
+                    }
+                    case 'Q' : {
+                        break;
+                    }
+                    default: {
+                        cout << endl << "Invalid option!" << endl;
+                    }
+                };
+                break;
+            }
+            case '8': {
+                char key8;
+                drawTop();
+                cout << "| 1.  Airports inside a bounding box               |" << endl;
+                cout << "| 2.  Airports within a radius                     |" << endl;
+                cout << "| 3.  Nearest airports                             |" << endl;
+                cout << "| 4.  Flights inside a bounding box                |" << endl;
+                cout << "| 5.  Routes passing near a point                  |" << endl;
+                cout << "| 6.  Routes crossing a region                     |" << endl;
+                cout << "| Q.  Exit                                         |" << endl;
+                drawBottom();
+                cout << "Choose an option: ";
+                cin >> key8;
+                switch (key8) {
+                    case '1':
+                    case '4': {
+                        double minLatitude, minLongitude, maxLatitude, maxLongitude;
+                        cout << "South latitude: ";
+                        cin >> minLatitude;
+                        cout << "West longitude: ";
+                        cin >> minLongitude;
+                        cout << "North latitude: ";
+                        cin >> maxLatitude;
+                        cout << "East longitude: ";
+                        cin >> maxLongitude;
+                        if (key8 == '1') {
+                            auto found = fms.getAirportsInBox(minLatitude, minLongitude, maxLatitude, maxLongitude);
+                            for (const auto &code : found) {
+                                const Airport *airport = d.getAirport(code);
+                                cout << code << " (" << airport->getName() << ") - " << airport->getCity() << ", " << airport->getCountry() << endl;
+                            }
+                            cout << "Number of airports: " << found.size() << endl;
+                        } else {
+                            auto found = fms.getFlightsInBox(minLatitude, minLongitude, maxLatitude, maxLongitude);
+                            for (const auto &route : found) {
+                                fms.printRoute(route);
+                            }
+                            cout << "Number of routes: " << found.size() << endl;
+                        }
+                        break;
+                    }
+                    case '2':
+                    case '3': {
+                        double latitude, longitude;
+                        cout << "Latitude: ";
+                        cin >> latitude;
+                        cout << "Longitude: ";
+                        cin >> longitude;
+                        vector<pair<double, string>> found;
+                        if (key8 == '2') {
+                            double radius;
+                            cout << "Radius (km): ";
+                            cin >> radius;
+                            found = fms.getAirportsWithinRadius(latitude, longitude, radius);
+                        } else {
+                            int k;
+                            cout << "Number of airports: ";
+                            cin >> k;
+                            found = fms.getNearestAirports(latitude, longitude, k);
+                        }
+                        for (const auto &airport : found) {
+                            cout << airport.second << " (" << d.getAirport(airport.second)->getName() << ") -- " << airport.first << " km" << endl;
+                        }
+                        break;
+                    }
+                    case '5': {
+                        double latitude, longitude, radius;
+                        cout << "Latitude: ";
+                        cin >> latitude;
+                        cout << "Longitude: ";
+                        cin >> longitude;
+                        cout << "Radius (km): ";
+                        cin >> radius;
+                        auto found = fms.getRoutesNearPoint(latitude, longitude, radius);
+                        for (const auto &route : found) {
+                            cout << route.first << " km -- ";
+                            fms.printRoute(route.second);
+                        }
+                        cout << "Number of routes: " << found.size() << endl;
+                        break;
+                    }
+                    case '6': {
+                        int n;
+                        cout << "Number of vertices of the region: ";
+                        cin >> n;
+                        vector<Position> region;
+                        for (int i = 0; i < n; i++) {
+                            double latitude, longitude;
+                            cout << "Vertex " << i + 1 << " latitude: ";
+                            cin >> latitude;
+                            cout << "Vertex " << i + 1 << " longitude: ";
+                            cin >> longitude;
+                            region.push_back(Position(latitude, longitude));
+                        }
+                        if (n < 3) {
+                            cout << "A region needs at least 3 vertices" << endl;
+                            break;
+                        }
+                        auto found = fms.getRoutesCrossingRegion(region);
+                        for (const auto &route : found) {
+                            fms.printRoute(route);
+                        }
+                        cout << "Number of routes: " << found.size() << endl;
+                        break;
+                    }
+                    case 'Q' : {
+                        break;
+                    }
+                    default: {
+                        cout << endl << "Invalid option!" << endl;
+                    }
+                };
+                break;
             }
 
-        };
-
-        cout << endl;
-        cout << "Would you like to do something else? (Y/N) \n";
-        char newCicle;
-        cin >> newCicle;
-        if (newCicle == 'N') flag = false;
-        while (newCicle != 'Y') {
-            if (newCicle == 'N') {
-                flag = false;
+            case '9': {
+                char key9;
+                drawTop();
+                cout << "| 1.  Flight statistics query                      |" << endl;
+                cout << "| 2.  Airport set expression                       |" << endl;
+                cout << "| 3.  Common nonstop destinations of airports      |" << endl;
+                cout << "| Q.  Exit                                         |" << endl;
+                drawBottom();
+                cout << "Choose an option: ";
+                cin >> key9;
+                switch (key9) {
+                    case '1': {
+                        string query;
+                        FlightTable::showHelp(cout);
+                        cout << "Query: ";
+                        cin.ignore();
+                        getline(cin, query);
+                        fms.queryFlights(query);
+                        break;
+                    }
+                    case '2': {
+                        string expression;
+                        AirportSets::showHelp(cout);
+                        cout << "Expression: ";
+                        cin.ignore();
+                        getline(cin, expression);
+                        fms.queryAirportSets(expression);
+                        break;
+                    }
+                    case '3': {
+                        string line, code;
+                        vector<string> codes;
+                        cout << "Airport codes, separated by spaces: ";
+                        cin.ignore();
+                        getline(cin, line);
+                        istringstream words(line);
+                        while (words >> code)
+                            codes.push_back(code);
+                        fms.commonDestinations(codes);
+                        break;
+                    }
+                    case 'Q' : {
+                        break;
+                    }
+                    default: {
+                        cout << endl << "Invalid option!" << endl;
+                    }
+                };
                 break;
             }
-            cout << "Please type \"Y\" or \"N\"." << endl;
-            cin >> newCicle;
-        }
+
+        };
+
+        if (!askToContinue())
+            flag = false;
     }
 }
 
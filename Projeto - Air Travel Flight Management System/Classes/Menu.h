@@ -12,6 +12,7 @@ public:
     void showMenu();
     static void drawTop();
     static void drawBottom();
+    static bool askToContinue();
 
 };
 
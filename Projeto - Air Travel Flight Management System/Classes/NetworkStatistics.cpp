@@ -0,0 +1,386 @@
+
+#include "NetworkStatistics.h"
+#include "DisjointSet.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+/**
+ * @brief Finds the airports that have at least one flight in the view.
+ *
+ * @param view The graph view.
+ * @param degree Output: number of flights (in + out) of each airport in the view, indexed by vertex id.
+ *
+ * @return The ids of the served airports, in increasing order.
+ *
+ * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges in the graph.
+ */
+vector<int> NetworkStatistics::servedAirports(const GraphView &view, vector<int> &degree) {
+    const auto &vertices = view.getGraph().getVertexSet();
+    degree.assign(vertices.size(), 0);
+    for (auto v : vertices) {
+        view.forEachEdge(v, [&](const Edge &edge) {
+            degree[v->getId()]++;
+            degree[edge.getDest()->getId()]++;
+        });
+    }
+
+    vector<int> served;
+    for (int id = 0; id < (int) degree.size(); id++)
+        if (degree[id] > 0)
+            served.push_back(id);
+    return served;
+}
+
+/**
+ * @brief Breadth-first search over the flights of the view.
+ *
+ * @param view The graph view.
+ * @param source The id of the source vertex.
+ * @param distance Scratch/output: number of flights from the source to each vertex, or -1 if unreachable.
+ * @param queue Scratch/output: the reached vertices, in BFS order (so the last one is the farthest).
+ * @param parent Optional output: the vertex from which each vertex was reached, or -1 (used to rebuild trips).
+ *
+ * @return The number of reached vertices, including the source.
+ *
+ * @info The visited state lives in the caller's arrays instead of in Vertex, so several searches may run at the same
+ * time over the same graph.
+ *
+ * @complexity Time Complexity: O(V + E), where V is the number of vertices and E is the number of edges.
+ */
+int NetworkStatistics::bfs(const GraphView &view, int source, vector<int> &distance, vector<int> &queue,
+                           vector<int> *parent) {
+    const auto &vertices = view.getGraph().getVertexSet();
+    distance.assign(vertices.size(), -1);
+    queue.clear();
+    if (parent != nullptr)
+        parent->assign(vertices.size(), -1);
+
+    distance[source] = 0;
+    queue.push_back(source);
+    for (int head = 0; head < (int) queue.size(); head++) {
+        int v = queue[head];
+        view.forEachEdge(vertices[v], [&](const Edge &edge) {
+            int w = edge.getDest()->getId();
+            if (distance[w] == -1) {
+                distance[w] = distance[v] + 1;
+                queue.push_back(w);
+                if (parent != nullptr)
+                    (*parent)[w] = v;
+            }
+        });
+    }
+    return (int) queue.size();
+}
+
+/**
+ * @brief Breadth-first search from up to 64 origins at the same time.
+ *
+ * @param view The graph view.
+ * @param origins The vertex ids of the origins (at most 64). Bit i stands for origins[i].
+ * @param visit Called once per vertex and level with the bits of the origins that reach the vertex for the first time
+ * at that level (level 0 is the origins themselves).
+ *
+ * @info All searches advance one level at a time together, so every edge is scanned at most once per level instead of
+ * once per origin.
+ *
+ * @complexity Time Complexity: O(D * (V + E)), where D is the number of levels (at most the diameter).
+ */
+void NetworkStatistics::bitParallelBfs(const GraphView &view, const vector<int> &origins,
+                                       const function<void(int, int, uint64_t)> &visit) {
+    const auto &vertices = view.getGraph().getVertexSet();
+    int n = (int) vertices.size();
+    vector<uint64_t> seen(n, 0), frontier(n, 0), next(n, 0);
+    vector<int> active, touched;
+
+    for (int i = 0; i < (int) origins.size() && i < 64; i++) {
+        int o = origins[i];
+        if (frontier[o] == 0)
+            active.push_back(o);
+        frontier[o] |= 1ULL << i;
+        seen[o] |= 1ULL << i;
+    }
+    for (int o : active)
+        visit(o, 0, frontier[o]);
+
+    for (int level = 1; !active.empty(); level++) {
+        touched.clear();
+        for (int v : active) {
+            uint64_t bits = frontier[v];
+            view.forEachEdge(vertices[v], [&](const Edge &edge) {
+                int w = edge.getDest()->getId();
+                if ((bits & ~seen[w]) == 0)
+                    return;
+                if (next[w] == 0)
+                    touched.push_back(w);
+                next[w] |= bits;
+            });
+            frontier[v] = 0;
+        }
+
+        active.clear();
+        for (int w : touched) {
+            uint64_t fresh = next[w] & ~seen[w];
+            next[w] = 0;
+            if (fresh == 0)
+                continue;
+            seen[w] |= fresh;
+            frontier[w] = fresh;
+            active.push_back(w);
+            visit(w, level, fresh);
+        }
+    }
+}
+
+/**
+ * @brief Dijkstra's algorithm over the flight distances (km) of the view.
+ *
+ * @param view The graph view.
+ * @param source The id of the source vertex.
+ * @param distance Output: the smallest flown distance from the source to each vertex, or infinity if unreachable.
+ * @param targets Optional: marks the vertices of interest. The search stops once all of them are settled.
+ * @param numTargets The number of marked vertices.
+ *
+ * @complexity Time Complexity: O((V + E) log V), where V is the number of vertices and E is the number of edges.
+ */
+void NetworkStatistics::dijkstra(const GraphView &view, int source, vector<double> &distance,
+                                 const vector<bool> *targets, int numTargets) {
+    const auto &vertices = view.getGraph().getVertexSet();
+    distance.assign(vertices.size(), numeric_limits<double>::infinity());
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> heap;
+
+    distance[source] = 0;
+    heap.push({0, source});
+    int settled = 0;
+    while (!heap.empty()) {
+        auto top = heap.top();
+        heap.pop();
+        int v = top.second;
+        if (top.first > distance[v])
+            continue;
+        if (targets != nullptr && (*targets)[v] && ++settled == numTargets)
+            break;
+        view.forEachEdge(vertices[v], [&](const Edge &edge) {
+            int w = edge.getDest()->getId();
+            double d = top.first + edge.getDistance();
+            if (d < distance[w]) {
+                distance[w] = d;
+                heap.push({d, w});
+            }
+        });
+    }
+}
+
+/**
+ * @brief Gets the sizes of the connected components of the view, ignoring the direction of the flights.
+ *
+ * @param view The graph view.
+ * @param served The airports of the view, as returned by servedAirports.
+ *
+ * @return The number of airports of each component, in decreasing order.
+ *
+ * @complexity Time Complexity: O(V + E α(V)), where V is the number of vertices and E is the number of edges.
+ */
+vector<int> NetworkStatistics::componentSizes(const GraphView &view, const vector<int> &served) {
+    const auto &vertices = view.getGraph().getVertexSet();
+    DisjointSet components((int) vertices.size());
+    for (int v : served) {
+        view.forEachEdge(vertices[v], [&](const Edge &edge) {
+            components.unite(v, edge.getDest()->getId());
+        });
+    }
+
+    vector<int> sizes;
+    for (int v : served)
+        if (components.find(v) == v)
+            sizes.push_back(components.getSize(v));
+    sort(sizes.rbegin(), sizes.rend());
+    return sizes;
+}
+
+/**
+ * @brief Calculates the diameter of the view: the maximum number of flights of a shortest trip between two airports.
+ *
+ * @param view The graph view.
+ * @param served The airports of the view, as returned by servedAirports.
+ *
+ * @return The diameter of the view.
+ *
+ * @complexity Time Complexity: O(V * (V + E)), where V is the number of vertices and E is the number of edges.
+ */
+int NetworkStatistics::diameter(const GraphView &view, const vector<int> &served) {
+    int res = 0;
+    vector<int> distance, queue;
+    for (int v : served) {
+        bfs(view, v, distance, queue);
+        res = max(res, distance[queue.back()]);
+    }
+    return res;
+}
+
+/**
+ * @brief Finds the pairs of airports whose shortest trip is the longest of the view.
+ *
+ * @param view The graph view.
+ * @param served The airports of the view, as returned by servedAirports.
+ * @param trips Output: the (source, target) vertex ids of every such pair, in increasing order.
+ *
+ * @return The number of flights of those trips (the diameter of the view).
+ *
+ * @info Sources are grouped in batches of 64 that share a single bit-parallel BFS, and batches run in parallel. Each
+ * batch keeps only the pairs at its deepest level.
+ *
+ * @complexity Time Complexity: O(V / 64 * D * (V + E) / P), where D is the diameter and P the number of hardware
+ * threads.
+ */
+int NetworkStatistics::longestTrips(const GraphView &view, const vector<int> &served, vector<pair<int, int>> &trips) {
+    size_t batches = (served.size() + 63) / 64;
+    vector<int> longest(batches, 0);
+    vector<vector<pair<int, int>>> found(batches);
+    parallelFor(batches, [&](size_t batch) {
+        size_t first = batch * 64;
+        vector<int> origins(served.begin() + first, served.begin() + min(first + 64, served.size()));
+        bitParallelBfs(view, origins, [&](int v, int level, uint64_t fresh) {
+            if (level < longest[batch])
+                return;
+            if (level > longest[batch]) {
+                longest[batch] = level;
+                found[batch].clear();
+            }
+            for (; fresh != 0; fresh &= fresh - 1)
+                found[batch].push_back({origins[__builtin_ctzll(fresh)], v});
+        });
+    });
+
+    int res = 0;
+    for (int level : longest)
+        res = max(res, level);
+    trips.clear();
+    for (size_t batch = 0; batch < batches; batch++)
+        if (longest[batch] == res)
+            trips.insert(trips.end(), found[batch].begin(), found[batch].end());
+    sort(trips.begin(), trips.end());
+    return res;
+}
+
+/**
+ * @brief Finds the essential airports of the view: those whose removal disconnects other airports.
+ *
+ * @param view The graph view.
+ * @param served The airports of the view, as returned by servedAirports.
+ *
+ * @return The ids of the articulation points of the view, ignoring the direction of the flights.
+ *
+ * @info Iterative version of Tarjan's algorithm over a deduplicated undirected adjacency, so it neither recurses
+ * deeply on long chains nor touches the auxiliary fields of Vertex.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of vertices and E is the number of edges.
+ */
+vector<int> NetworkStatistics::articulationPoints(const GraphView &view, const vector<int> &served) {
+    const auto &vertices = view.getGraph().getVertexSet();
+    int n = (int) served.size();
+    vector<int> local(vertices.size(), -1);
+    for (int i = 0; i < n; i++)
+        local[served[i]] = i;
+
+    vector<vector<int>> adj(n);
+    for (int i = 0; i < n; i++) {
+        view.forEachEdge(vertices[served[i]], [&](const Edge &edge) {
+            int j = local[edge.getDest()->getId()];
+            if (j != i) {
+                adj[i].push_back(j);
+                adj[j].push_back(i);
+            }
+        });
+    }
+    for (auto &neighbours : adj) {
+        sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+
+    vector<int> num(n, -1), low(n, 0), parent(n, -1), next(n, 0);
+    vector<bool> articulation(n, false);
+    vector<int> stack;
+    int counter = 0;
+
+    for (int root = 0; root < n; root++) {
+        if (num[root] != -1)
+            continue;
+        int rootChildren = 0;
+        num[root] = low[root] = counter++;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int v = stack.back();
+            if (next[v] < (int) adj[v].size()) {
+                int w = adj[v][next[v]++];
+                if (num[w] == -1) {
+                    parent[w] = v;
+                    num[w] = low[w] = counter++;
+                    stack.push_back(w);
+                    if (v == root)
+                        rootChildren++;
+                } else if (w != parent[v]) {
+                    low[v] = min(low[v], num[w]);
+                }
+            } else {
+                stack.pop_back();
+                int p = parent[v];
+                if (p != -1) {
+                    low[p] = min(low[p], low[v]);
+                    if (p != root && low[v] >= num[p])
+                        articulation[p] = true;
+                }
+            }
+        }
+        if (rootChildren > 1)
+            articulation[root] = true;
+    }
+
+    vector<int> res;
+    for (int i = 0; i < n; i++)
+        if (articulation[i])
+            res.push_back(served[i]);
+    return res;
+}
+
+/**
+ * @brief Computes every network metric of a view.
+ *
+ * @param view The graph view.
+ * @param hubs The number of busiest airports whose reachability is reported.
+ *
+ * @return The metrics of the view.
+ *
+ * @complexity Time Complexity: O(V * (V + E)), dominated by the diameter.
+ */
+NetworkMetrics NetworkStatistics::compute(const GraphView &view, int hubs) {
+    NetworkMetrics metrics = {0, 0, 0, 0, 0, 0, {}};
+    vector<int> degree;
+    vector<int> served = servedAirports(view, degree);
+    metrics.airports = (int) served.size();
+    for (int v : served)
+        metrics.flights += degree[v];
+    metrics.flights /= 2;
+
+    vector<int> sizes = componentSizes(view, served);
+    metrics.components = (int) sizes.size();
+    metrics.largestComponent = sizes.empty() ? 0 : sizes.front();
+    metrics.diameter = diameter(view, served);
+    metrics.essentialAirports = (int) articulationPoints(view, served).size();
+
+    vector<int> busiest = served;
+    int k = min(max(hubs, 0), (int) busiest.size());
+    partial_sort(busiest.begin(), busiest.begin() + k, busiest.end(), [&degree](int a, int b) {
+        return degree[a] != degree[b] ? degree[a] > degree[b] : a < b;
+    });
+    vector<int> distance, queue;
+    for (int i = 0; i < k; i++) {
+        int reached = bfs(view, busiest[i], distance, queue);
+        metrics.hubReach.push_back({view.getGraph().getVertexSet()[busiest[i]]->getInfo(), reached - 1});
+    }
+    return metrics;
+}
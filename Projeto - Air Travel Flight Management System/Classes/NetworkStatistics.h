@@ -0,0 +1,41 @@
+
+#ifndef PROJETO2_NETWORKSTATISTICS_H
+#define PROJETO2_NETWORKSTATISTICS_H
+
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "GraphView.h"
+
+struct NetworkMetrics {
+    int airports;                                       ///< airports with at least one flight in the view
+    int flights;                                        ///< flights in the view
+    int components;                                     ///< connected components, ignoring flight direction
+    int largestComponent;                               ///< airports in the largest component
+    int diameter;                                       ///< longest shortest path, in flights
+    int essentialAirports;                              ///< articulation points, ignoring flight direction
+    std::vector<std::pair<std::string, int>> hubReach;  ///< busiest airports and how many airports they reach
+};
+
+class NetworkStatistics {
+public:
+    static std::vector<int> servedAirports(const GraphView &view, std::vector<int> &degree);
+    static int bfs(const GraphView &view, int source, std::vector<int> &distance, std::vector<int> &queue,
+                   std::vector<int> *parent = nullptr);
+    static void bitParallelBfs(const GraphView &view, const std::vector<int> &origins,
+                               const std::function<void(int vertex, int level, std::uint64_t fresh)> &visit);
+    static void dijkstra(const GraphView &view, int source, std::vector<double> &distance,
+                         const std::vector<bool> *targets = nullptr, int numTargets = 0);
+    static std::vector<int> componentSizes(const GraphView &view, const std::vector<int> &served);
+    static int diameter(const GraphView &view, const std::vector<int> &served);
+    static int longestTrips(const GraphView &view, const std::vector<int> &served,
+                            std::vector<std::pair<int, int>> &trips);
+    static std::vector<int> articulationPoints(const GraphView &view, const std::vector<int> &served);
+    static NetworkMetrics compute(const GraphView &view, int hubs);
+};
+
+
+#endif //PROJETO2_NETWORKSTATISTICS_H
@@ -0,0 +1,57 @@
+
+#ifndef PROJETO2_PARALLEL_H
+#define PROJETO2_PARALLEL_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Gets the number of worker threads used by the parallel algorithms.
+ *
+ * @return The number of hardware threads, or 1 if it cannot be determined.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+inline unsigned numberOfWorkers() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * @brief Runs f(0), f(1), ..., f(n - 1) spread over all hardware threads.
+ *
+ * @param n The number of iterations.
+ * @param f The body of the loop. It must be safe to call concurrently for different indexes.
+ *
+ * @info Indexes are handed out one at a time from a shared counter, so uneven iterations are balanced between threads.
+ * Results that must be reproducible should be written to a slot indexed by i and combined afterwards in order.
+ *
+ * @complexity Time Complexity: O(n * T(f) / P), where P is the number of hardware threads.
+ */
+template <typename F>
+void parallelFor(std::size_t n, F f) {
+    std::size_t workers = std::min<std::size_t>(n, numberOfWorkers());
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < workers; t++) {
+        pool.emplace_back([&]() {
+            for (std::size_t i = next++; i < n; i = next++)
+                f(i);
+        });
+    }
+    for (auto &thread : pool)
+        thread.join();
+}
+
+
+#endif //PROJETO2_PARALLEL_H
@@ -17,12 +17,18 @@ public:
     Position(double latitude, double longitude);
     double getLatitude() const;
     double getLongitude() const;
+    double getX() const;
+    double getY() const;
+    double getZ() const;
     double haversineDistance(const Position& other) const ;
+    double dot(const Position& other) const;
+    static double distanceToDot(double distance);
+    static double toRadians(double degrees);    ///< converts degrees to radians
 
 private:
     double latitude;        ///< latitude in degrees
     double longitude;       ///< longitude in degrees
-    static double toRadians(double degrees);    ///< converts degrees to radians
+    double x, y, z;         ///< unit vector of the position (Earth-centred, Earth-fixed, on the unit sphere)
 };
 
 
@@ -0,0 +1,224 @@
+
+#include "QuotientGraph.h"
+#include <algorithm>
+#include <tuple>
+
+using namespace std;
+
+/**
+ * @brief Collapses the airports of a graph into regions, such as cities or countries.
+ *
+ * @param graph The flights graph.
+ * @param regionOf The region of each vertex id.
+ * @param numRegions The number of regions.
+ *
+ * @info Every pair of regions connected by at least one flight becomes a single edge, which keeps the number of flights
+ * it stands for and the set of airlines that operate them. Flights inside a region become a loop on it. Edges are
+ * stored in compressed rows, sorted by target, so the graph is a few flat arrays.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of vertices and E the number of edges.
+ */
+void QuotientGraph::build(const Graph &graph, const vector<int> &regionOf, int numRegions) {
+    this->numRegions = numRegions;
+    vector<tuple<int, int, int>> collapsed;
+    for (auto vertex : graph.getVertexSet()) {
+        for (const auto &edge : vertex->getAdj())
+            collapsed.emplace_back(regionOf[vertex->getId()], regionOf[edge.getDest()->getId()], edge.getAirlineId());
+    }
+    sort(collapsed.begin(), collapsed.end());
+
+    firstEdge.assign(numRegions + 1, 0);
+    targets.clear();
+    flights.clear();
+    firstAirline.clear();
+    airlines.clear();
+    hops.clear();
+    for (size_t i = 0; i < collapsed.size(); i++) {
+        int source = get<0>(collapsed[i]), target = get<1>(collapsed[i]), airline = get<2>(collapsed[i]);
+        if (i == 0 || source != get<0>(collapsed[i - 1]) || target != get<1>(collapsed[i - 1])) {
+            firstEdge[source + 1]++;
+            targets.push_back(target);
+            flights.push_back(0);
+            firstAirline.push_back((int) airlines.size());
+        }
+        flights.back()++;
+        if ((int) airlines.size() == firstAirline.back() || airlines.back() != airline)
+            airlines.push_back(airline);
+    }
+    firstAirline.push_back((int) airlines.size());
+    for (int region = 0; region < numRegions; region++)
+        firstEdge[region + 1] += firstEdge[region];
+}
+
+/**
+ * @brief Precomputes the hop distance between every pair of regions, for constant-time lookups.
+ *
+ * @info Meant for the small quotients, such as the country graph, where the R^2 table takes a few hundred kilobytes.
+ *
+ * @complexity Time Complexity: O(R * (R + Q)), where R is the number of regions and Q the number of edges.
+ */
+void QuotientGraph::buildHops() {
+    vector<int> table;
+    table.reserve((size_t) numRegions * numRegions);
+    for (int region = 0; region < numRegions; region++) {
+        vector<int> distances = getHopsFrom(region);
+        table.insert(table.end(), distances.begin(), distances.end());
+    }
+    hops = move(table);
+}
+
+/**
+ * @brief Gets the number of regions.
+ *
+ * @return The number of nodes of the quotient graph.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int QuotientGraph::getNumRegions() const {
+    return numRegions;
+}
+
+/**
+ * @brief Gets the number of edges.
+ *
+ * @return The number of connected (source, target) pairs of regions, loops included.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int QuotientGraph::getNumEdges() const {
+    return (int) targets.size();
+}
+
+/**
+ * @brief Gets the first edge out of a region.
+ *
+ * @param region The id of the region.
+ *
+ * @return The id of the first edge. The edges of the region go up to getLastEdge.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int QuotientGraph::getFirstEdge(int region) const {
+    return firstEdge[region];
+}
+
+/**
+ * @brief Gets the end of the edges out of a region.
+ *
+ * @param region The id of the region.
+ *
+ * @return One past the id of the last edge.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int QuotientGraph::getLastEdge(int region) const {
+    return firstEdge[region + 1];
+}
+
+/**
+ * @brief Gets the target of an edge.
+ *
+ * @param edge The id of the edge.
+ *
+ * @return The id of the target region.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int QuotientGraph::getEdgeTarget(int edge) const {
+    return targets[edge];
+}
+
+/**
+ * @brief Gets the multiplicity of an edge.
+ *
+ * @param edge The id of the edge.
+ *
+ * @return The number of flights between both regions, in that direction.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int QuotientGraph::getEdgeFlights(int edge) const {
+    return flights[edge];
+}
+
+/**
+ * @brief Gets the number of airlines of an edge.
+ *
+ * @param edge The id of the edge.
+ *
+ * @return The number of distinct airlines flying between both regions, in that direction.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int QuotientGraph::getEdgeNumAirlines(int edge) const {
+    return firstAirline[edge + 1] - firstAirline[edge];
+}
+
+/**
+ * @brief Checks if an airline flies an edge.
+ *
+ * @param edge The id of the edge.
+ * @param airline The id of the airline.
+ *
+ * @return True if the airline has a flight between both regions, in that direction.
+ *
+ * @complexity Time Complexity: O(log a), where a is the number of airlines of the edge.
+ */
+bool QuotientGraph::hasAirline(int edge, int airline) const {
+    return binary_search(airlines.begin() + firstAirline[edge], airlines.begin() + firstAirline[edge + 1], airline);
+}
+
+/**
+ * @brief Computes the hop distance from a region to every other one.
+ *
+ * @param source The id of the source region.
+ * @param maxHops The search stops after this many hops.
+ * @param airlines If given, the airlines that may be used, by airline id. Edges none of them flies are skipped.
+ *
+ * @return The number of hops to each region, or -1 if it is not reached. Each hop leaves a region, so in the country
+ * graph it is a border crossing.
+ *
+ * @complexity Time Complexity: O(R + Q * a), where R is the number of regions, Q the number of edges and a the number
+ * of airlines of an edge (1 without an airline filter).
+ */
+vector<int> QuotientGraph::getHopsFrom(int source, int maxHops, const vector<bool> *airlines) const {
+    vector<int> distance(numRegions, -1);
+    vector<int> queue = {source};
+    distance[source] = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+        int region = queue[head];
+        if (distance[region] >= maxHops)
+            break;
+        for (int edge = firstEdge[region]; edge < firstEdge[region + 1]; edge++) {
+            int target = targets[edge];
+            if (distance[target] >= 0)
+                continue;
+            if (airlines != nullptr) {
+                bool allowed = false;
+                for (int i = firstAirline[edge]; i < firstAirline[edge + 1] && !allowed; i++)
+                    allowed = this->airlines[i] < (int) airlines->size() && (*airlines)[this->airlines[i]];
+                if (!allowed)
+                    continue;
+            }
+            distance[target] = distance[region] + 1;
+            queue.push_back(target);
+        }
+    }
+    return distance;
+}
+
+/**
+ * @brief Gets the hop distance between two regions.
+ *
+ * @param source The id of the source region.
+ * @param target The id of the target region.
+ *
+ * @return The number of hops, or -1 if the target cannot be reached.
+ *
+ * @complexity Time Complexity: O(1) once buildHops was called, O(R + Q) otherwise.
+ */
+int QuotientGraph::getHops(int source, int target) const {
+    if (hops.empty())
+        return getHopsFrom(source)[target];
+    return hops[(size_t) source * numRegions + target];
+}
@@ -0,0 +1,38 @@
+
+#ifndef PROJETO2_QUOTIENTGRAPH_H
+#define PROJETO2_QUOTIENTGRAPH_H
+
+
+#include <climits>
+#include <vector>
+#include "Graph.h"
+
+class QuotientGraph {
+public:
+    void build(const Graph &graph, const std::vector<int> &regionOf, int numRegions);
+    void buildHops();
+
+    int getNumRegions() const;
+    int getNumEdges() const;
+    int getFirstEdge(int region) const;
+    int getLastEdge(int region) const;
+    int getEdgeTarget(int edge) const;
+    int getEdgeFlights(int edge) const;
+    int getEdgeNumAirlines(int edge) const;
+    bool hasAirline(int edge, int airline) const;
+
+    std::vector<int> getHopsFrom(int source, int maxHops = INT_MAX, const std::vector<bool> *airlines = nullptr) const;
+    int getHops(int source, int target) const;
+
+private:
+    int numRegions = 0;                 ///< number of nodes
+    std::vector<int> firstEdge;         ///< first edge of each region, followed by the end of the last one
+    std::vector<int> targets;           ///< target region of each edge, sorted within a region
+    std::vector<int> flights;           ///< number of airport-level flights collapsed into each edge
+    std::vector<int> firstAirline;      ///< first airline of each edge in airlines, followed by the end of the last one
+    std::vector<int> airlines;          ///< sorted airline ids of each edge
+    std::vector<int> hops;              ///< hop distance between every pair of regions, -1 if unreachable, if built
+};
+
+
+#endif //PROJETO2_QUOTIENTGRAPH_H
@@ -0,0 +1,270 @@
+
+#include "RTree.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+using namespace std;
+
+const int RTree::capacity;
+
+/**
+ * @brief Constructor for the RTree class. The tree starts empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+RTree::RTree() {}
+
+/**
+ * @brief Bulk loads the tree with Sort-Tile-Recursive (STR) packing.
+ *
+ * @param points The points to index. Any previous content is discarded.
+ *
+ * @info Every level is sorted by longitude, cut into about sqrt(P) vertical slices, and each slice is sorted by latitude
+ * and packed into full nodes. Nodes are stored in a flat vector, level after level, so the children of a node are
+ * contiguous and the root is the last node. The unit vector of every point is kept next to it, so distance searches
+ * compare points by dot product.
+ *
+ * @complexity Time Complexity: O(N log N), where N is the number of points.
+ */
+void RTree::build(vector<SpatialEntry> points) {
+    entries = move(points);
+    nodes.clear();
+    positions.clear();
+    if (entries.empty())
+        return;
+
+    auto slices = [](int n) {
+        int pages = (n + capacity - 1) / capacity;
+        return (int) ceil(sqrt((double) pages)) * capacity;
+    };
+
+    int n = (int) entries.size();
+    int sliceSize = slices(n);
+    sort(entries.begin(), entries.end(), [](const SpatialEntry &a, const SpatialEntry &b) {
+        return a.longitude < b.longitude;
+    });
+    for (int s = 0; s < n; s += sliceSize) {
+        int end = min(n, s + sliceSize);
+        sort(entries.begin() + s, entries.begin() + end, [](const SpatialEntry &a, const SpatialEntry &b) {
+            return a.latitude < b.latitude;
+        });
+        for (int i = s; i < end; i += capacity) {
+            Node leaf = {90, 180, -90, -180, i, min(capacity, end - i), true};
+            for (int j = i; j < i + leaf.count; j++) {
+                leaf.minLatitude = min(leaf.minLatitude, entries[j].latitude);
+                leaf.maxLatitude = max(leaf.maxLatitude, entries[j].latitude);
+                leaf.minLongitude = min(leaf.minLongitude, entries[j].longitude);
+                leaf.maxLongitude = max(leaf.maxLongitude, entries[j].longitude);
+            }
+            nodes.push_back(leaf);
+        }
+    }
+    for (const auto &entry : entries)
+        positions.push_back(Position(entry.latitude, entry.longitude));
+
+    int levelStart = 0;
+    while (nodes.size() - levelStart > 1) {
+        int levelEnd = (int) nodes.size();
+        int count = levelEnd - levelStart;
+        sliceSize = slices(count);
+        auto byLongitude = [](const Node &a, const Node &b) {
+            return a.minLongitude + a.maxLongitude < b.minLongitude + b.maxLongitude;
+        };
+        auto byLatitude = [](const Node &a, const Node &b) {
+            return a.minLatitude + a.maxLatitude < b.minLatitude + b.maxLatitude;
+        };
+        sort(nodes.begin() + levelStart, nodes.end(), byLongitude);
+        for (int s = levelStart; s < levelEnd; s += sliceSize) {
+            int end = min(levelEnd, s + sliceSize);
+            sort(nodes.begin() + s, nodes.begin() + end, byLatitude);
+            for (int i = s; i < end; i += capacity) {
+                Node parent = {90, 180, -90, -180, i, min(capacity, end - i), false};
+                for (int j = i; j < i + parent.count; j++) {
+                    parent.minLatitude = min(parent.minLatitude, nodes[j].minLatitude);
+                    parent.maxLatitude = max(parent.maxLatitude, nodes[j].maxLatitude);
+                    parent.minLongitude = min(parent.minLongitude, nodes[j].minLongitude);
+                    parent.maxLongitude = max(parent.maxLongitude, nodes[j].maxLongitude);
+                }
+                nodes.push_back(parent);
+            }
+        }
+        levelStart = levelEnd;
+    }
+}
+
+/**
+ * @brief Gets the number of indexed points.
+ *
+ * @return The number of points.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int RTree::size() const {
+    return (int) entries.size();
+}
+
+/**
+ * @brief Calculates the dot product between a position and the closest point of the bounding box of a node.
+ *
+ * @param node The node.
+ * @param position The position.
+ *
+ * @return The largest dot product between the position and any point of the box (1 if the position is inside it).
+ *
+ * @info If the position is within the longitudes of the box, the closest point is on its own meridian. Otherwise it
+ * is on one of the two meridian edges, at the latitude where the position projects on that meridian, clamped to the
+ * box. The result is exact, so it is a valid bound for pruning.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double RTree::maxDot(const Node &node, const Position &position) {
+    double latitude = position.getLatitude();
+    double longitude = position.getLongitude();
+    if (longitude >= node.minLongitude && longitude <= node.maxLongitude) {
+        double gap = max(0.0, max(node.minLatitude - latitude, latitude - node.maxLatitude));
+        return cos(Position::toRadians(gap));
+    }
+
+    auto toMeridian = [&](double edgeLongitude) {
+        double phi = Position::toRadians(latitude);
+        double dLon = Position::toRadians(edgeLongitude - longitude);
+        double closest = atan2(sin(phi), cos(phi) * cos(dLon)) * 180.0 / M_PI;
+        closest = min(max(closest, node.minLatitude), node.maxLatitude);
+        return position.dot(Position(closest, edgeLongitude));
+    };
+    return max(toMeridian(node.minLongitude), toMeridian(node.maxLongitude));
+}
+
+/**
+ * @brief Recursive helper of queryBox.
+ *
+ * @param node The index of the current node.
+ * @param minLatitude The southern edge of the box.
+ * @param minLongitude The western edge of the box.
+ * @param maxLatitude The northern edge of the box.
+ * @param maxLongitude The eastern edge of the box.
+ * @param res The ids found so far.
+ *
+ * @complexity Time Complexity: O(log N + K), where K is the number of points found.
+ */
+void RTree::searchBox(int node, double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                      vector<int> &res) const {
+    const Node &n = nodes[node];
+    if (n.maxLatitude < minLatitude || n.minLatitude > maxLatitude ||
+        n.maxLongitude < minLongitude || n.minLongitude > maxLongitude)
+        return;
+    for (int i = n.first; i < n.first + n.count; i++) {
+        if (!n.leaf) {
+            searchBox(i, minLatitude, minLongitude, maxLatitude, maxLongitude, res);
+        } else if (entries[i].latitude >= minLatitude && entries[i].latitude <= maxLatitude &&
+                   entries[i].longitude >= minLongitude && entries[i].longitude <= maxLongitude) {
+            res.push_back(entries[i].id);
+        }
+    }
+}
+
+/**
+ * @brief Finds the points inside a latitude/longitude box.
+ *
+ * @param minLatitude The southern edge of the box.
+ * @param minLongitude The western edge of the box.
+ * @param maxLatitude The northern edge of the box.
+ * @param maxLongitude The eastern edge of the box. If it is smaller than minLongitude, the box crosses the
+ * antimeridian.
+ *
+ * @return The ids of the points inside the box.
+ *
+ * @complexity Time Complexity: O(log N + K), where K is the number of points found.
+ */
+vector<int> RTree::queryBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const {
+    vector<int> res;
+    if (nodes.empty())
+        return res;
+    int root = (int) nodes.size() - 1;
+    if (minLongitude <= maxLongitude) {
+        searchBox(root, minLatitude, minLongitude, maxLatitude, maxLongitude, res);
+    } else {
+        searchBox(root, minLatitude, minLongitude, maxLatitude, 180, res);
+        searchBox(root, minLatitude, -180, maxLatitude, maxLongitude, res);
+    }
+    return res;
+}
+
+/**
+ * @brief Finds the points within a great-circle distance of a position.
+ *
+ * @param center The position.
+ * @param radius The distance, in kilometers.
+ *
+ * @return The distance and the id of every point found, closest first.
+ *
+ * @info The radius is turned into a dot product threshold once; nodes and points are then filtered by dot product and
+ * the haversine distance is only calculated for the points found.
+ *
+ * @complexity Time Complexity: O(log N + K log K), where K is the number of points found.
+ */
+vector<pair<double, int>> RTree::queryRadius(const Position &center, double radius) const {
+    vector<pair<double, int>> res;
+    if (nodes.empty())
+        return res;
+    double threshold = Position::distanceToDot(radius);
+    vector<int> stack = {(int) nodes.size() - 1};
+    while (!stack.empty()) {
+        const Node &n = nodes[stack.back()];
+        stack.pop_back();
+        for (int i = n.first; i < n.first + n.count; i++) {
+            if (!n.leaf) {
+                if (maxDot(nodes[i], center) >= threshold)
+                    stack.push_back(i);
+            } else if (center.dot(positions[i]) >= threshold) {
+                res.push_back({center.haversineDistance(positions[i]), entries[i].id});
+            }
+        }
+    }
+    sort(res.begin(), res.end());
+    return res;
+}
+
+/**
+ * @brief Finds the k points closest to a position.
+ *
+ * @param position The position.
+ * @param k The number of points.
+ *
+ * @return The distance and the id of the k closest points, closest first.
+ *
+ * @info Best-first search: nodes and points share a priority queue ordered by their (exact) dot product with the
+ * position, so a point is reported only when nothing left in the queue can be closer. The haversine distance is only
+ * calculated for the k points reported.
+ *
+ * @complexity Time Complexity: O((log N + k) log N) in practice.
+ */
+vector<pair<double, int>> RTree::nearest(const Position &position, int k) const {
+    vector<pair<double, int>> res;
+    if (nodes.empty() || k <= 0)
+        return res;
+
+    typedef tuple<double, bool, int> Item;    // minus the dot product, is a point, index
+    priority_queue<Item, vector<Item>, greater<Item>> queue;
+    queue.push(Item(-1.0, false, (int) nodes.size() - 1));
+    while (!queue.empty() && (int) res.size() < k) {
+        Item item = queue.top();
+        queue.pop();
+        int index = get<2>(item);
+        if (get<1>(item)) {
+            res.push_back({position.haversineDistance(positions[index]), entries[index].id});
+            continue;
+        }
+        const Node &n = nodes[index];
+        for (int i = n.first; i < n.first + n.count; i++) {
+            if (n.leaf)
+                queue.push(Item(-position.dot(positions[i]), true, i));
+            else
+                queue.push(Item(-maxDot(nodes[i], position), false, i));
+        }
+    }
+    return res;
+}
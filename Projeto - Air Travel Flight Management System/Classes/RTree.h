@@ -0,0 +1,46 @@
+
+#ifndef PROJETO2_RTREE_H
+#define PROJETO2_RTREE_H
+
+
+#include <utility>
+#include <vector>
+#include "Position.h"
+
+struct SpatialEntry {
+    double latitude;    ///< latitude in degrees
+    double longitude;   ///< longitude in degrees
+    int id;             ///< id of the indexed object (the vertex id of an airport)
+};
+
+class RTree {
+public:
+    RTree();
+
+    void build(std::vector<SpatialEntry> points);
+    int size() const;
+    std::vector<int> queryBox(double minLatitude, double minLongitude, double maxLatitude, double maxLongitude) const;
+    std::vector<std::pair<double, int>> queryRadius(const Position &center, double radius) const;
+    std::vector<std::pair<double, int>> nearest(const Position &position, int k) const;
+
+private:
+    struct Node {
+        double minLatitude, minLongitude, maxLatitude, maxLongitude;    ///< bounding box of the children
+        int first;      ///< index of the first child (in nodes, or in entries for leaves)
+        int count;      ///< number of children
+        bool leaf;      ///< whether the children are entries
+    };
+
+    static const int capacity = 16;     ///< maximum number of children of a node
+
+    std::vector<Node> nodes;            ///< every node, level by level, the root last
+    std::vector<SpatialEntry> entries;  ///< the indexed points, in leaf order
+    std::vector<Position> positions;    ///< position (with its unit vector) of each entry, in leaf order
+
+    static double maxDot(const Node &node, const Position &position);
+    void searchBox(int node, double minLatitude, double minLongitude, double maxLatitude, double maxLongitude,
+                   std::vector<int> &res) const;
+};
+
+
+#endif //PROJETO2_RTREE_H
@@ -0,0 +1,124 @@
+
+#include "RadixHeap.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the RadixHeap class.
+ *
+ * @info A radix heap is a monotone priority queue: a pushed key must not be smaller than the last popped key, which
+ * always holds in Dijkstra's algorithm. Non-negative doubles are ordered like their bit patterns, so keys are stored as
+ * 64-bit integers and the order is exact.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+RadixHeap::RadixHeap() : last(0), count(0) {}
+
+/**
+ * @brief Converts a non-negative double into an integer with the same order.
+ *
+ * @param key The key.
+ *
+ * @return The bit pattern of the key.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+uint64_t RadixHeap::toKey(double key) {
+    uint64_t bits;
+    memcpy(&bits, &key, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Converts a key back into a double.
+ *
+ * @param key The bit pattern.
+ *
+ * @return The double.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double RadixHeap::fromKey(uint64_t key) {
+    double value;
+    memcpy(&value, &key, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Gets the bucket of a key.
+ *
+ * @param key The key.
+ *
+ * @return 0 if the key equals the last popped key, otherwise 1 + the position of the highest differing bit.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int RadixHeap::bucketOf(uint64_t key) const {
+    return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+}
+
+/**
+ * @brief Checks if the heap is empty.
+ *
+ * @return True if there are no entries.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool RadixHeap::empty() const {
+    return count == 0;
+}
+
+/**
+ * @brief Inserts an entry.
+ *
+ * @param key The priority, non-negative and not smaller than the last popped key.
+ * @param value The value.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void RadixHeap::push(double key, int value) {
+    uint64_t k = toKey(key);
+    buckets[bucketOf(k)].push_back({k, value});
+    count++;
+}
+
+/**
+ * @brief Removes an entry with the smallest key.
+ *
+ * @return The key and the value of the entry. The heap must not be empty.
+ *
+ * @info When bucket 0 is empty, the first non-empty bucket is redistributed around its minimum. Each entry moves to a
+ * lower bucket every time it is redistributed, so it moves at most 64 times.
+ *
+ * @complexity Time Complexity: O(log C) amortized, where C is the range of the keys (64 bits).
+ */
+pair<double, int> RadixHeap::pop() {
+    if (buckets[0].empty()) {
+        int i = 1;
+        while (buckets[i].empty())
+            i++;
+        auto &bucket = buckets[i];
+        last = min_element(bucket.begin(), bucket.end())->first;
+        for (const auto &entry : bucket)
+            buckets[bucketOf(entry.first)].push_back(entry);
+        bucket.clear();
+    }
+    auto entry = buckets[0].back();
+    buckets[0].pop_back();
+    count--;
+    return {fromKey(entry.first), entry.second};
+}
+
+/**
+ * @brief Removes every entry and resets the lower bound, keeping the allocated memory for the next search.
+ *
+ * @complexity Time Complexity: O(1) per bucket.
+ */
+void RadixHeap::clear() {
+    for (auto &bucket : buckets)
+        bucket.clear();
+    last = 0;
+    count = 0;
+}
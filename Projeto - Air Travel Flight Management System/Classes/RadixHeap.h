@@ -0,0 +1,30 @@
+
+#ifndef PROJETO2_RADIXHEAP_H
+#define PROJETO2_RADIXHEAP_H
+
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class RadixHeap {
+public:
+    RadixHeap();
+
+    bool empty() const;
+    void push(double key, int value);
+    std::pair<double, int> pop();
+    void clear();
+
+private:
+    std::vector<std::pair<std::uint64_t, int>> buckets[65];    ///< bucket i holds keys whose highest bit differing from last is i - 1
+    std::uint64_t last;                                         ///< last popped key, a lower bound of every key
+    std::size_t count;                                          ///< number of stored entries
+
+    static std::uint64_t toKey(double key);
+    static double fromKey(std::uint64_t key);
+    int bucketOf(std::uint64_t key) const;
+};
+
+
+#endif //PROJETO2_RADIXHEAP_H
@@ -0,0 +1,211 @@
+
+#include "ResilienceAnalysis.h"
+#include "DisjointSet.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the ResilienceAnalysis class.
+ *
+ * @param graph The flights graph.
+ *
+ * @info Builds the undirected route projection of the graph: every pair of airports connected by at least one flight,
+ * in either direction and by any airline, becomes a single route.
+ *
+ * @complexity Time Complexity: O(V + E log E), where V is the number of vertices and E is the number of edges.
+ */
+ResilienceAnalysis::ResilienceAnalysis(const Graph &graph) {
+    numberOfAirports = graph.getNumVertex();
+    for (auto vertex : graph.getVertexSet()) {
+        for (const auto &edge : vertex->getAdj()) {
+            int u = vertex->getId();
+            int v = edge.getDest()->getId();
+            if (u != v)
+                routes.push_back({min(u, v), max(u, v)});
+        }
+    }
+    sort(routes.begin(), routes.end());
+    routes.erase(unique(routes.begin(), routes.end()), routes.end());
+
+    degree.assign(numberOfAirports, 0);
+    for (const auto &route : routes) {
+        degree[route.first]++;
+        degree[route.second]++;
+    }
+}
+
+/**
+ * @brief Gets the number of airports of the projection.
+ *
+ * @return The number of airports.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int ResilienceAnalysis::getNumberOfAirports() const {
+    return numberOfAirports;
+}
+
+/**
+ * @brief Gets the number of undirected routes of the projection.
+ *
+ * @return The number of routes.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int ResilienceAnalysis::getNumberOfRoutes() const {
+    return (int) routes.size();
+}
+
+/**
+ * @brief Gets a printable name for a failure mode.
+ *
+ * @param mode The failure mode.
+ *
+ * @return The name of the mode, as written to the CSV output.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+string ResilienceAnalysis::getModeName(FailureMode mode) {
+    switch (mode) {
+        case FailureMode::RandomAirports: return "random-airports";
+        case FailureMode::TargetedAirports: return "targeted-airports";
+        case FailureMode::RandomRoutes: return "random-routes";
+        case FailureMode::TargetedRoutes: return "targeted-routes";
+    }
+    return "";
+}
+
+/**
+ * @brief Derives the seed of a single trial from the seed of the whole run.
+ *
+ * @param seed The seed of the run.
+ * @param step The index of the removed fraction.
+ * @param trial The index of the trial.
+ *
+ * @return An independent seed for the trial.
+ *
+ * @info Uses the SplitMix64 finalizer, so consecutive trials get unrelated random streams and the result of a trial
+ * does not depend on which thread runs it.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+unsigned long long ResilienceAnalysis::trialSeed(unsigned long long seed, unsigned long long step, unsigned long long trial) {
+    unsigned long long z = seed + 0x9E3779B97F4A7C15ULL * (step * 1000003ULL + trial + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Removes a fraction of the network and measures what is left connected.
+ *
+ * @param mode Whether airports or routes fail, and whether they are chosen at random or by degree.
+ * @param fraction The fraction (0 to 1) of airports or routes to remove.
+ * @param seed The seed of the trial. Targeted modes use it to break ties between equal degrees.
+ *
+ * @return The size of the largest connected component and the number of ordered pairs of airports still connected.
+ *
+ * @complexity Time Complexity: O(V log V + R α(V)), where R is the number of undirected routes.
+ */
+ResilienceSample ResilienceAnalysis::runTrial(FailureMode mode, double fraction, unsigned long long seed) const {
+    mt19937_64 rng(seed);
+    vector<bool> airportAlive(numberOfAirports, true);
+    vector<bool> routeAlive(routes.size(), true);
+
+    bool airports = mode == FailureMode::RandomAirports || mode == FailureMode::TargetedAirports;
+    int total = airports ? numberOfAirports : (int) routes.size();
+    int removed = min(total, (int) lround(fraction * total));
+
+    vector<int> order(total);
+    for (int i = 0; i < total; i++)
+        order[i] = i;
+    shuffle(order.begin(), order.end(), rng);
+
+    if (mode == FailureMode::TargetedAirports) {
+        stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            return degree[a] > degree[b];
+        });
+    } else if (mode == FailureMode::TargetedRoutes) {
+        stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            return (long long) degree[routes[a].first] * degree[routes[a].second] >
+                   (long long) degree[routes[b].first] * degree[routes[b].second];
+        });
+    }
+
+    for (int i = 0; i < removed; i++) {
+        if (airports)
+            airportAlive[order[i]] = false;
+        else
+            routeAlive[order[i]] = false;
+    }
+
+    DisjointSet components(numberOfAirports);
+    for (int r = 0; r < (int) routes.size(); r++) {
+        const auto &route = routes[r];
+        if (routeAlive[r] && airportAlive[route.first] && airportAlive[route.second])
+            components.unite(route.first, route.second);
+    }
+
+    ResilienceSample sample = {0, 0};
+    for (int v = 0; v < numberOfAirports; v++) {
+        if (airportAlive[v] && components.find(v) == v) {
+            int size = components.getSize(v);
+            sample.largestComponent = max(sample.largestComponent, size);
+            sample.reachablePairs += (long long) size * (size - 1);
+        }
+    }
+    return sample;
+}
+
+/**
+ * @brief Runs a batch of failure trials for each removed fraction and writes the aggregates as CSV.
+ *
+ * @param mode The failure mode.
+ * @param fractions The removed fractions (0 to 1) to evaluate.
+ * @param trials The number of trials per fraction.
+ * @param seed The seed of the run. The same seed always produces the same output.
+ * @param out The stream where the CSV is written. A row is flushed as soon as its fraction is done.
+ *
+ * @info Trials of the same fraction run in parallel, each one with its own seed and its own union-find, and are
+ * aggregated in trial order, so the output does not depend on the number of threads.
+ *
+ * @complexity Time Complexity: O(F * T * (V log V + R α(V)) / P), where F is the number of fractions, T the number of
+ * trials and P the number of hardware threads.
+ */
+void ResilienceAnalysis::run(FailureMode mode, const vector<double> &fractions, int trials, unsigned long long seed,
+                             ostream &out) const {
+    long long intactPairs = runTrial(mode, 0.0, seed).reachablePairs;
+
+    out << "mode,removed_fraction,trials,mean_largest_component,min_largest_component,max_largest_component,"
+           "stddev_largest_component,mean_reachable_pairs,relative_reachable_pairs" << endl;
+
+    for (int step = 0; step < (int) fractions.size(); step++) {
+        vector<ResilienceSample> samples(max(trials, 0));
+        parallelFor(samples.size(), [&](size_t trial) {
+            samples[trial] = runTrial(mode, fractions[step], trialSeed(seed, step, trial));
+        });
+        if (samples.empty())
+            continue;
+
+        double sum = 0, sumSquares = 0, pairs = 0;
+        int minComponent = numberOfAirports, maxComponent = 0;
+        for (const auto &sample : samples) {
+            sum += sample.largestComponent;
+            sumSquares += (double) sample.largestComponent * sample.largestComponent;
+            pairs += (double) sample.reachablePairs;
+            minComponent = min(minComponent, sample.largestComponent);
+            maxComponent = max(maxComponent, sample.largestComponent);
+        }
+        double mean = sum / samples.size();
+        double variance = max(0.0, sumSquares / samples.size() - mean * mean);
+        double meanPairs = pairs / samples.size();
+
+        out << getModeName(mode) << ',' << fractions[step] << ',' << samples.size() << ',' << mean << ','
+            << minComponent << ',' << maxComponent << ',' << sqrt(variance) << ',' << meanPairs << ','
+            << (intactPairs > 0 ? meanPairs / intactPairs : 0.0) << endl;
+    }
+}
@@ -0,0 +1,45 @@
+
+#ifndef PROJETO2_RESILIENCEANALYSIS_H
+#define PROJETO2_RESILIENCEANALYSIS_H
+
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+enum class FailureMode {
+    RandomAirports,     ///< airports removed uniformly at random
+    TargetedAirports,   ///< airports removed by decreasing degree
+    RandomRoutes,       ///< routes removed uniformly at random
+    TargetedRoutes      ///< routes removed by decreasing product of the degrees of their endpoints
+};
+
+struct ResilienceSample {
+    int largestComponent;       ///< number of airports in the largest connected component
+    long long reachablePairs;   ///< number of ordered pairs of airports connected by some path
+};
+
+class ResilienceAnalysis {
+public:
+    ResilienceAnalysis(const Graph &graph);
+
+    int getNumberOfAirports() const;
+    int getNumberOfRoutes() const;
+    ResilienceSample runTrial(FailureMode mode, double fraction, unsigned long long seed) const;
+    void run(FailureMode mode, const std::vector<double> &fractions, int trials, unsigned long long seed,
+             std::ostream &out) const;
+
+    static std::string getModeName(FailureMode mode);
+
+private:
+    int numberOfAirports;                       ///< number of vertices of the projection
+    std::vector<std::pair<int, int>> routes;    ///< undirected routes (u < v), without duplicates
+    std::vector<int> degree;                    ///< degree of each airport in the undirected projection
+
+    static unsigned long long trialSeed(unsigned long long seed, unsigned long long step, unsigned long long trial);
+};
+
+
+#endif //PROJETO2_RESILIENCEANALYSIS_H
@@ -0,0 +1,302 @@
+
+#include "RoaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+const int RoaringBitmap::arrayLimit;
+
+/**
+ * @brief Constructor for the RoaringBitmap class. The set starts empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+RoaringBitmap::RoaringBitmap() {}
+
+/**
+ * @brief Builds a set from sorted values.
+ *
+ * @param sorted The values, in increasing order and without repetitions.
+ *
+ * @complexity Time Complexity: O(n), where n is the number of values.
+ */
+RoaringBitmap::RoaringBitmap(const vector<uint32_t> &sorted) {
+    for (uint32_t value : sorted) {
+        uint16_t key = (uint16_t) (value >> 16);
+        if (containers.empty() || containers.back().key != key)
+            containers.push_back({key, 0, {}, {}});
+        Container &container = containers.back();
+        container.array.push_back((uint16_t) value);
+        container.cardinality++;
+    }
+    for (auto &container : containers)
+        normalize(container);
+}
+
+/**
+ * @brief Adds a value to the set.
+ *
+ * @param value The value.
+ *
+ * @complexity Time Complexity: O(C + a), where C is the number of containers and a the size of an array container.
+ */
+void RoaringBitmap::add(uint32_t value) {
+    uint16_t key = (uint16_t) (value >> 16), low = (uint16_t) value;
+    auto it = lower_bound(containers.begin(), containers.end(), key, [](const Container &container, uint16_t key) {
+        return container.key < key;
+    });
+    if (it == containers.end() || it->key != key)
+        it = containers.insert(it, {key, 0, {}, {}});
+    if (!it->bits.empty()) {
+        uint64_t mask = 1ULL << (low & 63);
+        if (!(it->bits[low >> 6] & mask)) {
+            it->bits[low >> 6] |= mask;
+            it->cardinality++;
+        }
+        return;
+    }
+    auto position = lower_bound(it->array.begin(), it->array.end(), low);
+    if (position != it->array.end() && *position == low)
+        return;
+    it->array.insert(position, low);
+    it->cardinality++;
+    normalize(*it);
+}
+
+/**
+ * @brief Checks if a value is in the set.
+ *
+ * @param value The value.
+ *
+ * @return True if the value is in the set.
+ *
+ * @complexity Time Complexity: O(log C + log a), where C is the number of containers and a the size of an array
+ * container.
+ */
+bool RoaringBitmap::contains(uint32_t value) const {
+    uint16_t key = (uint16_t) (value >> 16), low = (uint16_t) value;
+    auto it = lower_bound(containers.begin(), containers.end(), key, [](const Container &container, uint16_t key) {
+        return container.key < key;
+    });
+    if (it == containers.end() || it->key != key)
+        return false;
+    if (!it->bits.empty())
+        return (it->bits[low >> 6] >> (low & 63)) & 1;
+    return binary_search(it->array.begin(), it->array.end(), low);
+}
+
+/**
+ * @brief Gets the number of values in the set.
+ *
+ * @return The cardinality of the set.
+ *
+ * @complexity Time Complexity: O(C), where C is the number of containers.
+ */
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const auto &container : containers)
+        total += container.cardinality;
+    return total;
+}
+
+/**
+ * @brief Checks if the set is empty.
+ *
+ * @return True if the set has no values.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool RoaringBitmap::isEmpty() const {
+    return containers.empty();
+}
+
+/**
+ * @brief Lists the values of the set.
+ *
+ * @return The values, in increasing order.
+ *
+ * @complexity Time Complexity: O(n + C * 1024), where n is the number of values and C the number of containers.
+ */
+vector<uint32_t> RoaringBitmap::toVector() const {
+    vector<uint32_t> values;
+    values.reserve(cardinality());
+    for (const auto &container : containers) {
+        uint32_t high = (uint32_t) container.key << 16;
+        if (container.bits.empty()) {
+            for (uint16_t low : container.array)
+                values.push_back(high | low);
+            continue;
+        }
+        for (uint32_t word = 0; word < container.bits.size(); word++) {
+            for (uint64_t bits = container.bits[word]; bits != 0; bits &= bits - 1)
+                values.push_back(high | (word << 6 | __builtin_ctzll(bits)));
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Expands a container into a bitmap.
+ *
+ * @param container The container.
+ * @param bits Set to the 1024 words of the bitmap of the container.
+ *
+ * @complexity Time Complexity: O(1024 + a), where a is the size of an array container.
+ */
+void RoaringBitmap::toBits(const Container &container, vector<uint64_t> &bits) {
+    if (!container.bits.empty()) {
+        bits = container.bits;
+        return;
+    }
+    bits.assign(1024, 0);
+    for (uint16_t low : container.array)
+        bits[low >> 6] |= 1ULL << (low & 63);
+}
+
+/**
+ * @brief Switches a container to the representation that suits its cardinality.
+ *
+ * @param container The container. Up to arrayLimit values it becomes a sorted array, above it a bitmap.
+ *
+ * @complexity Time Complexity: O(1024 + a), where a is the size of an array container, if it switches, O(1) otherwise.
+ */
+void RoaringBitmap::normalize(Container &container) {
+    if (container.bits.empty() && container.cardinality > arrayLimit) {
+        toBits(container, container.bits);
+        container.array.clear();
+        container.array.shrink_to_fit();
+    } else if (!container.bits.empty() && container.cardinality <= arrayLimit) {
+        container.array.clear();
+        for (uint32_t word = 0; word < container.bits.size(); word++) {
+            for (uint64_t bits = container.bits[word]; bits != 0; bits &= bits - 1)
+                container.array.push_back((uint16_t) (word << 6 | __builtin_ctzll(bits)));
+        }
+        container.bits.clear();
+        container.bits.shrink_to_fit();
+    }
+}
+
+/**
+ * @brief Combines two containers with the same key.
+ *
+ * @param a The first container.
+ * @param b The second container.
+ * @param operation The union, intersection or difference (a minus b).
+ *
+ * @return The combined container, possibly empty.
+ *
+ * @info Two arrays are merged; an array against a bitmap, in an intersection or difference, is filtered by probing the
+ * bitmap; any other pair is combined a 64-bit word at a time, counting the result with popcount.
+ *
+ * @complexity Time Complexity: O(a + b) for two arrays, O(a) for an array probing a bitmap, O(1024) otherwise.
+ */
+RoaringBitmap::Container RoaringBitmap::combine(const Container &a, const Container &b, Operation operation) {
+    if (operation == Operation::Intersection && !a.bits.empty() && b.bits.empty())
+        return combine(b, a, operation);
+    Container res = {a.key, 0, {}, {}};
+    if (a.bits.empty() && b.bits.empty()) {
+        auto out = back_inserter(res.array);
+        if (operation == Operation::Union)
+            set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+        else if (operation == Operation::Intersection)
+            set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+        else
+            set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(), out);
+        res.cardinality = (int) res.array.size();
+    } else if (a.bits.empty() && operation != Operation::Union) {
+        bool keep = operation == Operation::Intersection;
+        for (uint16_t low : a.array) {
+            if ((bool) ((b.bits[low >> 6] >> (low & 63)) & 1) == keep)
+                res.array.push_back(low);
+        }
+        res.cardinality = (int) res.array.size();
+    } else {
+        vector<uint64_t> other;
+        toBits(a, res.bits);
+        toBits(b, other);
+        for (size_t word = 0; word < res.bits.size(); word++) {
+            if (operation == Operation::Union)
+                res.bits[word] |= other[word];
+            else if (operation == Operation::Intersection)
+                res.bits[word] &= other[word];
+            else
+                res.bits[word] &= ~other[word];
+            res.cardinality += __builtin_popcountll(res.bits[word]);
+        }
+    }
+    normalize(res);
+    return res;
+}
+
+/**
+ * @brief Combines two sets, container by container.
+ *
+ * @param a The first set.
+ * @param b The second set.
+ * @param operation The union, intersection or difference (a minus b).
+ *
+ * @return The combined set.
+ *
+ * @complexity Time Complexity: O(C + W), where C is the number of containers and W the work of combining the ones with
+ * the same key.
+ */
+RoaringBitmap RoaringBitmap::combine(const RoaringBitmap &a, const RoaringBitmap &b, Operation operation) {
+    RoaringBitmap res;
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() || j < b.containers.size()) {
+        if (j == b.containers.size() || (i < a.containers.size() && a.containers[i].key < b.containers[j].key)) {
+            if (operation != Operation::Intersection)
+                res.containers.push_back(a.containers[i]);
+            i++;
+        } else if (i == a.containers.size() || b.containers[j].key < a.containers[i].key) {
+            if (operation == Operation::Union)
+                res.containers.push_back(b.containers[j]);
+            j++;
+        } else {
+            Container container = combine(a.containers[i++], b.containers[j++], operation);
+            if (container.cardinality > 0)
+                res.containers.push_back(move(container));
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Gets the union of two sets.
+ *
+ * @param other The other set.
+ *
+ * @return The values in either set.
+ *
+ * @complexity Time Complexity: see combine.
+ */
+RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap &other) const {
+    return combine(*this, other, Operation::Union);
+}
+
+/**
+ * @brief Gets the intersection of two sets.
+ *
+ * @param other The other set.
+ *
+ * @return The values in both sets.
+ *
+ * @complexity Time Complexity: see combine.
+ */
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap &other) const {
+    return combine(*this, other, Operation::Intersection);
+}
+
+/**
+ * @brief Gets the difference of two sets.
+ *
+ * @param other The other set.
+ *
+ * @return The values in this set but not in the other.
+ *
+ * @complexity Time Complexity: see combine.
+ */
+RoaringBitmap RoaringBitmap::operator-(const RoaringBitmap &other) const {
+    return combine(*this, other, Operation::Difference);
+}
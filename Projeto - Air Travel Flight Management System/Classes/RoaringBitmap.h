@@ -0,0 +1,45 @@
+
+#ifndef PROJETO2_ROARINGBITMAP_H
+#define PROJETO2_ROARINGBITMAP_H
+
+
+#include <cstdint>
+#include <vector>
+
+class RoaringBitmap {
+public:
+    RoaringBitmap();
+    explicit RoaringBitmap(const std::vector<uint32_t> &sorted);
+
+    void add(uint32_t value);
+    bool contains(uint32_t value) const;
+    uint64_t cardinality() const;
+    bool isEmpty() const;
+    std::vector<uint32_t> toVector() const;
+
+    RoaringBitmap operator|(const RoaringBitmap &other) const;
+    RoaringBitmap operator&(const RoaringBitmap &other) const;
+    RoaringBitmap operator-(const RoaringBitmap &other) const;
+
+private:
+    enum class Operation { Union, Intersection, Difference };
+
+    struct Container {
+        uint16_t key;                       ///< high 16 bits of the values of the container
+        int cardinality;                    ///< number of values
+        std::vector<uint16_t> array;        ///< sorted low 16 bits, while the container holds at most arrayLimit values
+        std::vector<uint64_t> bits;         ///< 2^16-bit bitmap of the low 16 bits, once it holds more
+    };
+
+    static const int arrayLimit = 4096;     ///< largest array container, the size at which both kinds take 8 KB
+
+    std::vector<Container> containers;      ///< non-empty containers, sorted by key
+
+    static void toBits(const Container &container, std::vector<uint64_t> &bits);
+    static void normalize(Container &container);
+    static Container combine(const Container &a, const Container &b, Operation operation);
+    static RoaringBitmap combine(const RoaringBitmap &a, const RoaringBitmap &b, Operation operation);
+};
+
+
+#endif //PROJETO2_ROARINGBITMAP_H
@@ -0,0 +1,353 @@
+
+#include "RouteCorridorIndex.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const int RouteCorridorIndex::leafSize;
+
+static const double earthRadius = 6371.0;
+
+struct RouteCorridorIndex::Arc {
+    int source, target;
+    double a[3], b[3], n[3];
+    double min[3], max[3], centroid[3];
+};
+
+/**
+ * @brief Copies the unit vector of a position.
+ *
+ * @param position The position.
+ * @param v Output: the x, y and z coordinates.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+static void toUnitVector(const Position &position, double *v) {
+    v[0] = position.getX();
+    v[1] = position.getY();
+    v[2] = position.getZ();
+}
+
+static void cross(const double *u, const double *v, double *res) {
+    res[0] = u[1] * v[2] - u[2] * v[1];
+    res[1] = u[2] * v[0] - u[0] * v[2];
+    res[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+static double dot(const double *u, const double *v) {
+    return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+}
+
+/**
+ * @brief Checks if a point of the great circle of an arc lies on the arc.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+static bool onArc(const double *x, const double *a, const double *b, const double *n) {
+    double ax[3], xb[3];
+    cross(a, x, ax);
+    cross(x, b, xb);
+    return dot(ax, n) >= 0 && dot(xb, n) >= 0;
+}
+
+/**
+ * @brief Checks if two minor great-circle arcs cross.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+static bool arcsIntersect(const double *a1, const double *b1, const double *a2, const double *b2) {
+    double n1[3], n2[3], l[3];
+    cross(a1, b1, n1);
+    cross(a2, b2, n2);
+    cross(n1, n2, l);
+    if (dot(l, l) < 1e-24)
+        return false;
+    double m[3] = {-l[0], -l[1], -l[2]};
+    return (onArc(l, a1, b1, n1) && onArc(l, a2, b2, n2)) || (onArc(m, a1, b1, n1) && onArc(m, a2, b2, n2));
+}
+
+/**
+ * @brief Constructor for the RouteCorridorIndex class. The index starts empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+RouteCorridorIndex::RouteCorridorIndex() {}
+
+/**
+ * @brief Builds the index over the great-circle arcs of every route of a graph.
+ *
+ * @param graph The flights graph. Flights between the same two airports, in any direction, become a single arc.
+ * @param positions The position of every vertex, indexed by vertex id.
+ *
+ * @info Unit vectors, great-circle normals and the side planes of every arc are computed once and stored as separate
+ * arrays (one per coordinate) in the order of the leaves of a bounding volume hierarchy. The box of an arc is the box of
+ * its endpoints grown by its sagitta, so it contains the whole arc.
+ *
+ * @complexity Time Complexity: O(E log E), where E is the number of edges.
+ */
+void RouteCorridorIndex::build(const Graph &graph, const vector<Position> &positions) {
+    vector<pair<int, int>> routes;
+    for (auto vertex : graph.getVertexSet()) {
+        for (const auto &edge : vertex->getAdj()) {
+            int u = vertex->getId(), v = edge.getDest()->getId();
+            if (u != v)
+                routes.push_back({min(u, v), max(u, v)});
+        }
+    }
+    sort(routes.begin(), routes.end());
+    routes.erase(unique(routes.begin(), routes.end()), routes.end());
+
+    vector<Arc> arcs;
+    for (const auto &route : routes) {
+        Arc arc;
+        arc.source = route.first;
+        arc.target = route.second;
+        toUnitVector(positions[route.first], arc.a);
+        toUnitVector(positions[route.second], arc.b);
+        cross(arc.a, arc.b, arc.n);
+        double length = sqrt(dot(arc.n, arc.n));
+        if (length < 1e-12)
+            continue;   // both airports at the same place (or antipodal): no defined arc
+        double cosine = dot(arc.a, arc.b);
+        double sagitta = 1 - sqrt(max(0.0, (1 + cosine) / 2));
+        for (int i = 0; i < 3; i++) {
+            arc.n[i] /= length;
+            arc.min[i] = min(arc.a[i], arc.b[i]) - sagitta;
+            arc.max[i] = max(arc.a[i], arc.b[i]) + sagitta;
+            arc.centroid[i] = (arc.a[i] + arc.b[i]) / 2;
+        }
+        arcs.push_back(arc);
+    }
+
+    nodes.clear();
+    for (auto array : {&sources, &targets})
+        array->clear();
+    for (auto array : {&ax, &ay, &az, &bx, &by, &bz, &nx, &ny, &nz, &sx, &sy, &sz, &ex, &ey, &ez})
+        array->clear();
+    if (!arcs.empty())
+        buildNode(arcs, 0, (int) arcs.size());
+}
+
+/**
+ * @brief Recursively builds a node of the hierarchy, splitting the arcs at the median of their longest axis.
+ *
+ * @param arcs The arcs being indexed.
+ * @param first The first arc of the node.
+ * @param last One past the last arc of the node.
+ *
+ * @return The index of the node.
+ *
+ * @complexity Time Complexity: O(N log N), where N is last - first.
+ */
+int RouteCorridorIndex::buildNode(vector<Arc> &arcs, int first, int last) {
+    int index = (int) nodes.size();
+    nodes.push_back(Node());
+    Node node = {{1e9, 1e9, 1e9}, {-1e9, -1e9, -1e9}, -1, -1, 0, 0};
+    double low[3] = {1e9, 1e9, 1e9}, high[3] = {-1e9, -1e9, -1e9};
+    for (int i = first; i < last; i++) {
+        for (int d = 0; d < 3; d++) {
+            node.min[d] = min(node.min[d], arcs[i].min[d]);
+            node.max[d] = max(node.max[d], arcs[i].max[d]);
+            low[d] = min(low[d], arcs[i].centroid[d]);
+            high[d] = max(high[d], arcs[i].centroid[d]);
+        }
+    }
+
+    if (last - first <= leafSize) {
+        node.first = (int) sources.size();
+        node.count = last - first;
+        for (int i = first; i < last; i++) {
+            const Arc &arc = arcs[i];
+            double s[3], e[3];
+            cross(arc.n, arc.a, s);
+            cross(arc.b, arc.n, e);
+            sources.push_back(arc.source);
+            targets.push_back(arc.target);
+            ax.push_back(arc.a[0]); ay.push_back(arc.a[1]); az.push_back(arc.a[2]);
+            bx.push_back(arc.b[0]); by.push_back(arc.b[1]); bz.push_back(arc.b[2]);
+            nx.push_back(arc.n[0]); ny.push_back(arc.n[1]); nz.push_back(arc.n[2]);
+            sx.push_back(s[0]); sy.push_back(s[1]); sz.push_back(s[2]);
+            ex.push_back(e[0]); ey.push_back(e[1]); ez.push_back(e[2]);
+        }
+        nodes[index] = node;
+        return index;
+    }
+
+    int axis = 0;
+    for (int d = 1; d < 3; d++)
+        if (high[d] - low[d] > high[axis] - low[axis])
+            axis = d;
+    int middle = (first + last) / 2;
+    nth_element(arcs.begin() + first, arcs.begin() + middle, arcs.begin() + last, [axis](const Arc &x, const Arc &y) {
+        return x.centroid[axis] < y.centroid[axis];
+    });
+    node.left = buildNode(arcs, first, middle);
+    node.right = buildNode(arcs, middle, last);
+    nodes[index] = node;
+    return index;
+}
+
+/**
+ * @brief Gets the number of indexed arcs.
+ *
+ * @return The number of arcs.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int RouteCorridorIndex::size() const {
+    return (int) sources.size();
+}
+
+/**
+ * @brief Collects the leaves whose box is within a chord distance of a unit vector.
+ *
+ * @param center The unit vector.
+ * @param chord The straight-line distance (through the Earth) on the unit sphere.
+ * @param ranges Output: the [first, last) arc ranges of the leaves found.
+ *
+ * @complexity Time Complexity: O(log N + L), where L is the number of leaves found.
+ */
+void RouteCorridorIndex::candidates(const double *center, double chord, vector<pair<int, int>> &ranges) const {
+    if (nodes.empty())
+        return;
+    vector<int> stack = {0};
+    while (!stack.empty()) {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        double squared = 0;
+        for (int d = 0; d < 3; d++) {
+            double gap = max(0.0, max(node.min[d] - center[d], center[d] - node.max[d]));
+            squared += gap * gap;
+        }
+        if (squared > chord * chord)
+            continue;
+        if (node.count > 0) {
+            ranges.push_back({node.first, node.first + node.count});
+        } else {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+        }
+    }
+}
+
+/**
+ * @brief Finds the routes whose great-circle arc passes within a distance of a point.
+ *
+ * @param point The position.
+ * @param radius The distance, in kilometers.
+ *
+ * @return The routes found, closest first, with their exact cross-track (or endpoint) distance.
+ *
+ * @info The candidate arcs of each leaf are tested in one branch-free loop over the coordinate arrays using only dot
+ * products: the point projects inside the arc when p . (n x a) >= 0 and p . (b x n) >= 0, and is then within the
+ * radius when |p . n| <= sin(radius / R); otherwise the closest endpoint must satisfy p . a >= cos(radius / R).
+ * Trigonometry is only used to report the distance of the matches.
+ *
+ * @complexity Time Complexity: O(log N + C + K log K), where C is the number of candidates and K of matches.
+ */
+vector<CorridorMatch> RouteCorridorIndex::queryPoint(const Position &point, double radius) const {
+    vector<CorridorMatch> res;
+    double angle = min(radius / earthRadius, M_PI);
+    double p[3];
+    toUnitVector(point, p);
+    vector<pair<int, int>> ranges;
+    candidates(p, 2 * sin(angle / 2), ranges);
+
+    const double sinAngle = angle >= M_PI / 2 ? 1.0 : sin(angle), cosAngle = cos(angle);
+    const double px = p[0], py = p[1], pz = p[2];
+    vector<double> crossTrack, endpoint;
+    vector<unsigned char> hit, inside;
+    for (const auto &range : ranges) {
+        int n = range.second - range.first;
+        crossTrack.resize(n);
+        endpoint.resize(n);
+        hit.resize(n);
+        inside.resize(n);
+        const int o = range.first;
+        for (int i = 0; i < n; i++) {
+            double pn = px * nx[o + i] + py * ny[o + i] + pz * nz[o + i];
+            double ps = px * sx[o + i] + py * sy[o + i] + pz * sz[o + i];
+            double pe = px * ex[o + i] + py * ey[o + i] + pz * ez[o + i];
+            double pa = px * ax[o + i] + py * ay[o + i] + pz * az[o + i];
+            double pb = px * bx[o + i] + py * by[o + i] + pz * bz[o + i];
+            bool projects = ps >= 0 && pe >= 0;
+            double closest = pa > pb ? pa : pb;
+            double absolute = pn < 0 ? -pn : pn;
+            crossTrack[i] = absolute;
+            endpoint[i] = closest;
+            inside[i] = projects;
+            hit[i] = projects ? absolute <= sinAngle : closest >= cosAngle;
+        }
+        for (int i = 0; i < n; i++) {
+            if (!hit[i])
+                continue;
+            double d = inside[i] ? asin(min(1.0, crossTrack[i])) : acos(max(-1.0, min(1.0, endpoint[i])));
+            res.push_back({sources[o + i], targets[o + i], d * earthRadius});
+        }
+    }
+    sort(res.begin(), res.end(), [](const CorridorMatch &a, const CorridorMatch &b) {
+        return a.distance < b.distance;
+    });
+    return res;
+}
+
+/**
+ * @brief Finds the routes whose great-circle arc crosses or lies inside a region.
+ *
+ * @param polygon The vertices of the region, in order, joined by great-circle edges. The region must be smaller than a
+ * hemisphere.
+ *
+ * @return The (source, target) vertex ids of the routes found.
+ *
+ * @info Candidates are the arcs near the smallest cap around the polygon. A candidate matches if its source is inside
+ * the polygon (an arc from it to the antipode of the cap centre crosses the boundary an odd number of times) or if it
+ * crosses some edge of the polygon.
+ *
+ * @complexity Time Complexity: O(log N + C * P), where C is the number of candidates and P the number of vertices of
+ * the polygon.
+ */
+vector<pair<int, int>> RouteCorridorIndex::queryPolygon(const vector<Position> &polygon) const {
+    vector<pair<int, int>> res;
+    if (polygon.size() < 3)
+        return res;
+
+    int m = (int) polygon.size();
+    vector<double> vertices(3 * m);
+    double center[3] = {0, 0, 0};
+    for (int i = 0; i < m; i++) {
+        toUnitVector(polygon[i], &vertices[3 * i]);
+        for (int d = 0; d < 3; d++)
+            center[d] += vertices[3 * i + d];
+    }
+    double length = sqrt(dot(center, center));
+    if (length < 1e-12)
+        return res;
+    double capCosine = 1;
+    for (int d = 0; d < 3; d++)
+        center[d] /= length;
+    for (int i = 0; i < m; i++)
+        capCosine = min(capCosine, dot(center, &vertices[3 * i]));
+    double capAngle = acos(max(-1.0, capCosine));
+    double outside[3] = {-center[0], -center[1], -center[2]};
+
+    auto crossesBoundary = [&](const double *a, const double *b) {
+        int crossings = 0;
+        for (int i = 0; i < m; i++) {
+            if (arcsIntersect(a, b, &vertices[3 * i], &vertices[3 * ((i + 1) % m)]))
+                crossings++;
+        }
+        return crossings;
+    };
+
+    vector<pair<int, int>> ranges;
+    candidates(center, 2 * sin(capAngle / 2), ranges);
+    for (const auto &range : ranges) {
+        for (int i = range.first; i < range.second; i++) {
+            double a[3] = {ax[i], ay[i], az[i]}, b[3] = {bx[i], by[i], bz[i]};
+            if (crossesBoundary(a, b) > 0 || crossesBoundary(a, outside) % 2 == 1)
+                res.push_back({sources[i], targets[i]});
+        }
+    }
+    return res;
+}
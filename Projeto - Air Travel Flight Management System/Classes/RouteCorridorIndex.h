@@ -0,0 +1,50 @@
+
+#ifndef PROJETO2_ROUTECORRIDORINDEX_H
+#define PROJETO2_ROUTECORRIDORINDEX_H
+
+
+#include <utility>
+#include <vector>
+#include "Graph.h"
+#include "Position.h"
+
+struct CorridorMatch {
+    int source;         ///< vertex id of one end of the route
+    int target;         ///< vertex id of the other end of the route
+    double distance;    ///< great-circle distance from the query point to the route, in km
+};
+
+class RouteCorridorIndex {
+public:
+    RouteCorridorIndex();
+
+    void build(const Graph &graph, const std::vector<Position> &positions);
+    int size() const;
+    std::vector<CorridorMatch> queryPoint(const Position &point, double radius) const;
+    std::vector<std::pair<int, int>> queryPolygon(const std::vector<Position> &polygon) const;
+
+private:
+    struct Arc;
+
+    struct Node {
+        double min[3], max[3];  ///< 3D bounding box of the arcs below the node
+        int left, right;        ///< children of an inner node
+        int first, count;       ///< arcs of a leaf (count is 0 for inner nodes)
+    };
+
+    static const int leafSize = 8;      ///< maximum number of arcs of a leaf
+
+    std::vector<Node> nodes;            ///< the bounding volume hierarchy, root first
+    std::vector<int> sources, targets;  ///< endpoints of each arc, in leaf order
+    std::vector<double> ax, ay, az;     ///< unit vector of the source of each arc
+    std::vector<double> bx, by, bz;     ///< unit vector of the target of each arc
+    std::vector<double> nx, ny, nz;     ///< unit normal of the great circle of each arc
+    std::vector<double> sx, sy, sz;     ///< n x a: p projects past the source when p . (n x a) >= 0
+    std::vector<double> ex, ey, ez;     ///< b x n: p projects before the target when p . (b x n) >= 0
+
+    int buildNode(std::vector<Arc> &arcs, int first, int last);
+    void candidates(const double *center, double chord, std::vector<std::pair<int, int>> &ranges) const;
+};
+
+
+#endif //PROJETO2_ROUTECORRIDORINDEX_H
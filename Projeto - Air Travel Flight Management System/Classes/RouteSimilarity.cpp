@@ -0,0 +1,224 @@
+
+#include "RouteSimilarity.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * @brief SplitMix64 finalizer, used as the family of hash functions of the signatures.
+ *
+ * @param x The value to hash.
+ *
+ * @return A well mixed 64-bit hash of x.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+uint64_t RouteSimilarity::mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Constructor for the RouteSimilarity class.
+ *
+ * @param graph The flights graph.
+ * @param numHashes The length of the MinHash signatures, later split into LSH bands by findOverlaps.
+ *
+ * @info Builds the MinHash signature and the sorted route set of every airline in a single pass over the adjacency
+ * of the graph. A route is the pair (source, target) of vertex ids.
+ *
+ * @complexity Time Complexity: O(E * H + E log E), where E is the number of edges and H the length of the signatures.
+ */
+RouteSimilarity::RouteSimilarity(const Graph &graph, int numHashes) : numHashes(numHashes) {
+    for (int i = 0; i < numHashes; i++)
+        hashSeeds.push_back(mix(0xA0761D6478BD642FULL * (i + 1)));
+
+    int numAirlines = graph.getNumAirlines();
+    uint64_t numVertex = graph.getNumVertex();
+    signatures.assign((size_t) numAirlines * numHashes, numeric_limits<uint64_t>::max());
+    routes.assign(numAirlines, {});
+
+    for (auto vertex : graph.getVertexSet()) {
+        for (const auto &edge : vertex->getAdj()) {
+            int airline = edge.getAirlineId();
+            uint64_t route = vertex->getId() * numVertex + edge.getDest()->getId();
+            routes[airline].push_back(route);
+            uint64_t *signature = &signatures[(size_t) airline * numHashes];
+            for (int i = 0; i < numHashes; i++)
+                signature[i] = min(signature[i], mix(route ^ hashSeeds[i]));
+        }
+    }
+
+    for (auto &airlineRoutes : routes) {
+        sort(airlineRoutes.begin(), airlineRoutes.end());
+        airlineRoutes.erase(unique(airlineRoutes.begin(), airlineRoutes.end()), airlineRoutes.end());
+    }
+}
+
+/**
+ * @brief Gets the length of the signatures.
+ *
+ * @return The number of hash functions of each signature.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int RouteSimilarity::getNumHashes() const {
+    return numHashes;
+}
+
+/**
+ * @brief Gets the number of distinct routes flown by an airline.
+ *
+ * @param airline The id of the airline.
+ *
+ * @return The number of routes.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int RouteSimilarity::getNumberOfRoutes(int airline) const {
+    return (int) routes[airline].size();
+}
+
+/**
+ * @brief Estimates the Jaccard similarity of the route sets of two airlines from their signatures.
+ *
+ * @param a The id of the first airline.
+ * @param b The id of the second airline.
+ *
+ * @return The fraction of equal signature values.
+ *
+ * @complexity Time Complexity: O(H), where H is the length of the signatures.
+ */
+double RouteSimilarity::estimate(int a, int b) const {
+    const uint64_t *sa = &signatures[(size_t) a * numHashes];
+    const uint64_t *sb = &signatures[(size_t) b * numHashes];
+    int equal = 0;
+    for (int i = 0; i < numHashes; i++)
+        equal += sa[i] == sb[i];
+    return (double) equal / numHashes;
+}
+
+/**
+ * @brief Computes the exact Jaccard similarity of the route sets of two airlines.
+ *
+ * @param a The id of the first airline.
+ * @param b The id of the second airline.
+ * @param shared Output: the number of routes flown by both airlines.
+ *
+ * @return |A ∩ B| / |A ∪ B|, or 0 if both airlines have no routes.
+ *
+ * @complexity Time Complexity: O(|A| + |B|)
+ */
+double RouteSimilarity::jaccard(int a, int b, int &shared) const {
+    const auto &ra = routes[a];
+    const auto &rb = routes[b];
+    shared = 0;
+    for (size_t i = 0, j = 0; i < ra.size() && j < rb.size();) {
+        if (ra[i] < rb[j]) {
+            i++;
+        } else if (rb[j] < ra[i]) {
+            j++;
+        } else {
+            shared++;
+            i++;
+            j++;
+        }
+    }
+    size_t total = ra.size() + rb.size() - shared;
+    return total == 0 ? 0.0 : (double) shared / total;
+}
+
+/**
+ * @brief Chooses how many signature values go in each LSH band for a similarity threshold.
+ *
+ * @param threshold The minimum Jaccard similarity (0 to 1) of the pairs that must be found.
+ *
+ * @return The largest number of rows r such that a pair with exactly the threshold similarity shares one of the
+ * H / r bands with probability 1 - (1 - threshold ^ r) ^ (H / r) of at least 99%, or 0 if not even single-value
+ * bands reach it and every pair has to be verified.
+ *
+ * @info More rows per band mean fewer false candidates, so the largest safe r is taken.
+ *
+ * @complexity Time Complexity: O(H), where H is the length of the signatures.
+ */
+int RouteSimilarity::chooseRows(double threshold) const {
+    if (threshold <= 0)
+        return 0;
+    for (int rows = numHashes; rows >= 1; rows--) {
+        int bands = numHashes / rows;
+        double missed = pow(1 - pow(min(threshold, 1.0), rows), bands);
+        if (missed <= 0.01)
+            return rows;
+    }
+    return 0;
+}
+
+/**
+ * @brief Finds the pairs of airlines whose route sets overlap at least a given Jaccard similarity.
+ *
+ * @param threshold The minimum exact Jaccard similarity (0 to 1).
+ * @param candidates Output: the number of candidate pairs verified.
+ *
+ * @return The verified pairs, from the most to the least similar.
+ *
+ * @info Signatures are split into bands sized by chooseRows and every band is hashed into buckets; only airlines that
+ * share a bucket in some band become candidates, and only candidates are intersected exactly. This avoids all-pairs
+ * set intersection while finding a pair at the threshold with at least 99% probability. For thresholds too low for
+ * the signatures, every pair of airlines with routes is verified instead.
+ *
+ * @complexity Time Complexity: O(A * H + C * R), where A is the number of airlines, H the length of the signatures,
+ * C the number of candidates and R the number of routes of an airline.
+ */
+vector<AirlineOverlap> RouteSimilarity::findOverlaps(double threshold, int &candidates) const {
+    int numAirlines = (int) routes.size();
+    vector<pair<int, int>> pairs;
+
+    int rows = chooseRows(threshold);
+    if (rows == 0) {
+        for (int a = 0; a < numAirlines; a++)
+            for (int b = a + 1; b < numAirlines; b++)
+                if (!routes[a].empty() && !routes[b].empty())
+                    pairs.push_back({a, b});
+    }
+    int bands = rows == 0 ? 0 : numHashes / rows;
+    for (int band = 0; band < bands; band++) {
+        unordered_map<uint64_t, vector<int>> buckets;
+        for (int airline = 0; airline < numAirlines; airline++) {
+            if (routes[airline].empty())
+                continue;
+            const uint64_t *signature = &signatures[(size_t) airline * numHashes + band * rows];
+            uint64_t key = band;
+            for (int r = 0; r < rows; r++)
+                key = mix(key ^ signature[r]);
+            buckets[key].push_back(airline);
+        }
+        for (const auto &bucket : buckets) {
+            const auto &members = bucket.second;
+            for (size_t i = 0; i < members.size(); i++)
+                for (size_t j = i + 1; j < members.size(); j++)
+                    pairs.push_back({members[i], members[j]});
+        }
+    }
+    sort(pairs.begin(), pairs.end());
+    pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+    candidates = (int) pairs.size();
+
+    vector<AirlineOverlap> res;
+    for (const auto &p : pairs) {
+        int shared;
+        double similarity = jaccard(p.first, p.second, shared);
+        if (similarity >= threshold)
+            res.push_back({p.first, p.second, estimate(p.first, p.second), similarity, shared});
+    }
+    sort(res.begin(), res.end(), [](const AirlineOverlap &a, const AirlineOverlap &b) {
+        if (a.jaccard != b.jaccard)
+            return a.jaccard > b.jaccard;
+        return a.sharedRoutes > b.sharedRoutes;
+    });
+    return res;
+}
@@ -0,0 +1,39 @@
+
+#ifndef PROJETO2_ROUTESIMILARITY_H
+#define PROJETO2_ROUTESIMILARITY_H
+
+
+#include <cstdint>
+#include <vector>
+#include "Graph.h"
+
+struct AirlineOverlap {
+    int first;              ///< id of the first airline
+    int second;             ///< id of the second airline
+    double estimate;        ///< Jaccard similarity estimated from the MinHash signatures
+    double jaccard;         ///< exact Jaccard similarity of the route sets
+    int sharedRoutes;       ///< number of routes flown by both airlines
+};
+
+class RouteSimilarity {
+public:
+    explicit RouteSimilarity(const Graph &graph, int numHashes = 128);
+
+    int getNumHashes() const;
+    int getNumberOfRoutes(int airline) const;
+    double estimate(int a, int b) const;
+    double jaccard(int a, int b, int &shared) const;
+    int chooseRows(double threshold) const;
+    std::vector<AirlineOverlap> findOverlaps(double threshold, int &candidates) const;
+
+private:
+    int numHashes;                                  ///< length of each signature
+    std::vector<std::uint64_t> hashSeeds;           ///< seed of each hash function
+    std::vector<std::uint64_t> signatures;          ///< numHashes minimums per airline, airline after airline
+    std::vector<std::vector<std::uint64_t>> routes; ///< sorted (source, target) keys of each airline
+
+    static std::uint64_t mix(std::uint64_t x);
+};
+
+
+#endif //PROJETO2_ROUTESIMILARITY_H
@@ -0,0 +1,359 @@
+
+#include "ScheduleLog.h"
+#include "DurableFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Constructor for the ScheduleLog class. No log is open until the first append.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+ScheduleLog::ScheduleLog() {}
+
+/**
+ * @brief Copy constructor. The copy does not share the open log; it opens and checks it again on its first append.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+ScheduleLog::ScheduleLog(const ScheduleLog &) {}
+
+/**
+ * @brief Copy assignment. Closes the open log, like the copy constructor the object opens it again when needed.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+ScheduleLog &ScheduleLog::operator=(const ScheduleLog &other) {
+    if (this != &other)
+        closeLog();
+    return *this;
+}
+
+/**
+ * @brief Destructor. Closes the open log.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+ScheduleLog::~ScheduleLog() {
+    closeLog();
+}
+
+/**
+ * @brief Computes the checksum of a record.
+ *
+ * @param data The bytes of the record.
+ * @param size The number of bytes.
+ *
+ * @return The 32-bit FNV-1a hash of the bytes.
+ *
+ * @complexity Time Complexity: O(size)
+ */
+uint32_t ScheduleLog::checksum(const char *data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char) data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Appends the encoding of a change to a buffer.
+ *
+ * @param sequence The sequence number of the change.
+ * @param change The change.
+ * @param out The buffer.
+ *
+ * @info A record is its payload size and checksum followed by the payload: the sequence number, the operation and the
+ * three codes, each one prefixed by its length.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void ScheduleLog::encode(uint64_t sequence, const ScheduleChange &change, string &out) {
+    string payload(reinterpret_cast<const char *>(&sequence), sizeof(sequence));
+    payload += (char) change.operation;
+    for (const string *code : {&change.source, &change.target, &change.airline}) {
+        size_t length = min<size_t>(code->size(), 255);
+        payload += (char) length;
+        payload.append(*code, 0, length);
+    }
+    uint32_t words[2] = {(uint32_t) payload.size(), checksum(payload.data(), payload.size())};
+    out.append(reinterpret_cast<const char *>(words), sizeof(words));
+    out += payload;
+}
+
+/**
+ * @brief Reads and checks the header of a log.
+ *
+ * @param log The contents of the log file.
+ * @param fingerprint The fingerprint of the current dataset.
+ * @param header Where the header is copied to.
+ *
+ * @return True if the log is complete enough to have a header and belongs to the current dataset.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool ScheduleLog::readHeader(const vector<char> &log, uint64_t fingerprint, Header &header) {
+    if (log.size() < sizeof(Header))
+        return false;
+    memcpy(&header, log.data(), sizeof(Header));
+    return memcmp(header.magic, "FMSWAL1", 8) == 0 && header.fingerprint == fingerprint;
+}
+
+/**
+ * @brief Walks the records of a log, stopping at the first incomplete or damaged one.
+ *
+ * @param log The contents of the log file, header included.
+ * @param base The sequence number the log continues from.
+ * @param last Set to the sequence number of the last valid record, or base if there is none.
+ * @param visit Called for every valid record, in order.
+ *
+ * @return The offset right after the last valid record. Anything after it is the tail of an interrupted write.
+ *
+ * @complexity Time Complexity: O(S), where S is the size of the log.
+ */
+size_t ScheduleLog::scan(const vector<char> &log, uint64_t base, uint64_t &last,
+                         const function<void(uint64_t sequence, const ScheduleChange &change)> &visit) {
+    size_t offset = sizeof(Header);
+    last = base;
+    while (offset + 8 <= log.size()) {
+        uint32_t words[2];
+        memcpy(words, log.data() + offset, sizeof(words));
+        const char *payload = log.data() + offset + 8;
+        size_t size = words[0];
+        if (size < 12 || offset + 8 + size > log.size() || checksum(payload, size) != words[1])
+            break;
+
+        uint64_t sequence;
+        memcpy(&sequence, payload, sizeof(sequence));
+        ScheduleChange change;
+        change.operation = (ScheduleOperation) payload[8];
+        size_t position = 9;
+        bool complete = sequence == last + 1 &&
+                        (unsigned char) payload[8] <= (unsigned char) ScheduleOperation::RemoveFlight;
+        for (string *code : {&change.source, &change.target, &change.airline}) {
+            if (position >= size || position + 1 + (unsigned char) payload[position] > size) {
+                complete = false;
+                break;
+            }
+            code->assign(payload + position + 1, (unsigned char) payload[position]);
+            position += 1 + (unsigned char) payload[position];
+        }
+        if (!complete || position != size)
+            break;
+
+        visit(sequence, change);
+        last = sequence;
+        offset += 8 + size;
+    }
+    return offset;
+}
+
+/**
+ * @brief Replays the changes logged after a snapshot.
+ *
+ * @param filename The path of the log.
+ * @param fingerprint The fingerprint of the current dataset. Logs of other datasets are ignored.
+ * @param sequence The sequence number of the loaded snapshot. Set to the sequence number of the last change replayed.
+ * @param apply Called for every change newer than the snapshot, in order.
+ *
+ * @return False if the log continues a newer snapshot than the one loaded, so some changes are missing and none is
+ * replayed. True otherwise, including when there is no log.
+ *
+ * @info Only the records after the last compaction are in the log, so recovery reads at most a bounded tail no matter
+ * how many changes were applied since the dataset files were produced. A damaged tail, left by a crash in the middle
+ * of a write, ends the replay.
+ *
+ * @complexity Time Complexity: O(S + C * T), where S is the size of the log, C the number of changes replayed and T
+ * the cost of applying one.
+ */
+bool ScheduleLog::replay(const string &filename, uint64_t fingerprint, uint64_t &sequence,
+                         const function<void(const ScheduleChange &change)> &apply) {
+    ifstream in(filename, ios::binary);
+    if (!in)
+        return true;
+    vector<char> log((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    Header header;
+    if (!readHeader(log, fingerprint, header))
+        return true;
+    if (header.base > sequence)
+        return false;
+
+    uint64_t snapshot = sequence, last;
+    scan(log, header.base, last, [&](uint64_t number, const ScheduleChange &change) {
+        if (number > snapshot)
+            apply(change);
+    });
+    sequence = max(sequence, last);
+    return true;
+}
+
+/**
+ * @brief Opens the log for appending, after checking it.
+ *
+ * @param filename The path of the log.
+ * @param fingerprint The fingerprint of the current dataset.
+ * @param firstSequence The sequence number of the next change to append.
+ *
+ * @return True if the log is open.
+ *
+ * @info A damaged tail is cut off. If the log is missing, belongs to another dataset or does not end right before
+ * firstSequence, a new log is started in its place.
+ *
+ * @complexity Time Complexity: O(S), where S is the size of the log.
+ */
+bool ScheduleLog::openLog(const string &filename, uint64_t fingerprint, uint64_t firstSequence) {
+    closeLog();
+#ifndef _WIN32
+    vector<char> log;
+    {
+        ifstream in(filename, ios::binary);
+        if (in)
+            log.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    Header header;
+    uint64_t last = 0;
+    size_t valid = 0;
+    if (readHeader(log, fingerprint, header))
+        valid = scan(log, header.base, last, [](uint64_t, const ScheduleChange &) {});
+    if (valid == 0 || last + 1 != firstSequence) {
+        if (!reset(filename, fingerprint, firstSequence - 1))
+            return false;
+        valid = sizeof(Header);
+    }
+
+    int file = open(filename.c_str(), O_WRONLY);
+    if (file < 0)
+        return false;
+    if (ftruncate(file, (off_t) valid) != 0) {
+        close(file);
+        return false;
+    }
+    fd = file;
+    end = valid;
+    openFilename = filename;
+    openFingerprint = fingerprint;
+    nextSequence = firstSequence;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Closes the open log, if any. The next append checks it again.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+void ScheduleLog::closeLog() {
+#ifndef _WIN32
+    if (fd >= 0)
+        close(fd);
+#endif
+    fd = -1;
+}
+
+/**
+ * @brief Durably appends changes to the log.
+ *
+ * @param filename The path of the log.
+ * @param fingerprint The fingerprint of the current dataset.
+ * @param firstSequence The sequence number of the first change. The others follow it.
+ * @param changes The changes, in the order they were applied.
+ *
+ * @return True if the changes reached the disk.
+ *
+ * @info The log is read and checked only when it is opened, which happens on the first append and again after a
+ * reset, a failed write, or an append to another log or out of sequence. Later appends write at the offset already
+ * known to be the end of the valid records, so a batch costs its own size and a single fsync, not the size of the log.
+ *
+ * @complexity Time Complexity: O(C) amortized, where C is the number of changes, plus O(S) when the log is opened,
+ * where S is its size.
+ */
+bool ScheduleLog::append(const string &filename, uint64_t fingerprint, uint64_t firstSequence,
+                         const vector<ScheduleChange> &changes) {
+    string records;
+    uint64_t sequence = firstSequence;
+    for (const auto &change : changes)
+        encode(sequence++, change, records);
+
+#ifndef _WIN32
+    if (fd < 0 || filename != openFilename || fingerprint != openFingerprint || firstSequence != nextSequence) {
+        if (!openLog(filename, fingerprint, firstSequence))
+            return false;
+    }
+    bool written = true;
+    for (size_t done = 0; written && done < records.size();) {
+        ssize_t count = pwrite(fd, records.data() + done, records.size() - done, (off_t) (end + done));
+        written = count > 0;
+        done += written ? (size_t) count : 0;
+    }
+    if (!written || fsync(fd) != 0) {
+        closeLog();
+        return false;
+    }
+    end += records.size();
+    nextSequence = sequence;
+    return true;
+#else
+    vector<char> log;
+    {
+        ifstream in(filename, ios::binary);
+        if (in)
+            log.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    Header header;
+    uint64_t last = 0;
+    size_t valid = 0;
+    if (readHeader(log, fingerprint, header))
+        valid = scan(log, header.base, last, [](uint64_t, const ScheduleChange &) {});
+    if (valid == 0 || last + 1 != firstSequence) {
+        if (!reset(filename, fingerprint, firstSequence - 1))
+            return false;
+        valid = sizeof(Header);
+    }
+    if (valid != log.size()) {
+        log.resize(valid);
+        ofstream out(filename, ios::binary | ios::trunc);
+        out.write(log.data(), (streamsize) log.size());
+    }
+    ofstream out(filename, ios::binary | ios::app);
+    out.write(records.data(), (streamsize) records.size());
+    return (bool) out;
+#endif
+}
+
+/**
+ * @brief Starts an empty log, after the changes were folded into a snapshot.
+ *
+ * @param filename The path of the log.
+ * @param fingerprint The fingerprint of the current dataset.
+ * @param sequence The sequence number of the snapshot the new log continues.
+ *
+ * @return True if the new log is in place.
+ *
+ * @info Closes the open log first, since it is about to be replaced. The new log is written to a temporary file that is
+ * then renamed over the old one, and both are fsynced. A crash
+ * before the rename leaves the old log, whose records up to the snapshot are simply skipped on recovery. Callers
+ * folding the log into a snapshot must have saved the snapshot durably first.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool ScheduleLog::reset(const string &filename, uint64_t fingerprint, uint64_t sequence) {
+    closeLog();
+    Header header = {};
+    memcpy(header.magic, "FMSWAL1", 8);
+    header.fingerprint = fingerprint;
+    header.base = sequence;
+    return replaceFile(filename, reinterpret_cast<const char *>(&header), sizeof(header));
+}
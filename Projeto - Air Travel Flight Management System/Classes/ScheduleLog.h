@@ -0,0 +1,60 @@
+
+#ifndef PROJETO2_SCHEDULELOG_H
+#define PROJETO2_SCHEDULELOG_H
+
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+enum class ScheduleOperation {
+    AddFlight,      ///< a new flight between two airports
+    RemoveFlight    ///< a cancelled flight between two airports
+};
+
+struct ScheduleChange {
+    ScheduleOperation operation;    ///< what changed
+    std::string source;             ///< code of the source airport
+    std::string target;             ///< code of the target airport
+    std::string airline;            ///< code of the airline
+};
+
+class ScheduleLog {
+public:
+    ScheduleLog();
+    ScheduleLog(const ScheduleLog &other);
+    ScheduleLog &operator=(const ScheduleLog &other);
+    ~ScheduleLog();
+
+    static bool replay(const std::string &filename, std::uint64_t fingerprint, std::uint64_t &sequence,
+                       const std::function<void(const ScheduleChange &change)> &apply);
+    bool append(const std::string &filename, std::uint64_t fingerprint, std::uint64_t firstSequence,
+                const std::vector<ScheduleChange> &changes);
+    bool reset(const std::string &filename, std::uint64_t fingerprint, std::uint64_t sequence);
+
+private:
+    struct Header {
+        char magic[8];                  ///< "FMSWAL1" and a zero byte
+        std::uint64_t fingerprint;      ///< identifies the dataset the changes apply to
+        std::uint64_t base;             ///< sequence number of the snapshot the log continues
+    };
+
+    int fd = -1;                            ///< the log, open for appending, or -1 if it must be checked first
+    std::string openFilename;               ///< path of the open log
+    std::uint64_t openFingerprint = 0;      ///< fingerprint the open log was checked against
+    std::uint64_t nextSequence = 0;         ///< sequence number the next record of the open log must have
+    std::size_t end = 0;                    ///< offset right after the last valid record of the open log
+
+    bool openLog(const std::string &filename, std::uint64_t fingerprint, std::uint64_t firstSequence);
+    void closeLog();
+
+    static bool readHeader(const std::vector<char> &log, std::uint64_t fingerprint, Header &header);
+    static std::size_t scan(const std::vector<char> &log, std::uint64_t base, std::uint64_t &last,
+                            const std::function<void(std::uint64_t sequence, const ScheduleChange &change)> &visit);
+    static void encode(std::uint64_t sequence, const ScheduleChange &change, std::string &out);
+    static std::uint32_t checksum(const char *data, std::size_t size);
+};
+
+
+#endif //PROJETO2_SCHEDULELOG_H
@@ -0,0 +1,208 @@
+
+#include "ScheduleStream.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the ScheduleStream class.
+ *
+ * @param data The dataset the updates are applied to. It must outlive the object.
+ * @param capacity The maximum number of lines waiting to be applied. The input is not read while the queue is full.
+ * @param interval The maximum time between two batches.
+ * @param maxBatch The maximum number of lines per batch. A full batch is applied without waiting for the interval.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+ScheduleStream::ScheduleStream(Data &data, size_t capacity, chrono::milliseconds interval, size_t maxBatch)
+        : data(data), capacity(max<size_t>(capacity, 1)), interval(interval), maxBatch(max<size_t>(maxBatch, 1)),
+          blocked(0) {}
+
+/**
+ * @brief Reads the input, one update per line, into the queue.
+ *
+ * @param in The stream the updates are read from.
+ *
+ * @info When the queue is full the reader waits, so it stops draining the pipe and the producer on the other side is
+ * slowed down to the rate the updates are applied at. Lines with an odd number of double quotes are dropped here and
+ * counted as malformed: a batch is tokenized as a single CSV document, so an unclosed quote would otherwise swallow
+ * every later line of its batch into one field.
+ *
+ * @complexity Time Complexity: O(L), where L is the length of the input.
+ */
+void ScheduleStream::read(istream &in) {
+    string line;
+    while (getline(in, line)) {
+        bool balanced = count(line.begin(), line.end(), '"') % 2 == 0;
+        unique_lock<mutex> guard(lock);
+        if (!balanced) {
+            malformed++;
+            continue;
+        }
+        if (queue.size() >= capacity) {
+            auto start = chrono::steady_clock::now();
+            notFull.wait(guard, [this]() { return queue.size() < capacity; });
+            blocked += chrono::steady_clock::now() - start;
+        }
+        queue.push_back(move(line));
+        if (queue.size() >= maxBatch)
+            notEmpty.notify_one();
+    }
+    lock_guard<mutex> guard(lock);
+    finished = true;
+    notEmpty.notify_one();
+}
+
+/**
+ * @brief Takes the next batch of lines from the queue.
+ *
+ * @param text Set to the lines of the batch, one per line.
+ * @param deadline When the batch is cut, if it did not fill up before.
+ * @param done Set to true once the input ended and every line was taken.
+ *
+ * @return The number of lines in the batch, possibly 0 if nothing arrived before the deadline.
+ *
+ * @complexity Time Complexity: O(B), where B is the size of the batch.
+ */
+size_t ScheduleStream::takeBatch(string &text, chrono::steady_clock::time_point deadline, bool &done) {
+    unique_lock<mutex> guard(lock);
+    notEmpty.wait_until(guard, deadline, [this]() { return queue.size() >= maxBatch || finished; });
+    size_t count = min(queue.size(), maxBatch);
+    text.clear();
+    for (size_t i = 0; i < count; i++) {
+        text += queue.front();
+        text += '\n';
+        queue.pop_front();
+    }
+    done = finished && queue.empty();
+    guard.unlock();
+    notFull.notify_one();
+    return count;
+}
+
+/**
+ * @brief Applies one update and brings the derived statistics up to date.
+ *
+ * @param batch The parsed batch.
+ * @param row The row of the update: "add" or "remove", then the source, target and airline codes.
+ *
+ * @return True if the update was applied, false if it is malformed or refers to an unknown airport or flight.
+ *
+ * @complexity Time Complexity: O(log V) average for an added flight, O(d + log V) for a cancelled one, where V is the number of
+ * airports and d the number of flights out of the source airport.
+ */
+bool ScheduleStream::apply(const CsvReader &batch, int row) {
+    if (batch.getNumFields(row) < 4)
+        return false;
+    string operation = batch.getField(row, 0);
+    string source = batch.getField(row, 1), target = batch.getField(row, 2), airline = batch.getField(row, 3);
+    int delta;
+    if (operation == "add" && data.addFlight(source, target, airline))
+        delta = 1;
+    else if (operation == "remove" && data.removeFlight(source, target, airline))
+        delta = -1;
+    else
+        return false;
+
+    const Graph &flights = data.getFlightsGraph();
+    int sourceId = flights.findVertex(source)->getId(), targetId = flights.findVertex(target)->getId();
+    float distance = data.getAirport(source)->getPosition().haversineDistance(data.getAirport(target)->getPosition());
+    int airlineId = flights.getAirlineId(airline);
+    if (delta > 0) {
+        ranking.addFlight(sourceId, targetId, airlineId, distance);
+        aggregates.addFlight(sourceId, targetId, airlineId, airline);
+    } else {
+        ranking.removeFlight(sourceId, targetId, airlineId, distance);
+        aggregates.removeFlight(sourceId, targetId, airlineId);
+    }
+    return true;
+}
+
+/**
+ * @brief Ingests a stream of flight updates until it ends.
+ *
+ * @param in The stream, such as the standard input or a named pipe. Every line is "add,SOURCE,TARGET,AIRLINE" or
+ * "remove,SOURCE,TARGET,AIRLINE".
+ * @param out The stream where a line is written per batch, followed by the final statistics.
+ * @param k The number of airports and airlines in the final statistics.
+ *
+ * @info A reader thread fills a bounded queue while this thread cuts it into micro-batches, every interval or as soon
+ * as maxBatch lines are waiting. A batch is parsed at once by the CSV tokenizer, applied to the graph and committed to
+ * the schedule log with a single fsync. The traffic rankings and the flight aggregates are updated with each change
+ * instead of being recomputed.
+ *
+ * @complexity Time Complexity: O(V log V + E + U log V), where V is the number of airports, E the number of flights and
+ * U the number of updates.
+ */
+void ScheduleStream::run(istream &in, ostream &out, int k) {
+    const Graph &flights = data.getFlightsGraph();
+    ranking.build(flights);
+    aggregates.build(flights, data.getAirports());
+
+    thread reader(&ScheduleStream::read, this, ref(in));
+    string text;
+    CsvReader batch;
+    bool done = false;
+    int batches = 0;
+    long long applied = 0, rejected = 0;
+    while (!done) {
+        size_t lines = takeBatch(text, chrono::steady_clock::now() + interval, done);
+        if (lines == 0)
+            continue;
+
+        auto start = chrono::steady_clock::now();
+        batch.parse(move(text));
+        int accepted = 0;
+        for (int row = 0; row < batch.getNumRows(); row++)
+            accepted += apply(batch, row);
+        bool committed = data.commitSchedule();
+        auto end = chrono::steady_clock::now();
+
+        size_t waiting;
+        {
+            lock_guard<mutex> guard(lock);
+            waiting = queue.size();
+        }
+        batches++;
+        applied += accepted;
+        rejected += (long long) lines - accepted;
+        out << "Batch " << batches << ": " << lines << " updates, " << accepted << " applied, "
+            << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us, " << waiting << "/" << capacity
+            << " queued" << (committed ? "" : " (could not write schedule.log)") << endl;
+    }
+    reader.join();
+
+    rejected += malformed;
+    out << "Updates applied: " << applied << ", rejected: " << rejected << " (" << malformed
+        << " with unbalanced quotes), in " << batches << " batches" << endl;
+    out << "Reader waited on a full queue for "
+        << chrono::duration_cast<chrono::milliseconds>(blocked).count() << " ms" << endl;
+    report(out, k);
+}
+
+/**
+ * @brief Prints the busiest airports and airlines.
+ *
+ * @param out The stream the statistics are written to.
+ * @param k The number of airports and airlines.
+ *
+ * @complexity Time Complexity: O(k + A log A), where A is the number of airlines.
+ */
+void ScheduleStream::report(ostream &out, int k) const {
+    const Graph &flights = data.getFlightsGraph();
+    out << "Airports with most traffic:" << endl;
+    int position = 1;
+    for (const auto &airport : ranking.top(TrafficMetric::Flights, k))
+        out << position++ << " -> " << flights.getVertexSet()[airport.first]->getInfo() << " (" << airport.second
+            << " flights)" << endl;
+
+    vector<int> airlines = aggregates.getAirlinesByCode();
+    stable_sort(airlines.begin(), airlines.end(), [this](int a, int b) {
+        return aggregates.getAirlineFlights(a) > aggregates.getAirlineFlights(b);
+    });
+    out << "Airlines with most flights:" << endl;
+    for (int i = 0; i < min<int>(k, (int) airlines.size()); i++)
+        out << i + 1 << " -> " << flights.getAirlineCode(airlines[i]) << " ("
+            << aggregates.getAirlineFlights(airlines[i]) << " flights)" << endl;
+}
@@ -0,0 +1,50 @@
+
+#ifndef PROJETO2_SCHEDULESTREAM_H
+#define PROJETO2_SCHEDULESTREAM_H
+
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CsvReader.h"
+#include "Data.h"
+#include "TrafficRanking.h"
+#include "FlightAggregates.h"
+
+class ScheduleStream {
+public:
+    ScheduleStream(Data &data, std::size_t capacity, std::chrono::milliseconds interval, std::size_t maxBatch);
+
+    void run(std::istream &in, std::ostream &out, int k);
+
+private:
+    Data &data;                                   ///< the dataset the updates are applied to
+    std::size_t capacity;                         ///< maximum number of lines waiting to be applied
+    std::chrono::milliseconds interval;           ///< maximum time between two batches
+    std::size_t maxBatch;                         ///< maximum number of lines per batch
+
+    std::deque<std::string> queue;                ///< lines read but not applied yet
+    std::mutex lock;                              ///< guards the queue, finished and blocked
+    std::condition_variable notEmpty;             ///< signalled when a batch is ready or the input ended
+    std::condition_variable notFull;              ///< signalled when lines leave the queue
+    bool finished = false;                        ///< true once the input ended
+    long long malformed = 0;                      ///< lines dropped by the reader for unbalanced quotes
+    std::chrono::steady_clock::duration blocked;  ///< time the reader waited for room in the queue
+
+    TrafficRanking ranking;                       ///< airports by every traffic metric, kept up to date
+    FlightAggregates aggregates;                  ///< flights by city, country and airline, kept up to date
+
+    void read(std::istream &in);
+    std::size_t takeBatch(std::string &text, std::chrono::steady_clock::time_point deadline, bool &done);
+    bool apply(const CsvReader &batch, int row);
+    void report(std::ostream &out, int k) const;
+};
+
+
+#endif //PROJETO2_SCHEDULESTREAM_H
@@ -0,0 +1,184 @@
+
+#include "SystemLoader.h"
+#include <sstream>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the SystemLoader class. Starts reading the dataset and building the system in the background,
+ * and then watching the dataset files for changes.
+ *
+ * @param pollInterval The time between two checks of the dataset files.
+ *
+ * @info The builder is a detached thread that owns the promises of its results and never touches the loader, so unlike
+ * std::async futures, whose destructors block until the task ends, the loader can be destroyed while it still runs.
+ *
+ * @complexity Time Complexity: O(1). The loading itself takes O(N + M + F) in the background, where N, M and F are the
+ * number of airlines, airports and flights.
+ */
+SystemLoader::SystemLoader(chrono::milliseconds pollInterval) : pollInterval(pollInterval) {
+    auto dataPromise = make_shared<promise<shared_ptr<Data>>>();
+    auto systemPromise = make_shared<promise<shared_ptr<FlightManagementSystem>>>();
+    data = dataPromise->get_future().share();
+    system = systemPromise->get_future().share();
+    thread([dataPromise, systemPromise]() {
+        auto loaded = make_shared<Data>();
+        dataPromise->set_value(loaded);
+        systemPromise->set_value(make_shared<FlightManagementSystem>(*loaded));
+    }).detach();
+    watcher = thread(&SystemLoader::watch, this);
+}
+
+/**
+ * @brief Destructor. Stops the watcher, waiting only for a reload in progress to finish.
+ *
+ * @info The initial load is not waited for: the builder finishes, or is ended with the process, on its own. The last
+ * references to the dataset and the system are released on a detached thread too, as freeing the system joins its
+ * index builder.
+ *
+ * @complexity Time Complexity: O(1), or the rest of a reload in progress.
+ */
+SystemLoader::~SystemLoader() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    watcher.join();
+    thread([](shared_future<shared_ptr<Data>>, shared_future<shared_ptr<FlightManagementSystem>>,
+              shared_ptr<Data>, shared_ptr<FlightManagementSystem>) {},
+           move(data), move(system), move(currentData), move(currentSystem)).detach();
+}
+
+/**
+ * @brief Watches the fingerprint of the dataset files and swaps in a new dataset and system whenever it changes.
+ *
+ * @info The watcher first waits for the initial load, checking every poll interval whether it should stop instead.
+ * The files are polled, which works on every platform and also catches files replaced by a rename. A change is
+ * only acted on once the fingerprint stays the same across two polls, so a file still being written is not read half
+ * way. The replacement is fully built on this thread (from graph.snapshot when it is already up to date) while queries
+ * keep running on the old version; the swap itself only exchanges two pointers under the lock. Queries that started
+ * before the swap hold their own references and finish on the old version, which is freed, graph included, when the
+ * last one ends.
+ *
+ * @complexity Time Complexity: O(1) per check, plus O(N + M + F) per reload.
+ */
+void SystemLoader::watch() {
+    unique_lock<mutex> guard(lock);
+    while (data.wait_for(chrono::seconds(0)) != future_status::ready) {
+        if (wakeUp.wait_for(guard, pollInterval, [this]() { return stopping; }))
+            return;
+    }
+    unsigned long long fingerprint = data.get()->getFingerprint(), candidate = fingerprint;
+    while (!wakeUp.wait_for(guard, pollInterval, [this]() { return stopping; })) {
+        guard.unlock();
+        unsigned long long current = Data::computeFingerprint();
+        guard.lock();
+        if (current == fingerprint || current != candidate || stopping) {
+            candidate = current;
+            continue;
+        }
+
+        reloading = true;
+        guard.unlock();
+        auto start = chrono::steady_clock::now();
+        auto newData = make_shared<Data>();
+        auto newSystem = make_shared<FlightManagementSystem>(*newData);
+        auto built = chrono::steady_clock::now();
+        guard.lock();
+        currentData.swap(newData);
+        currentSystem.swap(newSystem);
+        auto swapped = chrono::steady_clock::now();
+        reloading = false;
+        fingerprint = candidate = currentData->getFingerprint();
+
+        ostringstream report;
+        report << "Dataset reloaded in " << chrono::duration_cast<chrono::milliseconds>(built - start).count()
+               << " ms (swap pause: " << chrono::duration_cast<chrono::microseconds>(swapped - built).count() << " us)";
+        reloadReport = report.str();
+
+        // the old version may be the last reference: free it without holding the lock
+        guard.unlock();
+        newSystem.reset();
+        newData.reset();
+        guard.lock();
+    }
+}
+
+/**
+ * @brief Checks if the dataset and the system are loaded.
+ *
+ * @return True if getData and getSystem return without waiting.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+bool SystemLoader::isReady() const {
+    return system.wait_for(chrono::seconds(0)) == future_status::ready;
+}
+
+/**
+ * @brief Describes what is still loading.
+ *
+ * @return A progress message, or an empty string once the system and all its indexes are ready.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+string SystemLoader::getStatus() const {
+    if (data.wait_for(chrono::seconds(0)) != future_status::ready)
+        return "Loading airports, airlines and flights...";
+    if (!isReady())
+        return "Building the flights graph...";
+    {
+        lock_guard<mutex> guard(lock);
+        if (reloading)
+            return "The dataset changed, reloading in the background...";
+    }
+    return getSystem()->getLoadingStatus();
+}
+
+/**
+ * @brief Gets the result of the last reload, once.
+ *
+ * @return How long the last reload took and how long queries were paused by the swap, or an empty string if nothing
+ * was reloaded since the last call.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+string SystemLoader::takeReloadReport() {
+    lock_guard<mutex> guard(lock);
+    string report;
+    report.swap(reloadReport);
+    return report;
+}
+
+/**
+ * @brief Gets the current dataset, waiting for it to be read if needed.
+ *
+ * @return The dataset. It stays valid while the reference is held, even if a newer one is swapped in.
+ *
+ * @complexity Time Complexity: O(1) once loaded.
+ */
+shared_ptr<Data> SystemLoader::getData() const {
+    {
+        lock_guard<mutex> guard(lock);
+        if (currentData)
+            return currentData;
+    }
+    return data.get();
+}
+
+/**
+ * @brief Gets the current system, waiting for it to be built if needed. Its indexes may still be building.
+ *
+ * @return The system. It stays valid while the reference is held, even if a newer one is swapped in.
+ *
+ * @complexity Time Complexity: O(1) once loaded.
+ */
+shared_ptr<FlightManagementSystem> SystemLoader::getSystem() const {
+    {
+        lock_guard<mutex> guard(lock);
+        if (currentSystem)
+            return currentSystem;
+    }
+    return system.get();
+}
@@ -0,0 +1,48 @@
+
+#ifndef PROJETO2_SYSTEMLOADER_H
+#define PROJETO2_SYSTEMLOADER_H
+
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Data.h"
+#include "FlightManagementSystem.h"
+
+class SystemLoader {
+public:
+    SystemLoader(std::chrono::milliseconds pollInterval = std::chrono::seconds(2));
+    SystemLoader(const SystemLoader &) = delete;
+    SystemLoader &operator=(const SystemLoader &) = delete;
+    ~SystemLoader();
+
+    bool isReady() const;
+    std::string getStatus() const;
+    std::string takeReloadReport();
+    std::shared_ptr<Data> getData() const;
+    std::shared_ptr<FlightManagementSystem> getSystem() const;
+
+private:
+    std::shared_future<std::shared_ptr<Data>> data;                         ///< the dataset, read in the background
+    std::shared_future<std::shared_ptr<FlightManagementSystem>> system;     ///< the system, built from the dataset
+
+    mutable std::mutex lock;                                ///< guards every member below
+    std::shared_ptr<Data> currentData;                      ///< the dataset in use, once it was reloaded
+    std::shared_ptr<FlightManagementSystem> currentSystem;  ///< the system in use, once it was reloaded
+    bool reloading = false;                                 ///< true while a replacement is being built
+    std::string reloadReport;                               ///< result of the last reload, until it is shown
+    bool stopping = false;                                  ///< asks the watcher to stop
+    std::condition_variable wakeUp;                         ///< wakes the watcher up when stopping
+
+    std::chrono::milliseconds pollInterval;                 ///< time between two checks of the dataset files
+    std::thread watcher;                                    ///< reloads the dataset when its files change
+
+    void watch();
+};
+
+
+#endif //PROJETO2_SYSTEMLOADER_H
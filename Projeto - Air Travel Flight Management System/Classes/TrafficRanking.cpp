@@ -0,0 +1,180 @@
+
+#include "TrafficRanking.h"
+
+using namespace std;
+
+/**
+ * @brief Moves an airport in a ranking after its score changed.
+ *
+ * @param airport The vertex id of the airport.
+ * @param delta The change in its score.
+ *
+ * @info The score array indexes the tree: the old entry of the airport is found from its current score, removed and
+ * inserted again with the new one.
+ *
+ * @complexity Time Complexity: O(log V), where V is the number of vertices.
+ */
+void TrafficRanking::Ranking::update(int airport, double delta) {
+    if (delta == 0)
+        return;
+    order.erase({-score[airport], airport});
+    score[airport] += delta;
+    order.insert({-score[airport], airport});
+}
+
+/**
+ * @brief Gets the ranking of a metric.
+ *
+ * @param metric The metric.
+ *
+ * @return The ranking.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+TrafficRanking::Ranking &TrafficRanking::get(TrafficMetric metric) {
+    return rankings[(int) metric];
+}
+
+/**
+ * @brief Packs two ids into a single key.
+ *
+ * @param first The first id.
+ * @param second The second id.
+ *
+ * @return The key of the pair.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+uint64_t TrafficRanking::key(int first, int second) {
+    return (uint64_t) (uint32_t) first << 32 | (uint32_t) second;
+}
+
+/**
+ * @brief Ranks every airport of a graph by every metric.
+ *
+ * @param graph The flights graph.
+ *
+ * @complexity Time Complexity: O(V log V + E), where V is the number of vertices and E the number of edges.
+ */
+void TrafficRanking::build(const Graph &graph) {
+    routeFlights.clear();
+    airlineFlights.clear();
+    for (auto &ranking : rankings) {
+        ranking.score.assign(graph.getNumVertex(), 0);
+        ranking.order.clear();
+    }
+    for (auto vertex : graph.getVertexSet()) {
+        for (const auto &edge : vertex->getAdj()) {
+            int source = vertex->getId(), target = edge.getDest()->getId();
+            get(TrafficMetric::Flights).score[source]++;
+            get(TrafficMetric::Flights).score[target]++;
+            get(TrafficMetric::Distance).score[source] += edge.getDistance();
+            get(TrafficMetric::Distance).score[target] += edge.getDistance();
+            if (routeFlights[key(source, target)]++ == 0)
+                get(TrafficMetric::Destinations).score[source]++;
+            if (airlineFlights[key(source, edge.getAirlineId())]++ == 0)
+                get(TrafficMetric::Airlines).score[source]++;
+        }
+    }
+    for (auto &ranking : rankings) {
+        for (int airport = 0; airport < (int) ranking.score.size(); airport++)
+            ranking.order.insert({-ranking.score[airport], airport});
+    }
+}
+
+/**
+ * @brief Updates every ranking after a flight was added.
+ *
+ * @param source The vertex id of the source airport.
+ * @param target The vertex id of the target airport.
+ * @param airline The id of the airline.
+ * @param distance The length of the flight, in km.
+ *
+ * @complexity Time Complexity: O(log V) average, where V is the number of vertices.
+ */
+void TrafficRanking::addFlight(int source, int target, int airline, double distance) {
+    get(TrafficMetric::Flights).update(source, 1);
+    get(TrafficMetric::Flights).update(target, 1);
+    get(TrafficMetric::Distance).update(source, distance);
+    get(TrafficMetric::Distance).update(target, distance);
+    if (routeFlights[key(source, target)]++ == 0)
+        get(TrafficMetric::Destinations).update(source, 1);
+    if (airlineFlights[key(source, airline)]++ == 0)
+        get(TrafficMetric::Airlines).update(source, 1);
+}
+
+/**
+ * @brief Updates every ranking after a flight was removed.
+ *
+ * @param source The vertex id of the source airport.
+ * @param target The vertex id of the target airport.
+ * @param airline The id of the airline.
+ * @param distance The length of the flight, in km.
+ *
+ * @complexity Time Complexity: O(log V) average, where V is the number of vertices.
+ */
+void TrafficRanking::removeFlight(int source, int target, int airline, double distance) {
+    get(TrafficMetric::Flights).update(source, -1);
+    get(TrafficMetric::Flights).update(target, -1);
+    get(TrafficMetric::Distance).update(source, -distance);
+    get(TrafficMetric::Distance).update(target, -distance);
+    if (--routeFlights[key(source, target)] == 0) {
+        routeFlights.erase(key(source, target));
+        get(TrafficMetric::Destinations).update(source, -1);
+    }
+    if (--airlineFlights[key(source, airline)] == 0) {
+        airlineFlights.erase(key(source, airline));
+        get(TrafficMetric::Airlines).update(source, -1);
+    }
+}
+
+/**
+ * @brief Gets the score of an airport.
+ *
+ * @param metric The metric.
+ * @param airport The vertex id of the airport.
+ *
+ * @return The score of the airport.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+double TrafficRanking::getScore(TrafficMetric metric, int airport) const {
+    return rankings[(int) metric].score[airport];
+}
+
+/**
+ * @brief Gets the airports with the highest scores.
+ *
+ * @param metric The metric.
+ * @param k The number of airports.
+ *
+ * @return Up to k pairs (vertex id, score), highest first; ties by vertex id.
+ *
+ * @complexity Time Complexity: O(k)
+ */
+vector<pair<int, double>> TrafficRanking::top(TrafficMetric metric, int k) const {
+    vector<pair<int, double>> res;
+    const auto &order = rankings[(int) metric].order;
+    for (auto it = order.begin(); it != order.end() && (int) res.size() < k; it++)
+        res.push_back({it->second, -it->first});
+    return res;
+}
+
+/**
+ * @brief Gets the unit of a metric, as printed after a score.
+ *
+ * @param metric The metric.
+ *
+ * @return The name of what the metric counts.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+string TrafficRanking::getMetricName(TrafficMetric metric) {
+    switch (metric) {
+        case TrafficMetric::Flights: return "flights";
+        case TrafficMetric::Destinations: return "destinations";
+        case TrafficMetric::Airlines: return "airlines";
+        case TrafficMetric::Distance: return "km";
+    }
+    return "";
+}
@@ -0,0 +1,48 @@
+
+#ifndef PROJETO2_TRAFFICRANKING_H
+#define PROJETO2_TRAFFICRANKING_H
+
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+enum class TrafficMetric {
+    Flights,        ///< flights in and out of the airport
+    Destinations,   ///< distinct airports reached by a nonstop flight out of the airport
+    Airlines,       ///< distinct airlines with flights out of the airport
+    Distance        ///< kilometres of the flights in and out of the airport
+};
+
+class TrafficRanking {
+public:
+    void build(const Graph &graph);
+    void addFlight(int source, int target, int airline, double distance);
+    void removeFlight(int source, int target, int airline, double distance);
+    double getScore(TrafficMetric metric, int airport) const;
+    std::vector<std::pair<int, double>> top(TrafficMetric metric, int k) const;
+
+    static std::string getMetricName(TrafficMetric metric);
+
+private:
+    struct Ranking {
+        std::vector<double> score;                  ///< score of each airport, by vertex id
+        std::set<std::pair<double, int>> order;     ///< (-score, vertex id) of every airport, highest score first
+
+        void update(int airport, double delta);
+    };
+
+    Ranking rankings[4];                                    ///< one ranking per metric, indexed by TrafficMetric
+    std::unordered_map<std::uint64_t, int> routeFlights;    ///< flights of each (source, target) pair
+    std::unordered_map<std::uint64_t, int> airlineFlights;  ///< flights of each (source, airline) pair
+
+    Ranking &get(TrafficMetric metric);
+    static std::uint64_t key(int first, int second);
+};
+
+
+#endif //PROJETO2_TRAFFICRANKING_H
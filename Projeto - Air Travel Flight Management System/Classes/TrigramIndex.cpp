@@ -0,0 +1,195 @@
+
+#include "TrigramIndex.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+/**
+ * @brief Constructor for the TrigramIndex class. The index starts empty.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+TrigramIndex::TrigramIndex() {}
+
+/**
+ * @brief Normalizes a text for fuzzy matching.
+ *
+ * @param text The text, in UTF-8.
+ *
+ * @return The text in lower case, with the accented Latin-1 letters replaced by their base letters (an a with a tilde
+ * becomes a plain a) and every other character that is not a letter or a digit replaced by a space.
+ *
+ * @complexity Time Complexity: O(n), where n is the length of the text.
+ */
+string TrigramIndex::normalize(const string &text) {
+    // base letters of U+00C0 to U+00DF (and, 0x20 apart, of their lower case forms U+00E0 to U+00FF)
+    static const char *const latin1[32] = {
+        "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+        "d", "n", "o", "o", "o", "o", "o", " ", "o", "u", "u", "u", "u", "y", "th", "ss"
+    };
+    string res;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = text[i];
+        if (c < 0x80) {
+            res += isalnum(c) ? (char) tolower(c) : ' ';
+        } else if (c == 0xC3 && i + 1 < text.size()) {
+            unsigned char next = text[++i];
+            res += next == 0xBF ? "y" : latin1[next & 0x1F];
+        } else {
+            while (i + 1 < text.size() && ((unsigned char) text[i + 1] & 0xC0) == 0x80)
+                i++;
+            res += ' ';
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Splits a text into its distinct trigrams.
+ *
+ * @param text The text.
+ *
+ * @return The sorted trigrams of the normalized text, each one packed into the low 24 bits of an integer.
+ *
+ * @info Every word is padded with two spaces before and one after, so short words and word starts get their own
+ * trigrams and a typo only changes the three trigrams that cover it.
+ *
+ * @complexity Time Complexity: O(n log n), where n is the length of the text.
+ */
+vector<uint32_t> TrigramIndex::trigrams(const string &text) {
+    vector<uint32_t> res;
+    string normalized = normalize(text);
+    size_t i = 0;
+    while (i < normalized.size()) {
+        while (i < normalized.size() && normalized[i] == ' ')
+            i++;
+        size_t end = i;
+        while (end < normalized.size() && normalized[end] != ' ')
+            end++;
+        if (end > i) {
+            string word = "  " + normalized.substr(i, end - i) + " ";
+            for (size_t j = 0; j + 3 <= word.size(); j++) {
+                res.push_back((uint32_t) (unsigned char) word[j] << 16 | (uint32_t) (unsigned char) word[j + 1] << 8 |
+                              (uint32_t) (unsigned char) word[j + 2]);
+            }
+        }
+        i = end;
+    }
+    sort(res.begin(), res.end());
+    res.erase(unique(res.begin(), res.end()), res.end());
+    return res;
+}
+
+/**
+ * @brief Adds a text to the index.
+ *
+ * @param text The text.
+ *
+ * @return The id of the text. Adding the same text again returns the id it already had.
+ *
+ * @complexity Time Complexity: O(n log n), where n is the length of the text.
+ */
+int TrigramIndex::add(const string &text) {
+    auto it = ids.find(text);
+    if (it != ids.end())
+        return it->second;
+    int id = (int) texts.size();
+    ids[text] = id;
+    texts.push_back(text);
+    vector<uint32_t> grams = trigrams(text);
+    trigramCounts.push_back((int) grams.size());
+    for (uint32_t gram : grams)
+        postings[gram].push_back(id);
+    return id;
+}
+
+/**
+ * @brief Finds a text that was added exactly as given.
+ *
+ * @param text The text.
+ *
+ * @return The id of the text, or -1 if it is not in the index.
+ *
+ * @complexity Time Complexity: O(n), where n is the length of the text.
+ */
+int TrigramIndex::find(const string &text) const {
+    auto it = ids.find(text);
+    return it == ids.end() ? -1 : it->second;
+}
+
+/**
+ * @brief Gets an indexed text.
+ *
+ * @param id The id of the text.
+ *
+ * @return The text, as it was added.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+const string &TrigramIndex::get(int id) const {
+    return texts[id];
+}
+
+/**
+ * @brief Gets the number of indexed texts.
+ *
+ * @return The number of texts.
+ *
+ * @complexity Time Complexity: O(1)
+ */
+int TrigramIndex::size() const {
+    return (int) texts.size();
+}
+
+/**
+ * @brief Finds the texts most similar to a query.
+ *
+ * @param query The query. Case, accents and punctuation are ignored.
+ * @param k The maximum number of results.
+ * @param threshold The minimum similarity (0 to 1) of a result.
+ *
+ * @return The similarity and the id of the best matches, most similar first (ties in alphabetical order).
+ *
+ * @info The similarity is the Jaccard index of the trigram sets: shared / (query + text - shared). Shared trigrams are
+ * counted by walking only the posting lists of the trigrams of the query.
+ *
+ * @complexity Time Complexity: O(P + C log k), where P is the total length of the posting lists of the query and C is
+ * the number of texts that share at least one trigram with it.
+ */
+vector<pair<double, int>> TrigramIndex::search(const string &query, int k, double threshold) const {
+    vector<pair<double, int>> res;
+    vector<uint32_t> grams = trigrams(query);
+    if (grams.empty() || k <= 0)
+        return res;
+
+    vector<int> shared(texts.size(), 0);
+    vector<int> touched;
+    for (uint32_t gram : grams) {
+        auto it = postings.find(gram);
+        if (it == postings.end())
+            continue;
+        for (int id : it->second) {
+            if (shared[id]++ == 0)
+                touched.push_back(id);
+        }
+    }
+
+    for (int id : touched) {
+        double similarity = (double) shared[id] / (grams.size() + trigramCounts[id] - shared[id]);
+        if (similarity >= threshold)
+            res.push_back({similarity, id});
+    }
+    auto better = [this](const pair<double, int> &a, const pair<double, int> &b) {
+        if (a.first != b.first)
+            return a.first > b.first;
+        return texts[a.second] < texts[b.second];
+    };
+    if (res.size() > (size_t) k) {
+        partial_sort(res.begin(), res.begin() + k, res.end(), better);
+        res.resize(k);
+    } else {
+        sort(res.begin(), res.end(), better);
+    }
+    return res;
+}
@@ -0,0 +1,34 @@
+
+#ifndef PROJETO2_TRIGRAMINDEX_H
+#define PROJETO2_TRIGRAMINDEX_H
+
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class TrigramIndex {
+public:
+    TrigramIndex();
+
+    int add(const std::string &text);
+    int find(const std::string &text) const;
+    const std::string &get(int id) const;
+    int size() const;
+    std::vector<std::pair<double, int>> search(const std::string &query, int k, double threshold = 0.3) const;
+
+    static std::string normalize(const std::string &text);
+
+private:
+    std::vector<std::string> texts;                                 ///< the indexed texts, by id
+    std::unordered_map<std::string, int> ids;                       ///< id of each indexed text
+    std::vector<int> trigramCounts;                                 ///< number of distinct trigrams of each text
+    std::unordered_map<std::uint32_t, std::vector<int>> postings;   ///< ids of the texts that contain each trigram
+
+    static std::vector<std::uint32_t> trigrams(const std::string &text);
+};
+
+
+#endif //PROJETO2_TRIGRAMINDEX_H
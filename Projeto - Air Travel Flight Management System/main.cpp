@@ -1,11 +1,86 @@
 
 
 #include "Menu.h"
+#include "CsvReader.h"
+#include "BatchQueries.h"
+#include "ScheduleStream.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 
 using namespace std;
 
-int main() {
-    cout << "Loading ..." << endl;
+/**
+ * @brief Reads an optional command-line argument as a whole number.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @param i The index of the argument.
+ * @param fallback The value used when the argument is missing.
+ * @param minimum The smallest value accepted.
+ * @param value Output: the value of the argument, or the fallback.
+ *
+ * @return False if the argument is present but is not a whole number of at least minimum.
+ *
+ * @complexity Time Complexity: O(n), where n is the length of the argument.
+ */
+static bool readNumber(int argc, char *argv[], int i, long fallback, long minimum, long &value) {
+    if (argc <= i) {
+        value = fallback;
+        return true;
+    }
+    char *end;
+    errno = 0;
+    value = strtol(argv[i], &end, 10);
+    return end != argv[i] && *end == '\0' && errno == 0 && value >= minimum;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--benchmark-csv") == 0) {
+        int repetitions = argc > 2 ? atoi(argv[2]) : 20;
+        CsvReader::benchmark({"../dataset/airlines.csv", "../dataset/airports.csv", "../dataset/flights.csv"}, repetitions, cout);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        // workers share the mapped snapshot; it is only rebuilt when the dataset changed
+        GraphSnapshot snapshot;
+        if (!snapshot.load("graph.snapshot", Data::computeFingerprint())) {
+            Data data;
+            if (!snapshot.load("graph.snapshot", data.getFingerprint()))
+                snapshot = data.createSnapshot();
+        }
+        BatchQueries queries(snapshot);
+        queries.run(cin, cout);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--ingest") == 0) {
+        // --ingest [FILE|-] [INTERVAL_MS] [BATCH] [QUEUE]: applies "add|remove,SOURCE,TARGET,AIRLINE" lines
+        long interval, maxBatch, capacity;
+        if (!readNumber(argc, argv, 3, 100, 0, interval) || !readNumber(argc, argv, 4, 1024, 1, maxBatch) ||
+            !readNumber(argc, argv, 5, 4096, 1, capacity)) {
+            cout << "Usage: " << argv[0] << " --ingest [FILE|-] [INTERVAL_MS] [BATCH] [QUEUE]" << endl;
+            cout << "INTERVAL_MS is a whole number of at least 0, BATCH and QUEUE of at least 1" << endl;
+            return 1;
+        }
+        auto start = chrono::steady_clock::now();
+        Data data;
+        auto loaded = chrono::steady_clock::now();
+        cout << "Loaded in " << chrono::duration_cast<chrono::milliseconds>(loaded - start).count() << " ms, "
+             << data.getRecoveredChanges() << " schedule changes replayed" << endl;
+        ifstream file;
+        if (argc > 2 && strcmp(argv[2], "-") != 0) {
+            file.open(argv[2]);
+            if (!file) {
+                cout << "Could not open " << argv[2] << endl;
+                return 1;
+            }
+        }
+        ScheduleStream stream(data, (size_t) capacity, chrono::milliseconds(interval), (size_t) maxBatch);
+        stream.run(file.is_open() ? file : cin, cout, 10);
+        return 0;
+    }
+
     Menu m = Menu();
     m.showMenu();
     cout << "\n";